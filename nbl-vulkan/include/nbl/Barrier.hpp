@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 #include "Image.hpp"
+#include "Util.hpp"
 
 namespace nbl
 {
+    class Buffer;
     class Image;
 
     struct ImageTransitionInfo
@@ -33,11 +36,73 @@ namespace nbl
         std::vector<ImageTransitionInfo> imageTransitionInfos;
     };
 
+    /**
+     * Buffer access to synchronize with, the source scope comes from the Buffer's tracked state.
+     */
+    struct BufferTransitionInfo
+    {
+        Buffer*                     pBuffer          = nullptr;
+        vk::AccessFlags2            dstAccessMask    = vk::AccessFlagBits2::eNone;
+        vk::PipelineStageFlags2     dstStageMask     = vk::PipelineStageFlagBits2::eNone;
+    };
+
+    struct BarrierStatistics
+    {
+        uint32_t                    requested = 0;  // Transitions asked for
+        uint32_t                    issued    = 0;  // Barriers recorded after merging and dropping no-ops
+        uint32_t                    batches   = 0;  // pipelineBarrier2 calls
+    };
+
     class Barrier
     {
     public:
         static void transitionImageLayout(const ImageLayoutTransitionInfo& transitionInfo);
 
         static void transitionImageLayouts(const ImageLayoutTransitionsInfo& transitionInfo);
+
+        static bool hasWriteAccess(vk::AccessFlags2 accessFlags);
+
+        static void recordStatistics(uint32_t requested, uint32_t issued, uint32_t batches);
+
+        /**
+         * @return Counters of the last completed frame.
+         */
+        static BarrierStatistics getFrameStatistics();
+
+        /**
+         * Close the counters of the current frame, called by VulkanRHI::beginFrame.
+         */
+        static void nextFrame();
+    };
+
+    /**
+     * Accumulates image and buffer barriers and records them with a single pipelineBarrier2.
+     * Source scopes come from the tracked Image / Buffer state. Repeated reads of the same resource are merged,
+     * a request involving a write flushes the pending barrier of the resource first so the two stay ordered.
+     * Read-after-read requests already visible to the destination stages are dropped.
+     * Flush before the first command that depends on the barriers, the destructor flushes what is left.
+     */
+    class BarrierBatch
+    {
+    public:
+        nbl_DISABLE_COPY(BarrierBatch);
+
+        explicit BarrierBatch(const vk::CommandBuffer& commandBuffer);
+
+        ~BarrierBatch();
+
+        BarrierBatch& transition(const ImageTransitionInfo& transitionInfo);
+
+        BarrierBatch& transition(const BufferTransitionInfo& transitionInfo);
+
+        void flush();
+
+        bool empty() const { return mImageBarriers.empty() && mBufferBarriers.empty(); }
+
+    private:
+        vk::CommandBuffer                     mCommandBuffer;
+        std::vector<vk::ImageMemoryBarrier2>  mImageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> mBufferBarriers;
+        uint32_t                              mRequested = 0;
     };
-}
\ No newline at end of file
+}
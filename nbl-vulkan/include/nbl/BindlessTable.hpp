@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include "Util.hpp"
+
+namespace nbl
+{
+    class Buffer;
+    class Device;
+    class Image;
+
+    enum class BindlessResourceType : uint32_t
+    {
+        StorageBuffer = 0,
+        SampledImage  = 1,      // Combined image sampler, uses the Image's sampler
+        StorageImage  = 2,
+    };
+
+    std::string toString(BindlessResourceType resourceType) noexcept;
+
+    static constexpr uint32_t gBindlessResourceTypeCount = 3;
+
+    /**
+     * Stable index of a resource in a BindlessTable, the binding equals the BindlessResourceType.
+     */
+    struct BindlessHandle
+    {
+        BindlessResourceType type  = BindlessResourceType::StorageBuffer;
+        uint32_t             index = static_cast<uint32_t>(gInvalidIndex);
+
+        bool isValid() const { return index != static_cast<uint32_t>(gInvalidIndex); }
+    };
+
+    struct BindlessTableCreateInfo
+    {
+        uint32_t        maxStorageBuffers = 16384;
+        uint32_t        maxSampledImages  = 16384;
+        uint32_t        maxStorageImages  = 4096;       // 0 without DeviceCapabilities::bindlessStorageImages
+        Device*         pDevice           = nullptr;
+        std::string     debugName         = "Bindless Table";
+    };
+
+    /**
+     * Global update-after-bind descriptor set of storage buffers, sampled images and storage images.
+     * Resources are registered once and addressed by index in shaders (see shader/glsl/inc/bindless.glsl).
+     * Pipelines that include getLayout() bind the set next to their own sets, it does not replace them.
+     * Capacities are clamped to the per-set and per-stage update-after-bind limits.
+     * Every handle must be released before the table is destroyed.
+     */
+    class BindlessTable
+    {
+    public:
+        nbl_DISABLE_COPY(BindlessTable);
+        nbl_CI_CTOR(BindlessTable, BindlessTableCreateInfo);
+
+        ~BindlessTable();
+
+        BindlessHandle registerStorageBuffer(const Buffer* pBuffer);
+
+        BindlessHandle registerSampledImage(const Image* pImage);
+
+        BindlessHandle registerStorageImage(const Image* pImage);
+
+        /**
+         * Release an index through the DeletionQueue, it becomes reusable once the submission being recorded has completed.
+         */
+        void release(const BindlessHandle& handle);
+
+        const vk::DescriptorSet&       getSet()    const { return mDescriptorSet; }
+        const vk::DescriptorSetLayout& getLayout() const { return mLayout;        }
+
+        uint32_t getUsedCount(BindlessResourceType type) const;
+
+    private:
+        struct Slots
+        {
+            uint32_t              capacity = 0;
+            uint32_t              next     = 0;        // Next never used index
+            std::vector<uint32_t> freeList;
+        };
+
+        /**
+         * Requires mMutex, it is held until the descriptor was written.
+         */
+        uint32_t acquire(BindlessResourceType type);
+
+        /**
+         * Requires mMutex, vkUpdateDescriptorSets needs external synchronization of the set.
+         */
+        void writeDescriptor(BindlessResourceType type, uint32_t index, const vk::DescriptorBufferInfo* pBufferInfo, const vk::DescriptorImageInfo* pImageInfo) const;
+
+        vk::DescriptorPool                          mDescriptorPool;
+        vk::DescriptorSetLayout                     mLayout;
+        vk::DescriptorSet                           mDescriptorSet;
+
+        std::array<Slots, gBindlessResourceTypeCount> mSlots;
+        mutable std::mutex                          mMutex;
+
+        const std::string                           mDebugName;
+
+        Device*                                     mDevice;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.hpp>
@@ -22,16 +24,30 @@ namespace nbl
         AccelerationStructure,
         ShaderBindingTable,
         Staging,
+        Descriptor,     // VK_EXT_descriptor_buffer storage, host-visible
+        Readback,       // Transfer destination read by the host, host-cached and always mapped
     };
 
     std::string toString(BufferType bufferType) noexcept;
 
+    /**
+     * How data reached a device buffer, see VulkanRHI::uploadBuffers.
+     */
+    enum class UploadPath
+    {
+        Direct,     // Written through a persistent mapping (ReBAR / UMA / host memory)
+        Staging,    // Staging buffer + transfer submission
+    };
+
+    std::string toString(UploadPath uploadPath) noexcept;
+
     struct BufferCreateInfo
     {
-        uint64_t        size      = 0;
-        BufferType      type      = BufferType::Storage;
-        Device*         pDevice   = nullptr;
-        std::string     debugName = "Unknown Buffer";
+        uint64_t        size       = 0;
+        BufferType      type       = BufferType::Storage;
+        Device*         pDevice    = nullptr;
+        std::string     debugName  = "Unknown Buffer";
+        bool            hostAccess = false;     // Request a persistent mapping, only granted when it does not cost device-local placement
     };
 
     struct BufferCopyInfo
@@ -43,12 +59,27 @@ namespace nbl
         vk::CommandBuffer commandBuffer = nullptr;
     };
 
+    struct BufferUploadInfo
+    {
+        Buffer*           pDstBuffer    = nullptr;
+        const void*       pData         = nullptr;
+        uint64_t          size          = 0;
+        uint64_t          dstOffset     = 0;
+    };
+
     struct BufferImageCopyInfo
     {
         Image*            pDstImage     = nullptr;
         vk::CommandBuffer commandBuffer = nullptr;
     };
 
+    // Last device access of a Buffer, used to derive barriers (see BarrierBatch)
+    struct BufferState
+    {
+        vk::AccessFlags2        accessFlags = vk::AccessFlagBits2::eNone;
+        vk::PipelineStageFlags2 stageFlags  = vk::PipelineStageFlagBits2::eNone;
+    };
+
     class Buffer
     {
     public:
@@ -65,22 +96,44 @@ namespace nbl
 
         void imageCopy(const BufferImageCopyInfo& imageCopyInfo) const;
 
+        /**
+         * @return Persistently mapped memory of the buffer, empty if the buffer is not host-visible.
+         */
+        std::span<std::byte> map() const;
+
+        /**
+         * Make host writes through map() visible to the device, no-op for coherent memory.
+         */
+        void flush(uint64_t offset = 0, uint64_t size = VK_WHOLE_SIZE) const;
+
+        void updateState(const BufferState& state)
+        {
+            mState = state;
+        }
+
+        bool isMapped()      const { return mAllocationInfo.pMappedData != nullptr; }
+        bool isDeviceLocal() const { return static_cast<bool>(mMemoryFlags & vk::MemoryPropertyFlagBits::eDeviceLocal); }
+
         const vk::Buffer& getHandle()    const { return mBuffer;              }
         uint64_t          getSize()      const { return mCreateSize;          }
         BufferType        getType()      const { return mBufferType;          }
         uint64_t          getAllocSize() const { return mAllocationInfo.size; }
         uint64_t          getAddress()   const { return mDeviceAddress;       }
+        const std::string& getName()     const { return mName;                }
+        BufferState       getState()     const { return mState;               }
 
     private:
         static vk::BufferUsageFlags getUsageFlags(BufferType bufferType);
 
-        static int32_t getMemoryFlags(BufferType bufferType);
+        static int32_t getMemoryFlags(BufferType bufferType, bool hostAccess);
 
         vk::Buffer          mBuffer;
 
         VmaAllocation       mAllocation;
         VmaAllocationInfo   mAllocationInfo;
         vk::DeviceAddress   mDeviceAddress;
+        vk::MemoryPropertyFlags mMemoryFlags {};
+        BufferState         mState;
 
         uint64_t            mCreateSize {0};
         BufferType          mBufferType;
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.hpp>
+#include "Buffer.hpp"
+#include "Util.hpp"
+
+namespace nbl
+{
+    class BufferArena;
+    class Device;
+
+    struct BufferArenaCreateInfo
+    {
+        uint64_t        blockSize  = 64 * 1024 * 1024;  // Size of each backing Buffer, larger requests get a dedicated block
+        BufferType      type       = BufferType::Storage;
+        Device*         pDevice    = nullptr;
+        std::string     debugName  = "Buffer Arena";
+        bool            hostAccess = false;             // Forwarded to the BufferCreateInfo of every block
+    };
+
+    struct BufferSliceCreateInfo
+    {
+        uint64_t        size      = 0;
+        uint64_t        alignment = 0;                  // 0: Device minimum storage / uniform buffer offset alignment
+        std::string     debugName = "Unknown Buffer Slice";
+    };
+
+    struct BufferArenaStatistics
+    {
+        uint32_t        blockCount       = 0;
+        uint32_t        allocationCount  = 0;
+        uint64_t        allocatedBytes   = 0;
+        uint64_t        totalBytes       = 0;
+        uint64_t        largestFreeRange = 0;
+
+        /**
+         * @return 0 when all free space is contiguous, approaches 1 as it is split into small ranges.
+         */
+        float getFragmentation() const
+        {
+            const uint64_t freeBytes = totalBytes - allocatedBytes;
+            return freeBytes == 0 ? 0.0f : 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+        }
+    };
+
+    /**
+     * Range of a BufferArena block, mirrors the Buffer interface with offsets applied.
+     * Returns its range to the arena through the DeletionQueue once in-flight frames stopped using it.
+     */
+    class BufferSlice
+    {
+    public:
+        nbl_DISABLE_COPY(BufferSlice);
+
+        BufferSlice(BufferArena* pArena, Buffer* pBuffer, uint32_t blockIndex, VmaVirtualAllocation allocation, uint64_t offset, uint64_t size, std::string name);
+
+        ~BufferSlice();
+
+        void setData(const void* pData, uint64_t size, uint64_t offset = 0) const;
+
+        void readBack(void* pData, uint64_t size, uint64_t offset = 0) const;
+
+        /**
+         * Record a copy from a Buffer (e.g. staging) into this slice.
+         */
+        void copyFrom(const Buffer* pSrcBuffer, const vk::CommandBuffer& commandBuffer, uint64_t size, uint64_t srcOffset = 0, uint64_t dstOffset = 0) const;
+
+        vk::DescriptorBufferInfo getDescriptorInfo() const { return { mBuffer->getHandle(), mOffset, mSize }; }
+
+        /**
+         * Backing block, shared with other slices: barriers and render graph imports on it cover the whole block.
+         */
+        Buffer*           getBuffer()    const { return mBuffer;                        }
+
+        const vk::Buffer& getHandle()    const { return mBuffer->getHandle();           }
+        uint64_t          getSize()      const { return mSize;                          }
+        BufferType        getType()      const { return mBuffer->getType();             }
+        uint64_t          getAllocSize() const { return mSize;                          }
+        uint64_t          getAddress()   const { return mBuffer->getAddress() + mOffset; }
+        uint64_t          getOffset()    const { return mOffset;                        }
+        const std::string& getName()     const { return mName;                          }
+
+    private:
+        BufferArena*            mArena;
+        Buffer*                 mBuffer;
+        uint32_t                mBlockIndex;
+        VmaVirtualAllocation    mAllocation;
+        uint64_t                mOffset;
+        uint64_t                mSize;
+        std::string             mName;
+    };
+
+    /**
+     * Sub-allocates BufferSlices from a few large Buffers using VMA virtual blocks,
+     * avoiding a vk::Buffer, memory allocation and address query per small resource.
+     * Requests larger than blockSize get a dedicated block that is released with its slice.
+     */
+    class BufferArena
+    {
+    public:
+        nbl_DISABLE_COPY(BufferArena);
+        nbl_CI_CTOR(BufferArena, BufferArenaCreateInfo);
+
+        ~BufferArena();
+
+        std::unique_ptr<BufferSlice> allocate(const BufferSliceCreateInfo& createInfo);
+
+        BufferArenaStatistics getStatistics() const;
+
+        BufferType getType() const { return mType; }
+
+    private:
+        friend class BufferSlice;
+
+        struct Block
+        {
+            std::unique_ptr<Buffer> buffer;
+            VmaVirtualBlock         virtualBlock {};    // nullptr: released dedicated block, the slot is reused
+            bool                    dedicated    = false;
+        };
+
+        /**
+         * Blocks are shared with deferred frees, so slices released right before the arena can still return their range.
+         */
+        struct Blocks
+        {
+            nbl_DISABLE_COPY(Blocks);
+
+            Blocks() = default;
+
+            ~Blocks();
+
+            std::vector<Block>      blocks;
+            std::mutex              mutex;              // VMA virtual blocks are not internally synchronized
+        };
+
+        /**
+         * Defer the free of a slice range until the submission currently being recorded has completed.
+         */
+        void release(uint32_t blockIndex, VmaVirtualAllocation allocation) const;
+
+        static void free(Blocks& blocks, uint32_t blockIndex, VmaVirtualAllocation allocation);
+
+        /**
+         * Requires the blocks mutex to be held.
+         */
+        uint32_t createBlock(uint64_t size, bool dedicated);
+
+        std::shared_ptr<Blocks>     mBlocks;
+
+        uint64_t                    mBlockSize;
+        uint64_t                    mMinAlignment {16};
+        BufferType                  mType;
+        std::string                 mName;
+        bool                        mHostAccess;
+
+        Device*                     mDevice;
+    };
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include "Util.hpp"
+
+namespace nbl
+{
+    class  Device;
+    struct Queue;
+
+    struct CommandAllocatorCreateInfo
+    {
+        uint32_t        frameCount  = 2;
+        uint32_t        threadCount = std::max(1u, std::thread::hardware_concurrency());
+        Device*         pDevice     = nullptr;
+        Queue*          pQueue      = nullptr;
+        std::string     debugName   = "Command Allocator";
+    };
+
+    /**
+     * Transient command buffers from one command pool per frame and recording thread.
+     * Pools are reset as a whole in beginFrame, command buffers are reused instead of freed.
+     * A thread index must only be used by one thread at a time, index 0 is the thread submitting the frame.
+     */
+    class CommandAllocator
+    {
+    public:
+        nbl_DISABLE_COPY(CommandAllocator);
+        nbl_CI_CTOR(CommandAllocator, CommandAllocatorCreateInfo);
+
+        ~CommandAllocator();
+
+        /**
+         * Reset every pool of the frame, its previous submission must have completed.
+         */
+        void beginFrame(uint32_t frameIndex);
+
+        /**
+         * @return Command buffer in the initial state from the pool of the current frame and the given thread.
+         */
+        vk::CommandBuffer allocate(uint32_t threadIndex, vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
+
+        uint32_t getThreadCount() const { return mThreadCount; }
+
+    private:
+        struct Pool
+        {
+            vk::CommandPool                 pool;
+            std::vector<vk::CommandBuffer>  commandBuffers[2];      // [Primary, Secondary]
+            uint32_t                        used[2] = { 0, 0 };
+        };
+
+        Pool& getPool(uint32_t frameIndex, uint32_t threadIndex) { return mPools[frameIndex * mThreadCount + threadIndex]; }
+
+        std::vector<Pool>   mPools;     // [Frame][Thread]
+        uint32_t            mCurrentFrame {0};
+
+        const uint32_t      mFrameCount;
+        const uint32_t      mThreadCount;
+        Device*             mDevice;
+        const std::string   mDebugName;
+    };
+}
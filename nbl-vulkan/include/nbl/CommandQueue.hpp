@@ -2,11 +2,14 @@
 
 #include <cstdint>
 #include <functional>
+#include <mutex>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 #include "Util.hpp"
 
 namespace nbl
 {
+    class  CommandQueue;
     class  Device;
     struct Queue;
 
@@ -23,6 +26,12 @@ namespace nbl
 
         void begin();
 
+        /**
+         * Begin as a secondary command buffer. With renderingInfo the commands continue the
+         * dynamic rendering instance of the primary (see RenderPass::getInheritanceInfo), otherwise they stand alone.
+         */
+        void beginSecondary(const vk::CommandBufferInheritanceRenderingInfo* pRenderingInfo = nullptr);
+
         void end();
 
         const vk::CommandBuffer& handle() const { return mCommandBuffer; }
@@ -47,6 +56,28 @@ namespace nbl
         Queue*          pQueue                     = nullptr;
     };
 
+    /**
+     * Wait for a value of a CommandQueue's timeline, e.g. graphics work consuming async compute results.
+     */
+    struct QueueWaitInfo
+    {
+        const CommandQueue*                     pQueue           = nullptr;
+        uint64_t                                value            = 0;
+        vk::PipelineStageFlags2                 stageMask        = vk::PipelineStageFlagBits2::eAllCommands;
+    };
+
+    struct QueueSubmitInfo
+    {
+        std::vector<vk::CommandBuffer>          commandBuffers;
+        std::vector<QueueWaitInfo>              queueWaits;
+        std::vector<vk::SemaphoreSubmitInfo>    binaryWaits;        // Swapchain image acquisition
+        std::vector<vk::SemaphoreSubmitInfo>    binarySignals;      // Presentation
+    };
+
+    /**
+     * Each CommandQueue owns one timeline semaphore, every submission signals the next value.
+     * CPU waits and cross-queue dependencies are expressed as timeline values.
+     */
     class CommandQueue
     {
     public:
@@ -59,6 +90,23 @@ namespace nbl
 
         void executeSingleTimeCommand(const std::function<void(const vk::CommandBuffer&)>& lambda) const;
 
+        /**
+         * Submit command buffers, signalling the next timeline value.
+         * @return Timeline value reached once the submission completed.
+         */
+        uint64_t submit(const QueueSubmitInfo& submitInfo) const;
+
+        /**
+         * Block until the timeline reached the given value.
+         */
+        void wait(uint64_t value) const;
+
+        uint64_t getCompletedValue() const;
+
+        uint64_t getSubmittedValue() const;
+
+        vk::Semaphore getTimeline() const { return mTimeline; }
+
         const Queue& getQueue() const { return *mQueue; }
 
     private:
@@ -67,6 +115,10 @@ namespace nbl
         Queue*                           mQueue;
         Device*                          mDevice;
 
+        vk::Semaphore                    mTimeline;
+        mutable uint64_t                 mSubmittedValue {0};
+        mutable std::mutex               mSubmitMutex;      // Signal values must increase in submission order
+
         const vk::CommandBufferBeginInfo mSingleTimeBeginInfo  = vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
         bool                             mSingleTimeSubmission = true;
 
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "Util.hpp"
+
+namespace nbl
+{
+    /**
+     * Deferred destruction of GPU objects that may still be referenced by submitted work.
+     * Deleters are tagged with the value of the submission being recorded and run once
+     * a later collect() reports that value as completed, without waiting for the device.
+     * Submission values increase monotonically, value N completes after every value below it.
+     */
+    class DeletionQueue
+    {
+    public:
+        nbl_DISABLE_COPY(DeletionQueue);
+
+        DeletionQueue() = default;
+
+        ~DeletionQueue();
+
+        /**
+         * Defer a deleter until the submission currently being recorded has completed.
+         */
+        void push(std::function<void()> deleter);
+
+        /**
+         * Close the submission currently being recorded, later deleters wait for the next one.
+         * @return Value of the closed submission.
+         */
+        uint64_t nextSubmission();
+
+        /**
+         * Run every deleter whose submission value is less than or equal to completedValue.
+         */
+        void collect(uint64_t completedValue);
+
+        /**
+         * Run every deleter, the device must be idle.
+         */
+        void flush();
+
+        size_t getPendingCount() const;
+
+    private:
+        struct Entry
+        {
+            uint64_t                submission;
+            std::function<void()>   deleter;
+        };
+
+        std::deque<Entry>   mEntries;               // Ordered by submission
+        uint64_t            mCurrentSubmission {1};
+        mutable std::mutex  mMutex;
+    };
+}
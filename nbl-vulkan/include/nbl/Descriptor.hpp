@@ -1,6 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
@@ -8,8 +16,22 @@
 
 namespace nbl
 {
+    class Buffer;
     class Device;
 
+    /**
+     * Pool:   Descriptor pool + vk::DescriptorSets, updated with updateDescriptorSets.
+     * Buffer: VK_EXT_descriptor_buffer, descriptors are written to mapped memory with getDescriptorEXT
+     *         and bound by offset. Pipelines using it need PipelineCreateInfo::useDescriptorBuffers.
+     */
+    enum class DescriptorBackend
+    {
+        Pool,
+        Buffer,
+    };
+
+    std::string toString(DescriptorBackend backend) noexcept;
+
     enum class DescriptorType
     {
         CombinedImageSampler,
@@ -23,9 +45,10 @@ namespace nbl
     {
         uint32_t                              setIndex {0};
         std::vector<vk::WriteDescriptorSet>   writes;
-        std::vector<vk::DescriptorBufferInfo> bufferInfos;
-        std::vector<vk::DescriptorImageInfo>  imageInfos;
-        std::vector<vk::WriteDescriptorSetAccelerationStructureKHR> accelerationStructureInfos;
+        // Deques keep the addresses referenced by writes stable while more infos are added.
+        std::deque<vk::DescriptorBufferInfo>  bufferInfos;
+        std::deque<vk::DescriptorImageInfo>   imageInfos;
+        std::deque<vk::WriteDescriptorSetAccelerationStructureKHR> accelerationStructureInfos;
 
         DescriptorWriteInfo& setSetIndex(const uint32_t index)
         {
@@ -41,7 +64,7 @@ namespace nbl
                 .setDescriptorCount(count)
                 .setDescriptorType(vk::DescriptorType::eAccelerationStructureKHR)
                 .setDstArrayElement(0)
-                .setPNext(&accelerationStructure);
+                .setPNext(&accelerationStructureInfos.back());
             writes.push_back(write);
             return *this;
         }
@@ -102,6 +125,8 @@ namespace nbl
         uint32_t                                    setCount         = 1;
         std::optional<DescriptorWriteInfo>          initialWriteInfo = std::nullopt;
         std::string                                 debugName        = "Unknown Descriptor";
+        DescriptorBackend                           backend          = DescriptorBackend::Pool;    // Falls back to Pool when unsupported
+        bool                                        pushDescriptor   = false;   // No sets, bound with Descriptor::push (Pool backend only)
         Device*                                     pDevice          = nullptr;
     };
 
@@ -115,21 +140,88 @@ namespace nbl
 
         void write(DescriptorWriteInfo writeInfo) const;
 
+        /**
+         * Update set i from a POD struct laid out like the packed update template:
+         * bindings in declaration order, each descriptor a vk::DescriptorBufferInfo, vk::DescriptorImageInfo
+         * or vk::AccelerationStructureKHR (see getTemplateOffset).
+         */
+        template <class T>
+        void update(const size_t i, const T& data) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Descriptor template data must be trivially copyable");
+            updateWithTemplate(i, &data, sizeof(T));
+        }
+
+        /**
+         * Record push descriptors (VK_KHR_push_descriptor, core in Vulkan 1.4) from packed template data.
+         */
+        template <class T>
+        void push(const vk::CommandBuffer& commandBuffer, const vk::PipelineBindPoint bindPoint, const vk::PipelineLayout& pipelineLayout, const T& data, const uint32_t set = 0) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Descriptor template data must be trivially copyable");
+            pushWithTemplate(commandBuffer, bindPoint, pipelineLayout, &data, sizeof(T), set);
+        }
+
+        void pushWithTemplate(const vk::CommandBuffer& commandBuffer, vk::PipelineBindPoint bindPoint, const vk::PipelineLayout& pipelineLayout, const void* pData, size_t size, uint32_t set = 0) const;
+
+        size_t getTemplateOffset(uint32_t binding) const { return mTemplateOffsets.at(binding); }
+        size_t getTemplateSize()                   const { return mTemplateSize;                }
+
+        /**
+         * Bind set i at firstSet, works for both backends.
+         * @param bufferIndex Buffer backend: position of this Descriptor in the bindDescriptorBuffers call of the command buffer.
+         */
+        void bind(const vk::CommandBuffer& commandBuffer, vk::PipelineBindPoint bindPoint, const vk::PipelineLayout& pipelineLayout, size_t i, uint32_t firstSet = 0, uint32_t bufferIndex = 0) const;
+
+        /**
+         * Bind the descriptor buffers of every Descriptor a command buffer uses, once before any Buffer backend bind.
+         * Rebinding descriptor buffers invalidates the offsets set against the previous ones and may stall.
+         * No-op if every Descriptor uses the Pool backend, the two can not be mixed.
+         */
+        static void bindDescriptorBuffers(const vk::CommandBuffer& commandBuffer, std::span<const Descriptor* const> descriptors);
+
+        /**
+         * @throws RHIError with the Buffer backend, which has no vk::DescriptorSets.
+         */
         const vk::DescriptorSet&        getSet(size_t i)     const;
         const vk::DescriptorSet&        operator[](size_t i) const;
         const vk::DescriptorSetLayout&  getLayout()          const { return mLayout;   }
         uint32_t                        getSetCount()        const { return mSetCount; }
+        DescriptorBackend               getBackend()         const { return mBackend;  }
 
     private:
         void createPool();
         void createLayout();
         void createSets();
 
+        void createDescriptorBuffer();
+        void writeDescriptorBuffer(const DescriptorWriteInfo& writeInfo) const;
+
+        void createUpdateTemplate();
+        void updateWithTemplate(size_t i, const void* pData, size_t size) const;
+        void validateTemplateData(size_t size) const;
+
         std::vector<vk::DescriptorSet>              mDescriptorSets;
         std::vector<vk::DescriptorSetLayoutBinding> mBindings;
         vk::DescriptorSetLayout                     mLayout;
         vk::DescriptorPool                          mDescriptorPool;
 
+        // DescriptorBackend::Buffer
+        std::unique_ptr<Buffer>                     mDescriptorBuffer;
+        vk::DeviceSize                              mSetStride {0};
+        std::vector<vk::DeviceSize>                 mBindingOffsets;    // [Binding Index] -> Offset in set
+        vk::PhysicalDeviceDescriptorBufferPropertiesEXT mDescriptorBufferProperties;
+
+        // Packed update template, shared by set updates and push descriptors
+        std::vector<vk::DescriptorUpdateTemplateEntry> mTemplateEntries;
+        std::unordered_map<uint32_t, size_t>        mTemplateOffsets;   // [Binding] -> Offset in template data
+        size_t                                      mTemplateSize {0};
+        vk::DescriptorUpdateTemplate                mUpdateTemplate;
+        mutable std::unordered_map<VkPipelineLayout, vk::DescriptorUpdateTemplate> mPushTemplates;
+        mutable std::mutex                          mPushTemplateMutex;
+
+        DescriptorBackend                           mBackend;
+        const bool                                  mPushDescriptor;
         const uint32_t                              mSetCount;
         const std::string                           mDebugName;
 
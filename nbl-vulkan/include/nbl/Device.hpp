@@ -1,8 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.hpp>
 #include "Common.hpp"
+#include "DeletionQueue.hpp"
+#include "MemoryTracker.hpp"
 #include "Util.hpp"
 
 namespace nbl
@@ -14,6 +17,38 @@ namespace nbl
         vk::Instance instance;
     };
 
+    /**
+     * Feature level of the selected PhysicalDevice, each tier includes the ones below it.
+     * Baseline:    Vulkan 1.4 core, Dynamic Rendering, Synchronization 2
+     * MeshShading: + VK_EXT_mesh_shader
+     * RayTracing:  + VK_KHR_acceleration_structure, VK_KHR_ray_tracing_pipeline, VK_KHR_ray_query
+     */
+    enum class DeviceTier : uint32_t
+    {
+        Baseline    = 0,
+        MeshShading = 1,
+        RayTracing  = 2,
+    };
+
+    std::string toString(DeviceTier deviceTier) noexcept;
+
+    struct DeviceCapabilities
+    {
+        bool meshShader            = false;     // VK_EXT_mesh_shader with the meshShader and taskShader features
+        bool meshShaderQueries     = false;     // meshShaderQueries feature, does not affect the tier
+        bool accelerationStructure = false;
+        bool rayTracingPipeline    = false;
+        bool rayQuery              = false;
+        bool memoryBudget          = false;     // VK_EXT_memory_budget, does not affect the tier
+        bool descriptorBuffer      = false;     // VK_EXT_descriptor_buffer with the descriptorBuffer feature, does not affect the tier
+        bool presentWait           = false;     // VK_KHR_present_id + VK_KHR_present_wait, does not affect the tier
+        bool pipelineStatistics    = false;     // pipelineStatisticsQuery core feature, does not affect the tier
+        bool bindlessStorageImages = false;     // Non-uniform indexing and update-after-bind of storage image arrays, does not affect the tier
+
+        bool       hasRayTracing() const noexcept { return accelerationStructure and rayTracingPipeline and rayQuery; }
+        DeviceTier getTier()       const noexcept;
+    };
+
     template <class T>
     struct VulkanNameObjectInfo
     {
@@ -33,10 +68,28 @@ namespace nbl
 
         vk::Device          getHandle()            const { return mDevice;                  }
         const VmaAllocator& getAllocator()         const { return mAllocator;               }
+        MemoryTracker*      getMemoryTracker()     const { return mMemoryTracker.get();     }
+        DeletionQueue*      getDeletionQueue()     const { return mDeletionQueue.get();     }
         vk::PhysicalDevice  getPhysicalDevice()    const { return mPhysicalDevice;          }
+        const std::string&  getName()              const { return mDeviceName;              }
+
+        const vk::PhysicalDeviceProperties& getProperties() const { return mPhysicalDeviceProperties; }
+
+        const DeviceCapabilities& getCapabilities() const { return mCapabilities;           }
+
+        /**
+         * @return Whether the given device extension was enabled on device creation.
+         */
+        bool isExtensionEnabled(const char* extensionName) const;
 
         Queue*              getGraphicsQueue()     const { return mGraphicsQueue.get();     }
-        Queue*              getAsyncComputeQueue() const { return mAsyncComputeQueue.get(); }
+
+        /**
+         * The graphics Queue if the device has no separate compute family.
+         */
+        Queue*              getAsyncComputeQueue() const { return mAsyncComputeQueue ? mAsyncComputeQueue.get() : mGraphicsQueue.get(); }
+
+        bool                hasAsyncComputeQueue() const { return mAsyncComputeQueue != nullptr; }
 
         /**
          * Set the debug name for a Vulkan object.
@@ -50,6 +103,11 @@ namespace nbl
         void createDevice();
         void createAllocator();
 
+        /**
+         * Capabilities from the supported extensions and the features they depend on.
+         */
+        static DeviceCapabilities queryCapabilities(const vk::PhysicalDevice& physicalDevice, const std::vector<std::unique_ptr<VulkanDeviceExtension>>& extensions);
+
         std::unique_ptr<Queue> createQueue(const QueueCreateInfo& createInfo) const;
 
         vk::Instance                                        mInstance;
@@ -61,11 +119,14 @@ namespace nbl
         vk::Device                                          mDevice;
         std::vector<std::unique_ptr<VulkanDeviceExtension>> mDeviceExtensions;
         std::vector<const char*>                            mDeviceExtensionNames;
+        DeviceCapabilities                                  mCapabilities;
 
         std::unique_ptr<Queue>                              mGraphicsQueue;
         std::unique_ptr<Queue>                              mAsyncComputeQueue;
 
         VmaAllocator                                        mAllocator {};
+        std::unique_ptr<MemoryTracker>                      mMemoryTracker;
+        std::unique_ptr<DeletionQueue>                      mDeletionQueue;
     };
 
     template<class T>
@@ -13,11 +13,21 @@ namespace nbl
         const uint32_t acquiredImageIndex;
 
         std::vector<vk::CommandBuffer> commandBuffers;
+        std::vector<QueueWaitInfo>     queueWaits;
 
         Frame& addCommandLists(const std::initializer_list<vk::CommandBuffer> commandLists)
         {
             commandBuffers.append_range(commandLists);
             return *this;
         }
+
+        /**
+         * Make the frame's submission wait for work on another queue, e.g. async compute.
+         */
+        Frame& addQueueWait(const QueueWaitInfo& queueWait)
+        {
+            queueWaits.push_back(queueWait);
+            return *this;
+        }
     };
 }
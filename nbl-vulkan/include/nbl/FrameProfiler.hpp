@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include "Util.hpp"
+
+namespace nbl
+{
+    class Device;
+
+    /**
+     * CPU timestamps taken during a frame, in order.
+     */
+    enum class FramePhase : uint32_t
+    {
+        InputPoll,      // App, before beginFrame
+        WaitBegin,      // beginFrame, timeline wait for frame N - framesInFlight
+        WaitEnd,
+        AcquireBegin,
+        AcquireEnd,
+        SubmitBegin,    // submitFrame, recording ends here
+        SubmitEnd,
+        PresentBegin,
+        PresentEnd,
+        Count,
+    };
+
+    /**
+     * What limited a frame:
+     * GpuBound:     beginFrame blocked on the timeline, the GPU is behind the CPU.
+     * PresentBound: acquire or present blocked, the presentation engine throttles the loop (e.g. FIFO).
+     * CpuBound:     neither, the frame time is spent on the CPU.
+     */
+    enum class FrameBound
+    {
+        CpuBound,
+        GpuBound,
+        PresentBound,
+    };
+
+    std::string toString(FrameBound frameBound) noexcept;
+
+    struct FrameProfilerCreateInfo
+    {
+        uint32_t        frameCount       = 2;       // Frames in flight, one timestamp query pair each
+        uint32_t        historySize      = 4096;    // Records kept for writeCsv
+        uint32_t        percentileWindow = 240;     // Records used for getSummary
+        Device*         pDevice          = nullptr;
+    };
+
+    /**
+     * Timings of one frame in milliseconds.
+     */
+    struct FrameRecord
+    {
+        uint64_t        frameNumber   = 0;
+        double          frameMs       = 0.0;    // Period since the previous frame's WaitBegin
+        double          waitMs        = 0.0;
+        double          acquireMs     = 0.0;
+        double          recordMs      = 0.0;    // AcquireEnd -> SubmitBegin
+        double          submitMs      = 0.0;
+        double          presentMs     = 0.0;    // vkQueuePresentKHR call
+        double          gpuMs         = -1.0;   // Timestamps around the frame's command buffers, -1 if unsupported
+        double          latencyMs     = 0.0;    // InputPoll -> image on screen (present wait) or returned from present
+        bool            presentWait   = false;  // latencyMs measured with VK_KHR_present_wait
+        FrameBound      bound         = FrameBound::CpuBound;
+    };
+
+    struct FramePacingSummary
+    {
+        uint32_t        frameCount    = 0;
+        double          p50Ms         = 0.0;
+        double          p95Ms         = 0.0;
+        double          p99Ms         = 0.0;
+        double          maxMs         = 0.0;
+        double          gpuP50Ms      = 0.0;
+        double          latencyP50Ms  = 0.0;
+        uint32_t        cpuBound      = 0;
+        uint32_t        gpuBound      = 0;
+        uint32_t        presentBound  = 0;
+    };
+
+    /**
+     * Frame lifecycle instrumentation driven by VulkanRHI.
+     * CPU phases are marked as they happen, GPU time comes from timestamp queries written around the frame's submission
+     * and is resolved once the frame slot is reused. With VK_KHR_present_id / VK_KHR_present_wait a worker thread
+     * waits for every present to complete, giving input-to-photon latency, otherwise latency ends at the present call.
+     */
+    class FrameProfiler
+    {
+    public:
+        nbl_DISABLE_COPY(FrameProfiler);
+        nbl_CI_CTOR(FrameProfiler, FrameProfilerCreateInfo);
+
+        ~FrameProfiler();
+
+        void mark(FramePhase phase);
+
+        void writeBeginTimestamp(const vk::CommandBuffer& commandBuffer, uint32_t frameIndex) const;
+
+        void writeEndTimestamp(const vk::CommandBuffer& commandBuffer, uint32_t frameIndex) const;
+
+        /**
+         * @return Present id for the frame being recorded, 0 if present wait is unavailable.
+         */
+        uint64_t getPresentId() const;
+
+        /**
+         * Close the CPU side of the frame after its present.
+         */
+        void endFrame(uint32_t frameIndex, vk::SwapchainKHR swapchain);
+
+        /**
+         * Read the timestamps of the frame slot, its previous submission must have completed.
+         */
+        void resolve(uint32_t frameIndex);
+
+        /**
+         * Move every pending frame to the history, all submitted frames must have completed.
+         * Present waits that are still outstanding are given up on.
+         */
+        void drain();
+
+        /**
+         * Drop pending present waits, called before the Swapchain is recreated.
+         */
+        void retireSwapchain();
+
+        /**
+         * Summary of the last percentileWindow frames.
+         */
+        FramePacingSummary getSummary() const;
+
+        static FramePacingSummary summarize(std::span<const FrameRecord> records);
+
+        const std::deque<FrameRecord>& getHistory() const { return mHistory; }
+
+        /**
+         * @return Number of the next frame passed to endFrame, see FrameRecord::frameNumber.
+         */
+        uint64_t getFrameNumber() const { return mFrameNumber; }
+
+        bool hasGpuTimestamps() const { return mQueryPool != nullptr; }
+
+        bool hasPresentWait() const { return mPresentWait; }
+
+        void writeCsv(const std::string& filePath) const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct PendingFrame
+        {
+            FrameRecord             record;
+            uint32_t                frameIndex  = 0;
+            uint64_t                presentId   = 0;
+            Clock::time_point       inputPoll;
+            bool                    gpuResolved = false;
+        };
+
+        struct PresentWait
+        {
+            vk::SwapchainKHR        swapchain;
+            uint64_t                presentId   = 0;
+        };
+
+        void finalizeFrames(bool force = false);
+
+        void presentWaitThread(const std::stop_token& stopToken);
+
+        static double toMs(Clock::duration duration);
+
+        std::array<Clock::time_point, static_cast<size_t>(FramePhase::Count)> mPhases {};
+        Clock::time_point                   mLastWaitBegin {};
+        uint64_t                            mFrameNumber = 0;
+
+        std::deque<PendingFrame>            mPending;
+        std::deque<FrameRecord>             mHistory;
+
+        vk::QueryPool                       mQueryPool;
+        double                              mTimestampPeriod = 1.0;   // Nanoseconds per tick
+
+        // Present wait worker
+        bool                                mPresentWait = false;
+        std::deque<PresentWait>             mPresentWaits;
+        std::unordered_map<uint64_t, Clock::time_point> mPresentTimes;    // Default time point if the wait failed
+        bool                                mWaiting = false;         // Worker is inside waitForPresentKHR
+        bool                                mRetired = false;         // Worker abandons its current wait
+        mutable std::mutex                  mPresentMutex;
+        std::condition_variable_any         mPresentCondition;
+        std::jthread                        mPresentThread;
+
+        const uint32_t                      mFrameCount;
+        const uint32_t                      mHistorySize;
+        const uint32_t                      mPercentileWindow;
+        Device*                             mDevice;
+    };
+}
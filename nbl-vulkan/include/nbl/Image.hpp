@@ -41,6 +41,8 @@ namespace nbl
         vk::ImageUsageFlags     usageFlags   = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled;
         std::string             debugName    = "Unknown Image";
         bool                    imageSampler = false;
+        VmaAllocation           aliasAllocation = nullptr;  // Bind to existing memory instead of allocating, not owned by the Image
+        vk::DeviceSize          aliasOffset     = 0;
         Device*                 pDevice      = nullptr;
     };
 
@@ -96,9 +98,16 @@ namespace nbl
 
         static bool isDepthFormat(vk::Format format);
 
+        /**
+         * Memory requirements of an Image created with the given parameters, without creating it.
+         */
+        static vk::MemoryRequirements getMemoryRequirements(const ImageCreateInfo& createInfo);
+
     private:
         static ImageProperties makeProperties(const ImageCreateInfo& imageInfo);
 
+        static vk::ImageCreateInfo makeImageCreateInfo(const ImageCreateInfo& imageInfo, const ImageProperties& properties);
+
         vk::Image               mImage;
         vk::ImageView           mImageView;
         vk::Sampler             mSampler;
@@ -111,6 +120,7 @@ namespace nbl
 
         Device*                 mDevice;
         const bool              mSwapchainImage {false};
+        const bool              mAliased {false};
         const uint32_t          mSwapchainImageIndex {0};
         const ImageProperties   mProperties;
         const std::string       mDebugName;
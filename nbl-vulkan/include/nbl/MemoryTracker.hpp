@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+namespace nbl
+{
+    struct MemoryUsage
+    {
+        uint64_t current = 0;
+        uint64_t peak    = 0;
+        uint32_t count   = 0;
+
+        void add(const uint64_t bytes)
+        {
+            current += bytes;
+            peak     = std::max(peak, current);
+            count++;
+        }
+
+        void remove(const uint64_t bytes)
+        {
+            current -= bytes;
+            count--;
+        }
+    };
+
+    struct MemoryHeapUsage
+    {
+        MemoryUsage tracked;            // Allocations made through Buffer / Image
+        uint64_t    usage     = 0;      // Process usage reported by the driver (VK_EXT_memory_budget) or VMA
+        uint64_t    budget    = 0;
+        uint64_t    size      = 0;
+        bool        deviceLocal = false;
+    };
+
+    /**
+     * Records every Buffer and Image allocation by category (BufferType, "Image") and debug name,
+     * and keeps per-heap usage against the VMA budgets queried each frame.
+     */
+    class MemoryTracker
+    {
+    public:
+        explicit MemoryTracker(VmaAllocator allocator);
+
+        void onAllocate(VmaAllocation allocation, const std::string& category, const std::string& name);
+
+        void onFree(VmaAllocation allocation);
+
+        /**
+         * Query VMA heap budgets, call once per frame.
+         */
+        void update(uint32_t frameIndex);
+
+        /**
+         * @return Snapshot of all heaps, categories and live allocations as JSON.
+         */
+        std::string toJson() const;
+
+        void writeJson(const std::string& filePath) const;
+
+        std::vector<MemoryHeapUsage>       getHeapUsage()     const;
+        std::map<std::string, MemoryUsage> getCategoryUsage() const;
+
+        /**
+         * @return Bytes currently allocated by objects whose debug name starts with the given prefix.
+         */
+        uint64_t getUsageByName(const std::string& namePrefix) const;
+
+        /**
+         * Fraction of a heap budget above which allocations print a warning.
+         */
+        void setWarningThreshold(const float threshold) { mWarningThreshold = threshold; }
+
+    private:
+        struct Record
+        {
+            std::string category;
+            std::string name;
+            uint64_t    size;
+            uint32_t    heapIndex;
+        };
+
+        void checkBudget(uint32_t heapIndex, const Record& record);
+
+        VmaAllocator                                        mAllocator;
+        mutable std::mutex                                  mMutex;
+
+        std::unordered_map<VmaAllocation, Record>           mRecords;
+        std::map<std::string, MemoryUsage>                  mCategories;
+        std::vector<MemoryHeapUsage>                        mHeaps;
+
+        float                                               mWarningThreshold = 0.9f;
+    };
+}
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <compare>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 #include "Util.hpp"
 
 namespace nbl
 {
+    class Descriptor;
     class Device;
     class RenderPass;
 
@@ -56,6 +60,20 @@ namespace nbl
         const char*             entryPoint  = "main";
     };
 
+    /**
+     * 32-bit constant (int, uint, bool or float bits) applied to every shader stage,
+     * stages without a constant of that ID ignore it.
+     */
+    struct SpecializationConstant
+    {
+        uint32_t                id    = 0;
+        uint32_t                value = 0;
+
+        auto operator<=>(const SpecializationConstant&) const = default;
+    };
+
+    using SpecializationConstants = std::vector<SpecializationConstant>;
+
     struct GraphicsPipelineStateInfo
     {
         vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState = PipelineUtils::makeInputAssemblyState();
@@ -142,11 +160,14 @@ namespace nbl
         std::vector<vk::PushConstantRange>   pushConstantRanges;
         std::vector<vk::DescriptorSetLayout> descriptorSetLayouts;
         std::vector<ShaderCreateInfo>        shaderCreateInfos;
+        SpecializationConstants              specializationConstants;
 
         PipelineType                         pipelineType          = PipelineType::Graphics;
         GraphicsPipelineStateInfo            graphicsPipelineState = {};
         RenderingInfo                        renderingInfo         = {};
         RenderPass*                          pRenderPass           = nullptr;
+        bool                                 useDescriptorBuffers  = false;   // Required for DescriptorBackend::Buffer layouts
+        vk::PipelineCache                    pipelineCache         = nullptr; // Set by the PipelineCompiler
         std::string                          debugName             = "Unknown Pipeline";
         Device*                              pDevice               = nullptr;
     };
@@ -169,6 +190,22 @@ namespace nbl
             commandBuffer.bindDescriptorSets(mBindPoint, mPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
         }
 
+        /**
+         * Bind set i of a Descriptor regardless of its DescriptorBackend, see Descriptor::bind.
+         */
+        void bindDescriptor(const vk::CommandBuffer& commandBuffer, const Descriptor* pDescriptor, size_t i, uint32_t firstSet = 0, uint32_t bufferIndex = 0) const;
+
+        /**
+         * Push a push Descriptor from data laid out like its update template.
+         */
+        template <typename T>
+        void pushDescriptor(const vk::CommandBuffer& commandBuffer, const Descriptor* pDescriptor, const T& data, const uint32_t set = 0) const
+        {
+            pushDescriptor(commandBuffer, pDescriptor, &data, sizeof(T), set);
+        }
+
+        void pushDescriptor(const vk::CommandBuffer& commandBuffer, const Descriptor* pDescriptor, const void* pData, size_t size, uint32_t set = 0) const;
+
         void bindDescriptorSets(const vk::CommandBuffer& commandBuffer, const std::vector<vk::DescriptorSet>& descriptorSets) const
         {
             commandBuffer.bindDescriptorSets(mBindPoint, mPipelineLayout, 0, descriptorSets.size(), descriptorSets.data(), 0, nullptr);
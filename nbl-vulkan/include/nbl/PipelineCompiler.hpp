@@ -0,0 +1,168 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include "Pipeline.hpp"
+#include "Util.hpp"
+
+namespace nbl
+{
+    class Device;
+
+    struct PipelineCompilerCreateInfo
+    {
+        uint32_t        threadCount   = 0;          // Worker threads, 0: hardware threads - 1 (at least 1)
+        std::string     cacheFilePath = {};         // Pipeline cache loaded on creation and written on destruction, empty: not persisted
+        Device*         pDevice       = nullptr;
+    };
+
+    /**
+     * Timings of one compiled pipeline.
+     */
+    struct PipelineCompileResult
+    {
+        std::string     debugName;
+        double          queueTime   = 0.0;          // ms, from request until a worker picked it up
+        double          compileTime = 0.0;          // ms, SPIR-V loading and pipeline creation
+        bool            failed      = false;
+    };
+
+    /**
+     * Pipeline being compiled, copies share the result. Frame code polls isReady() and keeps using another pipeline
+     * until then, get() blocks.
+     */
+    class PipelineHandle
+    {
+    public:
+        PipelineHandle() = default;
+
+        explicit PipelineHandle(std::shared_future<std::unique_ptr<Pipeline>> future, const uint64_t requestId = 0)
+        : mFuture(std::move(future))
+        , mRequestId(requestId)
+        {
+        }
+
+        bool isValid() const { return mFuture.valid(); }
+
+        bool isReady() const
+        {
+            return mFuture.valid() && mFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        /**
+         * Wait for the pipeline, rethrows compilation errors.
+         */
+        const Pipeline* get() const { return mFuture.get().get(); }
+
+        /**
+         * The pipeline if it is ready, fallback otherwise.
+         */
+        const Pipeline* getOr(const Pipeline* fallback) const { return isReady() ? get() : fallback; }
+
+        void wait() const { mFuture.wait(); }
+
+        /**
+         * @return PipelineCompiler request that fulfils the handle, 0 if it was not queued.
+         */
+        uint64_t getRequestId() const { return mRequestId; }
+
+    private:
+        std::shared_future<std::unique_ptr<Pipeline>> mFuture;
+        uint64_t                                      mRequestId = 0;
+    };
+
+    /**
+     * Compiles pipelines on worker threads against one shared vk::PipelineCache, so startup and switching
+     * between pipeline variants does not stall the frame loop. Requests are served in order,
+     * urgent ones (someone is about to wait on them) go ahead of queued background work.
+     */
+    class PipelineCompiler
+    {
+    public:
+        nbl_DISABLE_COPY(PipelineCompiler);
+        nbl_CI_CTOR(PipelineCompiler, PipelineCompilerCreateInfo);
+
+        ~PipelineCompiler();
+
+        /**
+         * Queue a pipeline, its pipelineCache is replaced with the shared cache.
+         * Requests still queued when the compiler is destroyed are abandoned, their handles throw std::future_error.
+         */
+        PipelineHandle compile(const PipelineCreateInfo& createInfo, bool urgent = false);
+
+        /**
+         * Compile on the calling thread against the shared cache.
+         */
+        std::unique_ptr<Pipeline> compileNow(const PipelineCreateInfo& createInfo);
+
+        /**
+         * Take the request of a handle off the queue and compile it on the calling thread, instead of waiting
+         * behind the queued requests.
+         * @return false if a worker already picked it up or it is done, wait on the handle instead.
+         */
+        bool compileQueued(const PipelineHandle& handle);
+
+        /**
+         * Drop requests that no worker picked up yet, their handles throw std::future_error.
+         * Requests being compiled are not interrupted, wait on their handles.
+         */
+        void cancel(std::span<const PipelineHandle> handles);
+
+        /**
+         * Timings of every finished request, in completion order.
+         */
+        std::vector<PipelineCompileResult> getResults() const;
+
+        uint32_t getPendingCount() const;
+
+        /**
+         * Write the pipeline cache to cacheFilePath.
+         */
+        void saveCache() const;
+
+        vk::PipelineCache getPipelineCache() const { return mPipelineCache; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Request
+        {
+            uint64_t                                id = 0;
+            PipelineCreateInfo                      createInfo;
+            std::promise<std::unique_ptr<Pipeline>> promise;
+            Clock::time_point                       requestTime;
+        };
+
+        void workerThread(const std::stop_token& stopToken);
+
+        std::unique_ptr<Pipeline> build(PipelineCreateInfo createInfo, Clock::time_point requestTime);
+
+        /**
+         * Cache data written by the same driver for the same device, anything else is discarded.
+         */
+        std::vector<char> loadCacheData() const;
+
+        vk::PipelineCache                   mPipelineCache;
+        std::string                         mCacheFilePath;
+
+        std::deque<Request>                 mRequests;
+        uint64_t                            mNextRequestId = 1;
+        uint32_t                            mActiveCount = 0;   // Requests picked up by a worker
+        std::vector<PipelineCompileResult>  mResults;
+        mutable std::mutex                  mMutex;
+        std::condition_variable_any         mCondition;
+        std::vector<std::jthread>           mWorkers;
+
+        Device*                             mDevice;
+    };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include "Util.hpp"
+
+namespace nbl
+{
+    class Device;
+
+    struct PipelineStatisticsCreateInfo
+    {
+        uint32_t        frameCount = 2;         // Frames in flight, each has its own range of queries
+        uint32_t        scopeCount = 64;        // Scopes per frame, later allocations are ignored
+        Device*         pDevice    = nullptr;
+    };
+
+    /**
+     * Counters of one scope, statistics the device does not support stay 0.
+     */
+    struct PipelineStatisticsResult
+    {
+        uint64_t        vertexShaderInvocations   = 0;
+        uint64_t        clippingInvocations       = 0;  // Primitives reaching the clipping stage
+        uint64_t        clippingPrimitives        = 0;  // Primitives output by the clipping stage
+        uint64_t        fragmentShaderInvocations = 0;
+        uint64_t        computeShaderInvocations  = 0;
+        uint64_t        taskShaderInvocations     = 0;  // VK_EXT_mesh_shader
+        uint64_t        meshShaderInvocations     = 0;  // VK_EXT_mesh_shader
+        uint64_t        meshPrimitivesGenerated   = 0;  // VK_QUERY_TYPE_MESH_PRIMITIVES_GENERATED_EXT
+        uint64_t        frameNumber               = 0;  // Frame the counters were resolved in
+    };
+
+    /**
+     * Pipeline statistics (and mesh primitive) queries around named scopes of a frame.
+     * Scopes are allocated while the frame is declared and may be recorded on any thread, each scope must begin and end
+     * in the same command buffer outside of a render pass instance. Results are read without waiting once the frame
+     * slot is reused, the latest result of every scope name is kept.
+     */
+    class PipelineStatistics
+    {
+    public:
+        nbl_DISABLE_COPY(PipelineStatistics);
+        nbl_CI_CTOR(PipelineStatistics, PipelineStatisticsCreateInfo);
+
+        ~PipelineStatistics();
+
+        static constexpr uint32_t sInvalidScope = ~0u;
+
+        /**
+         * @param meshPrimitives Also count VK_QUERY_TYPE_MESH_PRIMITIVES_GENERATED_EXT, scopes drawing with mesh shaders.
+         * @return Scope for begin/end, sInvalidScope if queries are unsupported or the frame ran out of scopes.
+         */
+        uint32_t allocate(uint32_t frameIndex, const std::string& name, bool meshPrimitives = false);
+
+        void begin(const vk::CommandBuffer& commandBuffer, uint32_t scope) const;
+
+        void end(const vk::CommandBuffer& commandBuffer, uint32_t scope) const;
+
+        /**
+         * Read the scopes of the frame slot, its previous submission must have completed.
+         */
+        void resolve(uint32_t frameIndex, uint64_t frameNumber);
+
+        std::optional<PipelineStatisticsResult> getResult(const std::string& name) const;
+
+        /**
+         * Latest result of every scope name, ordered by name.
+         */
+        const std::map<std::string, PipelineStatisticsResult>& getResults() const { return mResults; }
+
+        bool isSupported() const { return mQueryPool != nullptr; }
+
+    private:
+        struct Scope
+        {
+            std::string                 name;
+            bool                        meshPrimitives = false;
+        };
+
+        vk::QueryPool                       mQueryPool;             // Pipeline statistics
+        vk::QueryPool                       mMeshQueryPool;         // Mesh primitives generated, same indices
+        vk::QueryPipelineStatisticFlags     mStatisticFlags;
+        uint32_t                            mStatisticCount = 0;
+
+        std::vector<std::vector<Scope>>     mScopes;                // [Frame Index] -> Scopes allocated this frame
+        std::map<std::string, PipelineStatisticsResult> mResults;
+
+        const uint32_t                      mFrameCount;
+        const uint32_t                      mScopeCount;
+        Device*                             mDevice;
+    };
+}
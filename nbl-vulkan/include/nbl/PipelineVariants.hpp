@@ -0,0 +1,67 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include "Pipeline.hpp"
+#include "PipelineCompiler.hpp"
+#include "Util.hpp"
+
+namespace nbl
+{
+    struct PipelineVariantsCreateInfo
+    {
+        PipelineCreateInfo      baseCreateInfo;                 // Shared by every variant, its specializationConstants are the defaults
+        PipelineCompiler*       pCompiler       = nullptr;      // Background builds, nullptr: every variant is built on first use
+    };
+
+    /**
+     * Pipelines of one PipelineCreateInfo that only differ in specialization constants, compiled separately so
+     * branches on the constants are resolved by the driver. Variants are cached by their constant values and built
+     * on first use, or ahead of time by the PipelineCompiler.
+     */
+    class PipelineVariants
+    {
+    public:
+        nbl_DISABLE_COPY(PipelineVariants);
+        nbl_CI_CTOR(PipelineVariants, PipelineVariantsCreateInfo);
+
+        /**
+         * Cancels variants still queued on the PipelineCompiler and waits for the ones being compiled.
+         */
+        ~PipelineVariants();
+
+        /**
+         * Variant with the given constants (on top of the defaults), built on the calling thread if nobody requested it
+         * yet or its request is still queued, waits if a worker is compiling it.
+         */
+        const Pipeline* get(const SpecializationConstants& specialization);
+
+        /**
+         * Variant with the given constants if it is ready, otherwise it is requested and fallback is returned.
+         */
+        const Pipeline* tryGet(const SpecializationConstants& specialization, const Pipeline* fallback = nullptr);
+
+        /**
+         * Queue the variants on the PipelineCompiler, already requested variants are skipped.
+         */
+        void prepare(std::span<const SpecializationConstants> specializations);
+
+        size_t getVariantCount() const;
+
+    private:
+        /**
+         * Defaults overridden by specialization, ordered by constant ID: equal constants give equal keys.
+         */
+        SpecializationConstants getKey(const SpecializationConstants& specialization) const;
+
+        PipelineCreateInfo getCreateInfo(const SpecializationConstants& key) const;
+
+        PipelineCreateInfo                                  mBaseCreateInfo;
+        std::map<SpecializationConstants, PipelineHandle>   mVariants;
+        mutable std::mutex                                  mMutex;
+
+        PipelineCompiler*                                   mCompiler;
+    };
+}
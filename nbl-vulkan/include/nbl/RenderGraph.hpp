@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.hpp>
+
+#include "IAttachmentSource.hpp"
+#include "Util.hpp"
+
+namespace nbl
+{
+    class Buffer;
+    class CommandAllocator;
+    class Device;
+    class Image;
+
+    using RenderGraphResource = uint32_t;
+
+    /**
+     * How a pass uses a resource, determines the pipeline stages, access flags and image layout.
+     */
+    enum class RenderGraphUsage
+    {
+        TransferRead,
+        TransferWrite,
+        IndirectRead,
+        ComputeStorageRead,
+        ComputeStorageWrite,
+        VertexStorageRead,
+        MeshStorageRead,        // Task and Mesh shaders
+        GraphicsStorageWrite,   // Task, Mesh and Fragment shader stores and atomics
+        FragmentSampled,
+        ColorAttachment,
+        DepthAttachment,
+        Present,
+    };
+
+    std::string toString(RenderGraphUsage usage) noexcept;
+
+    struct RenderGraphCreateInfo
+    {
+        Device*         pDevice   = nullptr;
+        std::string     debugName = "Render Graph";
+    };
+
+    /**
+     * Transient image owned by the RenderGraph, its memory may be aliased with other transient images
+     * whose lifetimes do not overlap. Usage flags are derived from the declared pass usages.
+     */
+    struct RenderGraphImageInfo
+    {
+        std::string     debugName;
+        vk::Extent2D    extent = { 1920, 1080 };
+        vk::Format      format = vk::Format::eR8G8B8A8Unorm;
+    };
+
+    struct RenderGraphAccess
+    {
+        RenderGraphResource resource;
+        RenderGraphUsage    usage;
+    };
+
+    struct RenderGraphPassInfo
+    {
+        std::string                                     name;
+        std::vector<RenderGraphAccess>                  accesses;
+        std::function<void(const vk::CommandBuffer&)>   execute;
+        bool                                            sideEffects = false;    // Never culled
+        bool                                            parallel    = false;    // Recorded on a worker thread into a secondary command buffer,
+                                                                                // execute must be thread-safe and set its own dynamic state
+    };
+
+    /**
+     * Compiled state of the RenderGraph, for diagnostics.
+     */
+    struct RenderGraphStatistics
+    {
+        uint32_t        passCount           = 0;
+        uint32_t        culledPassCount     = 0;
+        uint32_t        transientImageCount = 0;
+        uint32_t        allocationCount     = 0;
+        vk::DeviceSize  transientBytes      = 0;    // Memory used by transient images after aliasing
+        vk::DeviceSize  unaliasedBytes      = 0;    // Memory transient images would use without aliasing
+        uint32_t        compileCount        = 0;
+    };
+
+    /**
+     * Frame graph recorded into a single command buffer.
+     * Passes are declared every frame in submission order, together with the resources they read and write.
+     * The graph culls passes that do not contribute to an imported resource, places transient images in shared
+     * memory and inserts one batched pipelineBarrier2 in front of every pass.
+     * The compiled graph is cached and only rebuilt when the declared topology changes.
+     */
+    class RenderGraph
+    {
+    public:
+        nbl_DISABLE_COPY(RenderGraph);
+        nbl_CI_CTOR(RenderGraph, RenderGraphCreateInfo);
+
+        ~RenderGraph();
+
+        /**
+         * Declare a transient image, repeated declarations with the same name return the same resource.
+         */
+        RenderGraphResource createImage(const RenderGraphImageInfo& imageInfo);
+
+        /**
+         * Import an external image for the current frame, rebinding the Image of an already imported name does not change the topology.
+         * Imports are dropped by execute, resources used by the next frame's passes have to be imported again.
+         * @param finalUsage Transition applied after the last pass, e.g. Present for Swapchain images.
+         */
+        RenderGraphResource importImage(const std::string& name, Image* pImage, std::optional<RenderGraphUsage> finalUsage = std::nullopt);
+
+        RenderGraphResource importBuffer(const std::string& name, Buffer* pBuffer);
+
+        void addPass(RenderGraphPassInfo passInfo);
+
+        /**
+         * Compile (if the topology changed) and record all live passes, then clear the declared passes.
+         * With an allocator, parallel passes are recorded concurrently and executed in declaration order.
+         */
+        void execute(const vk::CommandBuffer& commandBuffer, CommandAllocator* pAllocator = nullptr);
+
+        /**
+         * Stable attachment source for a transient image, valid across recompilations.
+         */
+        IAttachmentSource* getAttachmentSource(RenderGraphResource resource) const;
+
+        Image* getImage(RenderGraphResource resource) const;
+
+        const RenderGraphStatistics& getStatistics() const { return mStatistics; }
+
+    private:
+        struct ResourceState
+        {
+            vk::PipelineStageFlags2 writeStages = vk::PipelineStageFlagBits2::eNone;
+            vk::AccessFlags2        writeAccess = vk::AccessFlagBits2::eNone;
+            vk::PipelineStageFlags2 readStages  = vk::PipelineStageFlagBits2::eNone;   // Readers since the last write
+            vk::AccessFlags2        readAccess  = vk::AccessFlagBits2::eNone;
+            vk::ImageLayout         layout      = vk::ImageLayout::eUndefined;
+        };
+
+        class TransientImageSource;
+
+        struct ResourceEntry
+        {
+            std::string                             name;
+            bool                                    isImage    = true;
+            bool                                    isImported = false;
+
+            RenderGraphImageInfo                    imageInfo;
+            std::optional<RenderGraphUsage>         finalUsage;
+            Image*                                  pImage     = nullptr;
+            Buffer*                                 pBuffer    = nullptr;
+
+            // Transient images
+            std::unique_ptr<TransientImageSource>   source;
+            std::unique_ptr<Image>                  physicalImage;
+            vk::ImageUsageFlags                     usageFlags;
+            int32_t                                 allocationIndex = gInvalidIndex;
+            int32_t                                 firstPass       = gInvalidIndex;
+            int32_t                                 lastPass        = gInvalidIndex;
+        };
+
+        struct TransientAllocation
+        {
+            VmaAllocation                           allocation = nullptr;
+            vk::MemoryRequirements                  requirements;
+            std::vector<RenderGraphResource>        images;         // Ordered by first use
+            ResourceState                           state;          // State of the last image that used the memory
+        };
+
+        void compile();
+
+        void allocateTransientImages();
+
+        void releaseTransientImages();
+
+        size_t hashTopology() const;
+
+        /**
+         * Transient, or imported for the current frame.
+         */
+        static bool isAvailable(const ResourceEntry& entry);
+
+        void recordParallelPasses(CommandAllocator* pAllocator, std::vector<vk::CommandBuffer>& secondaryCommandBuffers) const;
+
+        /**
+         * Transition a resource into dstState, appending a barrier only if one is needed.
+         */
+        void transition(
+            RenderGraphResource                   resource,
+            const ResourceState&                  dstState,
+            bool                                  write,
+            ResourceState&                        state,
+            std::vector<vk::ImageMemoryBarrier2>&  imageBarriers,
+            std::vector<vk::BufferMemoryBarrier2>& bufferBarriers);
+
+        static ResourceState getUsageState(RenderGraphUsage usage);
+
+        static bool isWriteUsage(RenderGraphUsage usage);
+
+        static vk::ImageUsageFlags getImageUsageFlags(RenderGraphUsage usage);
+
+        std::vector<ResourceEntry>                  mResources;
+        std::unordered_map<std::string, RenderGraphResource> mResourceLookup;
+        std::vector<RenderGraphPassInfo>            mPasses;
+
+        // Compiled graph
+        std::vector<uint32_t>                       mLivePasses;
+        std::vector<TransientAllocation>            mAllocations;
+        std::optional<size_t>                       mCompiledHash;
+        RenderGraphStatistics                       mStatistics;
+
+        // Barrier counters of the current execution, see Barrier::recordStatistics
+        uint32_t                                    mRequestedBarriers {0};
+        uint32_t                                    mIssuedBarriers    {0};
+        uint32_t                                    mBarrierBatches    {0};
+
+        Device*                                     mDevice;
+        const std::string                           mDebugName;
+    };
+}
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <span>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
@@ -45,9 +46,28 @@ namespace nbl
             const vk::CommandBuffer&                             commandBuffer,
             const std::function<void(const vk::CommandBuffer&)>& lambda);
 
+        /**
+         * Execute secondary command buffers recorded with getInheritanceInfo inside the render pass.
+         */
+        void execute(
+            const vk::CommandBuffer&            commandBuffer,
+            std::span<const vk::CommandBuffer>  secondaryCommandBuffers);
+
+        /**
+         * Attachment formats for secondary command buffers continuing this render pass (CommandList::beginSecondary).
+         */
+        const vk::CommandBufferInheritanceRenderingInfo& getInheritanceInfo() const { return mInheritanceInfo; }
+
+        /**
+         * Update the render area, e.g. after the Swapchain was recreated.
+         */
+        void setRenderArea(const vk::Rect2D& renderArea);
+
     private:
         friend class Pipeline;
 
+        void updateAttachmentViews();
+
         vk::RenderingInfo                        mRenderingInfo;
 
         std::vector<Attachment>                  mColorAttachments;
@@ -59,6 +79,9 @@ namespace nbl
         vk::RenderingAttachmentInfo              mDepthAttachmentInfo;
         vk::RenderingAttachmentInfo              mStencilAttachmentInfo;
 
+        std::vector<vk::Format>                  mColorFormats;
+        vk::CommandBufferInheritanceRenderingInfo mInheritanceInfo;
+
         std::optional<DebugLabelInfo>            mLabelInfo;
     };
 }
\ No newline at end of file
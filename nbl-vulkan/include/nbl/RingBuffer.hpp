@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.hpp>
+#include "Util.hpp"
+
+namespace nbl
+{
+    class Device;
+
+    struct RingBufferCreateInfo
+    {
+        uint64_t        frameSize  = 8 * 1024 * 1024;   // Bytes available to a single frame
+        uint32_t        frameCount = 2;                 // Number of frames in flight
+        Device*         pDevice    = nullptr;
+        std::string     debugName  = "Ring Buffer";
+    };
+
+    /**
+     * Sub-allocation of a RingBuffer, valid until the same frame index comes around again.
+     */
+    struct RingAllocation
+    {
+        std::byte*        pData   = nullptr;
+        vk::DeviceAddress address = 0;
+        uint64_t          offset  = 0;      // Offset into RingBuffer::getHandle()
+        uint64_t          size    = 0;
+
+        bool isValid() const { return pData != nullptr; }
+
+        vk::DescriptorBufferInfo getDescriptorInfo(const vk::Buffer& buffer) const
+        {
+            return { buffer, offset, size };
+        }
+    };
+
+    /**
+     * Persistently mapped linear allocator for per-frame transient data (constants, culling parameters, ...).
+     * The buffer is split into one partition per frame in flight, a partition is only rewound
+     * after the timeline value of its previous use was waited on (VulkanRHI::beginFrame).
+     * allocate() is lock-free and may be called from multiple recording threads.
+     */
+    class RingBuffer
+    {
+    public:
+        nbl_DISABLE_COPY(RingBuffer);
+        nbl_CI_CTOR(RingBuffer, RingBufferCreateInfo);
+
+        ~RingBuffer();
+
+        /**
+         * Bump allocate from the current frame's partition.
+         * @return Invalid allocation when the partition is exhausted.
+         */
+        RingAllocation allocate(uint64_t size, uint64_t alignment = 0);
+
+        /**
+         * Allocate and copy the given data.
+         */
+        template <class T>
+        RingAllocation push(const T& data, const uint64_t alignment = 0)
+        {
+            const RingAllocation allocation = allocate(sizeof(T), alignment);
+            if (allocation.isValid())
+            {
+                std::memcpy(allocation.pData, &data, sizeof(T));
+            }
+            return allocation;
+        }
+
+        /**
+         * Rewind the partition of the given frame, its previous submission must have completed.
+         */
+        void beginFrame(uint32_t frameIndex);
+
+        /**
+         * Make the current frame's writes visible to the device, no-op for coherent memory.
+         */
+        void flush() const;
+
+        const vk::Buffer& getHandle()        const { return mBuffer;        }
+        vk::DeviceAddress getAddress()       const { return mDeviceAddress; }
+        uint64_t          getFrameSize()     const { return mFrameSize;     }
+        uint64_t          getAllocSize()     const { return mAllocationInfo.size; }
+
+        uint64_t getUsedSize() const { return mHead.load(std::memory_order_relaxed) - mFrameBegin; }
+        uint64_t getPeakUsedSize() const { return mPeakUsedSize; }
+        uint32_t getFailedAllocationCount() const { return mFailedAllocations.load(std::memory_order_relaxed); }
+
+    private:
+        vk::Buffer                  mBuffer;
+        VmaAllocation               mAllocation {};
+        VmaAllocationInfo           mAllocationInfo {};
+        vk::DeviceAddress           mDeviceAddress {0};
+        std::byte*                  mMapped {nullptr};
+        bool                        mCoherent {false};
+
+        uint64_t                    mFrameSize;
+        uint32_t                    mFrameCount;
+        uint64_t                    mMinAlignment {256};
+
+        uint64_t                    mFrameBegin {0};
+        uint64_t                    mFrameEnd {0};
+        std::atomic<uint64_t>       mHead {0};
+        std::atomic<uint32_t>       mFailedAllocations {0};
+        uint64_t                    mPeakUsedSize {0};
+
+        std::string                 mName;
+        Device*                     mDevice;
+    };
+}
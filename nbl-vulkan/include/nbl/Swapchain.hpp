@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "IAttachmentSource.hpp"
@@ -17,7 +20,8 @@ namespace nbl
         IWindow*       pWindow = nullptr;
         Device*        pDevice = nullptr;
         vk::Instance   instance;
-        uint32_t       imageCount {};
+        uint32_t       imageCount {};                                   // Minimum, the driver may create more
+        vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;  // Falls back if unsupported, see selectPresentMode
     };
 
     class Swapchain final : public IAttachmentSource
@@ -28,18 +32,38 @@ namespace nbl
 
         ~Swapchain() override;
 
-        void present(vk::Semaphore waitSemaphore, uint32_t imageIndex) const;
+        /**
+         * @param presentId VK_KHR_present_id value for the present, ignored if 0.
+         * @return False if the Swapchain is out of date or suboptimal and should be recreated.
+         */
+        bool present(vk::Semaphore waitSemaphore, uint32_t imageIndex, uint64_t presentId = 0) const;
+
+        /**
+         * Recreate the Swapchain for the current framebuffer size, retiring the old one through setOldSwapchain.
+         * Images of the old Swapchain must no longer be in use.
+         * @param presentMode Requested present mode, keeps the current one if not given.
+         */
+        void recreate(std::optional<vk::PresentModeKHR> presentMode = std::nullopt);
+
+        /**
+         * Pick the requested mode if supported, otherwise the closest alternative.
+         * Mailbox and Immediate fall back to each other (no vsync blocking) before FIFO, which is always available.
+         */
+        static vk::PresentModeKHR selectPresentMode(vk::PresentModeKHR requested, const std::vector<vk::PresentModeKHR>& supported);
 
         void setScissorViewport(const vk::CommandBuffer& commandList) const;
 
         vk::SwapchainKHR getHandle()      const          { return mSwapchain;   }
 
         float            getAspectRatio() const          { return mAspectRatio; }
-        uint32_t         getImageCount()  const          { return mImageCount;  }
+        uint32_t         getImageCount()  const          { return static_cast<uint32_t>(mImages.size()); }
         vk::Extent2D     getExtent()      const          { return mExtent;      }
         vk::Rect2D       getArea()        const          { return mArea;        }
         vk::Format       getFormat()      const override { return mFormat;      }
 
+        vk::PresentModeKHR                     getPresentMode()           const { return mPresentMode;           }
+        const std::vector<vk::PresentModeKHR>& getSupportedPresentModes() const { return mSupportedPresentModes; }
+
         Image*           getImage(size_t i)     const;
         vk::Image        getVkImage(size_t i)   const;
         vk::ImageView    getImageView(size_t i) const;
@@ -52,21 +76,25 @@ namespace nbl
     private:
         void createSurface();
         void checkSwapchainSupport();
-        void createSwapchain();
+        void createSwapchain(vk::SwapchainKHR oldSwapchain = nullptr);
         void acquireImages();
         void makeDynamicState();
+        void wrapImages();
+        void destroyImageViews();
 
         friend class RenderPass;
         friend class VulkanRHI;
         uint32_t                            mLastAcquiredIndex = 0;
 
-        const uint32_t                      mImageCount;
+        const uint32_t                      mMinImageCount;
         vk::Extent2D                        mExtent;
         vk::Rect2D                          mArea;
         float                               mAspectRatio {0.0f};
         vk::Format                          mFormat {vk::Format::eB8G8R8A8Unorm};
         vk::ColorSpaceKHR                   mColorSpace {vk::ColorSpaceKHR::eSrgbNonlinear};
-        vk::PresentModeKHR                  mPresentMode {vk::PresentModeKHR::eMailbox};
+        vk::PresentModeKHR                  mRequestedPresentMode {vk::PresentModeKHR::eMailbox};
+        vk::PresentModeKHR                  mPresentMode {vk::PresentModeKHR::eFifo};
+        std::vector<vk::PresentModeKHR>     mSupportedPresentModes;
         vk::SurfaceTransformFlagBitsKHR     mCurrentTransform {};
         vk::SurfaceKHR                      mSurface;
         vk::SwapchainKHR                    mSwapchain;
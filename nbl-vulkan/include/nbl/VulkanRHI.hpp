@@ -1,13 +1,25 @@
 #pragma once
 
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
+#include "BindlessTable.hpp"
 #include "Buffer.hpp"
+#include "BufferArena.hpp"
+#include "CommandAllocator.hpp"
 #include "CommandQueue.hpp"
 #include "Descriptor.hpp"
 #include "Device.hpp"
 #include "Frame.hpp"
+#include "FrameProfiler.hpp"
+#include "PipelineCompiler.hpp"
+#include "PipelineStatistics.hpp"
 #include "Image.hpp"
+#include "RenderGraph.hpp"
+#include "RingBuffer.hpp"
 #include "Swapchain.hpp"
 #include "Util.hpp"
 
@@ -19,6 +31,12 @@ namespace nbl
     {
         bool        validation      = false;
         uint32_t    backBufferCount = 2;
+        uint32_t    framesInFlight  = 2;                            // Frames the CPU may record ahead of the GPU
+        vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;
+        uint64_t    transientBufferFrameSize = 8 * 1024 * 1024;     // Per-frame capacity of the transient RingBuffer
+        uint32_t    frameHistorySize = 4096;                        // Frames kept by the FrameProfiler
+        uint32_t    pipelineCompilerThreads = 0;                    // PipelineCompiler workers, 0: hardware threads - 1
+        std::string pipelineCacheFile = "pipeline_cache.bin";       // Persisted PipelineCompiler cache, empty: not persisted
         std::string applicationName = "Unknown Application";
         std::string engineName      = "nbl::VulkanRHI";
     };
@@ -40,15 +58,19 @@ namespace nbl
         nbl_DISABLE_COPY(VulkanRHI);
         nbl_CI_CTOR(VulkanRHI, VulkanRHICreateInfo);
 
+        ~VulkanRHI();
+
         // ================================
         // "Frames"
         // ================================
 
         /**
          * Acquire next Swapchain image and begin the rendering frame.
+         * The Swapchain is recreated first if the window was resized, it was reported out of date
+         * or a different present mode was requested.
          * @return Current Frame and Acquired Image Indices
          */
-        Frame beginFrame() const;
+        Frame beginFrame();
 
         /**
          * Submit current frame with recorded command buffers to the GPU,
@@ -56,6 +78,23 @@ namespace nbl
          */
         void submitFrame(const Frame& frame);
 
+        // ================================
+        // Swapchain
+        // ================================
+
+        /**
+         * Request a present mode (with fallback, see Swapchain::selectPresentMode), applied at the next beginFrame.
+         */
+        void setPresentMode(vk::PresentModeKHR presentMode);
+
+        /**
+         * Register a callback invoked after the Swapchain was recreated, for rebuilding size dependent resources.
+         * @return Id for removeSwapchainCallback.
+         */
+        uint32_t addSwapchainCallback(std::function<void(const Swapchain&)> callback);
+
+        void removeSwapchainCallback(uint32_t id);
+
         // ================================
         // Resource Creation
         // ================================
@@ -66,6 +105,19 @@ namespace nbl
          */
         std::unique_ptr<Buffer> createBuffer(const BufferCreateInfo& createInfo) const;
 
+        /**
+         * Upload host data to device buffers. Mapped buffers (see BufferCreateInfo::hostAccess) are written directly,
+         * the rest share one staging submission on the graphics queue.
+         * @return Path taken for each upload, in order.
+         */
+        std::vector<UploadPath> uploadBuffers(std::span<const BufferUploadInfo> uploadInfos) const;
+
+        /**
+         * Create a new BufferArena for sub-allocating many small buffers of the same type.
+         * @return BufferArena
+         */
+        std::unique_ptr<BufferArena> createBufferArena(const BufferArenaCreateInfo& createInfo) const;
+
         /**
          * Create a new Descriptor resource with the given parameters.
          * @return Descriptor
@@ -78,18 +130,73 @@ namespace nbl
          */
         std::unique_ptr<Image> createImage(const ImageCreateInfo& createInfo) const;
 
+        /**
+         * Create a new RenderGraph for recording frames into a single command buffer.
+         * @return RenderGraph
+         */
+        std::unique_ptr<RenderGraph> createRenderGraph(const RenderGraphCreateInfo& createInfo) const;
+
         // ================================
         // Getter Methods for GPU Objects
         // ================================
 
         Device*       getDevice()        const { return mDevice.get();        }
         CommandQueue* getGraphicsQueue() const { return mGraphicsQueue.get(); }
-        CommandQueue* getComputeQueue()  const { return mComputeQueue.get();  }
+
+        /**
+         * The graphics CommandQueue if the device has no separate compute family.
+         */
+        CommandQueue* getComputeQueue()  const { return mComputeQueue ? mComputeQueue.get() : mGraphicsQueue.get(); }
+
         Swapchain*    getSwapchain()     const { return mSwapchain.get();     }
 
+        /**
+         * Number of frame slots, per-frame resources (uniform buffers, descriptor sets) are indexed by Frame::currentFrame.
+         */
+        uint32_t      getFramesInFlight() const { return mFramesInFlight; }
+
+        /**
+         * Per-frame transient allocator, rewound in beginFrame once the frame's timeline value was waited on.
+         */
+        RingBuffer*   getTransientBuffer() const { return mTransientBuffer.get(); }
+
+        /**
+         * Global bindless descriptor set, released indices are recycled after framesInFlight frames.
+         */
+        BindlessTable* getBindlessTable()  const { return mBindlessTable.get();   }
+
+        /**
+         * Per-frame and per-thread graphics command pools, reset in beginFrame once the frame's timeline value was waited on.
+         */
+        CommandAllocator* getCommandAllocator() const { return mCommandAllocator.get(); }
+
+        /**
+         * Frame lifecycle timings, applications mark FramePhase::InputPoll before beginFrame.
+         */
+        FrameProfiler*    getFrameProfiler()    const { return mFrameProfiler.get();    }
+
+        /**
+         * Pipeline statistics scopes of the frame being recorded, resolved in beginFrame once the frame slot is reused.
+         */
+        PipelineStatistics* getPipelineStatistics() const { return mPipelineStatistics.get(); }
+
+        /**
+         * Background pipeline compilation against the shared, persisted pipeline cache.
+         */
+        PipelineCompiler* getPipelineCompiler() const { return mPipelineCompiler.get(); }
+
     private:
         void createInstance();
 
+        void recreateSwapchain();
+
+        /**
+         * One per Swapchain image, the driver may create more images than backBufferCount.
+         */
+        void createRenderingFinishedSemaphores();
+
+        void destroyRenderingFinishedSemaphores();
+
         static bool                     sExists;
 
         IWindow*                        mWindow = nullptr;
@@ -102,14 +209,31 @@ namespace nbl
         std::unique_ptr<Device>         mDevice;
 
         std::unique_ptr<CommandQueue>   mGraphicsQueue;
-        std::unique_ptr<CommandQueue>   mComputeQueue;
+        std::unique_ptr<CommandQueue>   mComputeQueue;          // nullptr: shares mGraphicsQueue
         std::unique_ptr<Swapchain>      mSwapchain;
-
-        uint32_t                        mBackBufferCount = 2;
+        std::unique_ptr<RingBuffer>     mTransientBuffer;
+        std::unique_ptr<BindlessTable>  mBindlessTable;
+        std::unique_ptr<CommandAllocator> mCommandAllocator;
+        std::unique_ptr<FrameProfiler>  mFrameProfiler;
+        std::unique_ptr<PipelineStatistics> mPipelineStatistics;
+        std::unique_ptr<PipelineCompiler>   mPipelineCompiler;
+
+        struct FrameSync
+        {
+            vk::Semaphore               imageAcquired;          // Binary, required by vkAcquireNextImageKHR
+            uint64_t                    timelineValue = 0;      // Graphics timeline value signalled by the frame's submission
+            uint64_t                    deletionValue = 0;      // DeletionQueue submission closed by the frame
+        };
+
+        const uint32_t                  mFramesInFlight;
         uint32_t                        mCurrentFrame    = 0;
 
-        std::vector<vk::Fence>          mFrameInFlight;
-        std::vector<vk::Semaphore>      mImageReady;
-        std::vector<vk::Semaphore>      mRenderingFinished;
+        std::vector<FrameSync>          mFrames;
+        std::vector<vk::Semaphore>      mRenderingFinished;     // Per Swapchain image, waited on by vkQueuePresentKHR
+
+        bool                                mSwapchainOutOfDate = false;
+        std::optional<vk::PresentModeKHR>   mRequestedPresentMode;
+        std::vector<std::pair<uint32_t, std::function<void(const Swapchain&)>>> mSwapchainCallbacks;
+        uint32_t                            mNextSwapchainCallbackId = 0;
     };
 }
\ No newline at end of file
@@ -1,68 +1,207 @@
 #include "Barrier.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include "Buffer.hpp"
 #include "Image.hpp"
 
 namespace nbl
 {
+    namespace
+    {
+        struct AtomicBarrierStatistics
+        {
+            std::atomic<uint32_t> requested {0};
+            std::atomic<uint32_t> issued    {0};
+            std::atomic<uint32_t> batches   {0};
+        };
+
+        AtomicBarrierStatistics sCurrentFrame;
+        BarrierStatistics       sLastFrame;
+    }
+
     void Barrier::transitionImageLayout(const ImageLayoutTransitionInfo& transitionInfo)
     {
-        const auto& imageInfo = transitionInfo.imageTransitionInfo;
-
-        const auto barrier = vk::ImageMemoryBarrier2()
-            .setOldLayout(imageInfo.pImage->getState().layout)
-            .setNewLayout(imageInfo.newLayout)
-            .setSrcAccessMask(imageInfo.pImage->getState().accessFlags)
-            .setDstAccessMask(imageInfo.dstAccessMask)
-            .setSrcStageMask(imageInfo.srcStageMask)
-            .setDstStageMask(imageInfo.dstStageMask)
-            .setSubresourceRange(imageInfo.pImage->getProperties().subresourceRange)
-            .setImage(imageInfo.pImage->getImage());
+        BarrierBatch(transitionInfo.commandBuffer).transition(transitionInfo.imageTransitionInfo);
+    }
 
-        const auto dependencyInfo = vk::DependencyInfo()
-            .setImageMemoryBarrierCount(1)
-            .setPImageMemoryBarriers(&barrier);
+    void Barrier::transitionImageLayouts(const ImageLayoutTransitionsInfo& transitionInfo)
+    {
+        BarrierBatch batch(transitionInfo.commandBuffer);
+        for (const auto& imageInfo : transitionInfo.imageTransitionInfos)
+        {
+            batch.transition(imageInfo);
+        }
+    }
 
-        transitionInfo.commandBuffer.pipelineBarrier2(&dependencyInfo);
+    bool Barrier::hasWriteAccess(const vk::AccessFlags2 accessFlags)
+    {
+        using enum vk::AccessFlagBits2;
+        constexpr vk::AccessFlags2 writeAccess =
+            eShaderWrite | eShaderStorageWrite | eColorAttachmentWrite | eDepthStencilAttachmentWrite |
+            eTransferWrite | eHostWrite | eMemoryWrite | eAccelerationStructureWriteKHR;
+        return static_cast<bool>(accessFlags & writeAccess);
+    }
 
-        imageInfo.pImage->updateState({
-            .accessFlags = imageInfo.dstAccessMask,
-            .layout      = imageInfo.newLayout,
-            .stageFlags  = imageInfo.dstStageMask,
-        });
+    void Barrier::recordStatistics(const uint32_t requested, const uint32_t issued, const uint32_t batches)
+    {
+        sCurrentFrame.requested += requested;
+        sCurrentFrame.issued    += issued;
+        sCurrentFrame.batches   += batches;
     }
 
-    void Barrier::transitionImageLayouts(const ImageLayoutTransitionsInfo& transitionInfo)
+    BarrierStatistics Barrier::getFrameStatistics()
+    {
+        return sLastFrame;
+    }
+
+    void Barrier::nextFrame()
+    {
+        sLastFrame = {
+            .requested = sCurrentFrame.requested.exchange(0),
+            .issued    = sCurrentFrame.issued.exchange(0),
+            .batches   = sCurrentFrame.batches.exchange(0),
+        };
+    }
+
+    BarrierBatch::BarrierBatch(const vk::CommandBuffer& commandBuffer)
+    : mCommandBuffer(commandBuffer)
+    {
+    }
+
+    BarrierBatch::~BarrierBatch()
+    {
+        flush();
+    }
+
+    BarrierBatch& BarrierBatch::transition(const ImageTransitionInfo& transitionInfo)
     {
-        if (transitionInfo.imageTransitionInfos.empty())
+        mRequested++;
+
+        Image*           pImage = transitionInfo.pImage;
+        const ImageState state  = pImage->getState();
+
+        // Same layout, no writes on either side and already visible to the destination: nothing to wait for.
+        if (state.layout == transitionInfo.newLayout
+            && !Barrier::hasWriteAccess(state.accessFlags)
+            && !Barrier::hasWriteAccess(transitionInfo.dstAccessMask)
+            && (state.stageFlags & transitionInfo.dstStageMask) == transitionInfo.dstStageMask
+            && (state.accessFlags & transitionInfo.dstAccessMask) == transitionInfo.dstAccessMask)
         {
-            return;
+            return *this;
         }
 
-        std::vector<vk::ImageMemoryBarrier2> barriers;
-        for (const auto& imageInfo : transitionInfo.imageTransitionInfos)
+        // Reads in the same layout share a barrier, a write on either side has to be ordered after the pending one.
+        const auto pending = std::ranges::find(mImageBarriers, pImage->getImage(), &vk::ImageMemoryBarrier2::image);
+        if (pending != mImageBarriers.end()
+            && pending->newLayout == transitionInfo.newLayout
+            && !Barrier::hasWriteAccess(pending->dstAccessMask)
+            && !Barrier::hasWriteAccess(transitionInfo.dstAccessMask))
         {
-            barriers.push_back(vk::ImageMemoryBarrier2()
-                .setOldLayout(imageInfo.pImage->getState().layout)
-                .setNewLayout(imageInfo.newLayout)
-                .setSrcAccessMask(imageInfo.pImage->getState().accessFlags)
-                .setDstAccessMask(imageInfo.dstAccessMask)
-                .setSrcStageMask(imageInfo.srcStageMask)
-                .setDstStageMask(imageInfo.dstStageMask)
-                .setSubresourceRange(imageInfo.pImage->getProperties().subresourceRange)
-                .setImage(imageInfo.pImage->getImage())
-            );
-
-            imageInfo.pImage->updateState({
-                .accessFlags = imageInfo.dstAccessMask,
-                .layout      = imageInfo.newLayout,
-                .stageFlags  = imageInfo.dstStageMask,
+            pending->dstStageMask  |= transitionInfo.dstStageMask;
+            pending->dstAccessMask |= transitionInfo.dstAccessMask;
+            pImage->updateState({
+                .accessFlags = pending->dstAccessMask,
+                .layout      = pending->newLayout,
+                .stageFlags  = pending->dstStageMask,
             });
+            return *this;
+        }
+
+        // Barriers within one batch are unordered, a second layout change or access has to go into the next batch.
+        if (pending != mImageBarriers.end())
+        {
+            flush();
+        }
+
+        mImageBarriers.push_back(vk::ImageMemoryBarrier2()
+            .setOldLayout(state.layout)
+            .setNewLayout(transitionInfo.newLayout)
+            .setSrcAccessMask(state.accessFlags | transitionInfo.srcAccessMask)
+            .setDstAccessMask(transitionInfo.dstAccessMask)
+            .setSrcStageMask(state.stageFlags | transitionInfo.srcStageMask)
+            .setDstStageMask(transitionInfo.dstStageMask)
+            .setSubresourceRange(pImage->getProperties().subresourceRange)
+            .setImage(pImage->getImage()));
+
+        pImage->updateState({
+            .accessFlags = transitionInfo.dstAccessMask,
+            .layout      = transitionInfo.newLayout,
+            .stageFlags  = transitionInfo.dstStageMask,
+        });
+
+        return *this;
+    }
+
+    BarrierBatch& BarrierBatch::transition(const BufferTransitionInfo& transitionInfo)
+    {
+        mRequested++;
+
+        Buffer*           pBuffer = transitionInfo.pBuffer;
+        const BufferState state   = pBuffer->getState();
+
+        // A read already covered by the last barrier.
+        if (!Barrier::hasWriteAccess(state.accessFlags)
+            && !Barrier::hasWriteAccess(transitionInfo.dstAccessMask)
+            && (state.stageFlags & transitionInfo.dstStageMask) == transitionInfo.dstStageMask
+            && (state.accessFlags & transitionInfo.dstAccessMask) == transitionInfo.dstAccessMask)
+        {
+            return *this;
+        }
+
+        // Reads share a barrier, a write on either side has to be ordered after the pending one.
+        const auto pending = std::ranges::find(mBufferBarriers, pBuffer->getHandle(), &vk::BufferMemoryBarrier2::buffer);
+        if (pending != mBufferBarriers.end()
+            && !Barrier::hasWriteAccess(pending->dstAccessMask)
+            && !Barrier::hasWriteAccess(transitionInfo.dstAccessMask))
+        {
+            pending->dstStageMask  |= transitionInfo.dstStageMask;
+            pending->dstAccessMask |= transitionInfo.dstAccessMask;
+            pBuffer->updateState({ .accessFlags = pending->dstAccessMask, .stageFlags = pending->dstStageMask });
+            return *this;
+        }
+
+        // Barriers within one batch are unordered.
+        if (pending != mBufferBarriers.end())
+        {
+            flush();
+        }
+
+        // Never used by the device (new or host written): nothing to wait for, the barrier starts the dependency chain.
+        const bool unused = state.stageFlags == vk::PipelineStageFlagBits2::eNone;
+
+        mBufferBarriers.push_back(vk::BufferMemoryBarrier2()
+            .setSrcAccessMask(unused ? vk::AccessFlagBits2::eNone : state.accessFlags)
+            .setDstAccessMask(transitionInfo.dstAccessMask)
+            .setSrcStageMask(unused ? vk::PipelineStageFlagBits2::eTopOfPipe : state.stageFlags)
+            .setDstStageMask(transitionInfo.dstStageMask)
+            .setBuffer(pBuffer->getHandle())
+            .setOffset(0)
+            .setSize(vk::WholeSize));
+
+        pBuffer->updateState({ .accessFlags = transitionInfo.dstAccessMask, .stageFlags = transitionInfo.dstStageMask });
+
+        return *this;
+    }
+
+    void BarrierBatch::flush()
+    {
+        const auto issued = static_cast<uint32_t>(mImageBarriers.size() + mBufferBarriers.size());
+        Barrier::recordStatistics(mRequested, issued, issued > 0 ? 1 : 0);
+        mRequested = 0;
+
+        if (issued == 0)
+        {
+            return;
         }
 
         const auto dependencyInfo = vk::DependencyInfo()
-            .setImageMemoryBarrierCount(barriers.size())
-            .setPImageMemoryBarriers(barriers.data());
+            .setImageMemoryBarriers(mImageBarriers)
+            .setBufferMemoryBarriers(mBufferBarriers);
+
+        mCommandBuffer.pipelineBarrier2(dependencyInfo);
 
-        transitionInfo.commandBuffer.pipelineBarrier2(&dependencyInfo);
+        mImageBarriers.clear();
+        mBufferBarriers.clear();
     }
 }
@@ -0,0 +1,250 @@
+#include "BindlessTable.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "Buffer.hpp"
+#include "Device.hpp"
+#include "Image.hpp"
+
+namespace nbl
+{
+    std::string toString(const BindlessResourceType resourceType) noexcept
+    {
+        switch (resourceType)
+        {
+            case BindlessResourceType::StorageBuffer:   return "StorageBuffer";
+            case BindlessResourceType::SampledImage:    return "SampledImage";
+            case BindlessResourceType::StorageImage:    return "StorageImage";
+            default:                                    return "Unknown";
+        }
+    }
+
+    static constexpr std::array gBindlessDescriptorTypes = {
+        vk::DescriptorType::eStorageBuffer,
+        vk::DescriptorType::eCombinedImageSampler,
+        vk::DescriptorType::eStorageImage,
+    };
+
+    BindlessTable::BindlessTable(const BindlessTableCreateInfo& createInfo)
+    : mDebugName(createInfo.debugName)
+    , mDevice(createInfo.pDevice)
+    {
+        // Clamp to the update-after-bind limits of the device.
+        const auto properties = mDevice->getPhysicalDevice().getProperties2<
+            vk::PhysicalDeviceProperties2,
+            vk::PhysicalDeviceVulkan12Properties>();
+        const auto& limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+        // Bindings are visible to every stage, so the per-stage limits apply as well.
+        // Combined image samplers count as both a sampled image and a sampler.
+        mSlots[0].capacity = std::min({
+            createInfo.maxStorageBuffers,
+            limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+            limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+        });
+        mSlots[1].capacity = std::min({
+            createInfo.maxSampledImages,
+            limits.maxDescriptorSetUpdateAfterBindSampledImages,
+            limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            limits.maxDescriptorSetUpdateAfterBindSamplers,
+            limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+        });
+        mSlots[2].capacity = !mDevice->getCapabilities().bindlessStorageImages ? 0 : std::min({
+            createInfo.maxStorageImages,
+            limits.maxDescriptorSetUpdateAfterBindStorageImages,
+            limits.maxPerStageDescriptorUpdateAfterBindStorageImages,
+        });
+
+        // All three share maxPerStageUpdateAfterBindResources, shrink them proportionally.
+        uint64_t totalCapacity = 0;
+        for (const Slots& slots : mSlots)
+        {
+            totalCapacity += slots.capacity;
+        }
+        if (totalCapacity > limits.maxPerStageUpdateAfterBindResources)
+        {
+            for (Slots& slots : mSlots)
+            {
+                slots.capacity = static_cast<uint32_t>(slots.capacity * static_cast<uint64_t>(limits.maxPerStageUpdateAfterBindResources) / totalCapacity);
+            }
+        }
+
+        #pragma region "Layout"
+        std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        std::vector<vk::DescriptorBindingFlags>     bindingFlags;
+        std::vector<vk::DescriptorPoolSize>         poolSizes;
+
+        for (uint32_t i = 0; i < gBindlessResourceTypeCount; i++)
+        {
+            // Unsupported types (storage images without non-uniform indexing) have no binding.
+            if (mSlots[i].capacity == 0)
+            {
+                continue;
+            }
+
+            bindings.push_back(vk::DescriptorSetLayoutBinding()
+                .setBinding(i)
+                .setDescriptorType(gBindlessDescriptorTypes[i])
+                .setDescriptorCount(mSlots[i].capacity)
+                .setStageFlags(vk::ShaderStageFlagBits::eAll));
+
+            bindingFlags.push_back(vk::DescriptorBindingFlagBits::eUpdateAfterBind
+                | vk::DescriptorBindingFlagBits::ePartiallyBound
+                | vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending);
+
+            poolSizes.push_back(vk::DescriptorPoolSize()
+                .setType(gBindlessDescriptorTypes[i])
+                .setDescriptorCount(mSlots[i].capacity));
+        }
+
+        auto bindingFlagsInfo = vk::DescriptorSetLayoutBindingFlagsCreateInfo()
+            .setBindingFlags(bindingFlags);
+
+        const auto layoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+            .setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool)
+            .setBindings(bindings)
+            .setPNext(&bindingFlagsInfo);
+
+        nbl_VK_TRY(mLayout = mDevice->getHandle().createDescriptorSetLayout(layoutCreateInfo);)
+
+        mDevice->nameObject<vk::DescriptorSetLayout>({
+            .debugName = fmt::format("{} Layout", mDebugName),
+            .handle = mLayout,
+        });
+        #pragma endregion
+
+        #pragma region "Pool & Set"
+        const auto poolCreateInfo = vk::DescriptorPoolCreateInfo()
+            .setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind)
+            .setMaxSets(1)
+            .setPoolSizes(poolSizes);
+
+        nbl_VK_TRY(mDescriptorPool = mDevice->getHandle().createDescriptorPool(poolCreateInfo);)
+
+        mDevice->nameObject<vk::DescriptorPool>({
+            .debugName = fmt::format("{} Pool", mDebugName),
+            .handle = mDescriptorPool,
+        });
+
+        const auto allocateInfo = vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(mDescriptorPool)
+            .setDescriptorSetCount(1)
+            .setPSetLayouts(&mLayout);
+
+        nbl_VK_RESULT(mDevice->getHandle().allocateDescriptorSets(&allocateInfo, &mDescriptorSet));
+
+        mDevice->nameObject<vk::DescriptorSet>({
+            .debugName = fmt::format("{} Set", mDebugName),
+            .handle    = mDescriptorSet,
+        });
+        #pragma endregion
+    }
+
+    BindlessTable::~BindlessTable()
+    {
+        mDevice->getHandle().destroy(mDescriptorPool);
+        mDevice->getHandle().destroy(mLayout);
+    }
+
+    BindlessHandle BindlessTable::registerStorageBuffer(const Buffer* pBuffer)
+    {
+        constexpr auto type = BindlessResourceType::StorageBuffer;
+        const auto bufferInfo = vk::DescriptorBufferInfo(pBuffer->getHandle(), 0, vk::WholeSize);
+
+        std::lock_guard lock(mMutex);
+        const BindlessHandle handle = { type, acquire(type) };
+        writeDescriptor(type, handle.index, &bufferInfo, nullptr);
+        return handle;
+    }
+
+    BindlessHandle BindlessTable::registerSampledImage(const Image* pImage)
+    {
+        constexpr auto type = BindlessResourceType::SampledImage;
+        const auto imageInfo = vk::DescriptorImageInfo()
+            .setSampler(pImage->getSampler())
+            .setImageView(pImage->getImageView())
+            .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        std::lock_guard lock(mMutex);
+        const BindlessHandle handle = { type, acquire(type) };
+        writeDescriptor(type, handle.index, nullptr, &imageInfo);
+        return handle;
+    }
+
+    BindlessHandle BindlessTable::registerStorageImage(const Image* pImage)
+    {
+        constexpr auto type = BindlessResourceType::StorageImage;
+        const auto imageInfo = vk::DescriptorImageInfo()
+            .setImageView(pImage->getImageView())
+            .setImageLayout(vk::ImageLayout::eGeneral);
+
+        std::lock_guard lock(mMutex);
+        const BindlessHandle handle = { type, acquire(type) };
+        writeDescriptor(type, handle.index, nullptr, &imageInfo);
+        return handle;
+    }
+
+    void BindlessTable::release(const BindlessHandle& handle)
+    {
+        if (!handle.isValid())
+        {
+            return;
+        }
+
+        // Frames in flight may still index the descriptor, the slot is only rewritten after they completed.
+        mDevice->getDeletionQueue()->push([this, handle]() {
+            std::lock_guard lock(mMutex);
+            mSlots[static_cast<uint32_t>(handle.type)].freeList.push_back(handle.index);
+        });
+    }
+
+    uint32_t BindlessTable::getUsedCount(const BindlessResourceType type) const
+    {
+        std::lock_guard lock(mMutex);
+        const Slots& slots = mSlots[static_cast<uint32_t>(type)];
+        return slots.next - static_cast<uint32_t>(slots.freeList.size());
+    }
+
+    uint32_t BindlessTable::acquire(const BindlessResourceType type)
+    {
+        Slots& slots = mSlots[static_cast<uint32_t>(type)];
+
+        if (!slots.freeList.empty())
+        {
+            const uint32_t index = slots.freeList.back();
+            slots.freeList.pop_back();
+            return index;
+        }
+
+        if (slots.capacity == 0)
+        {
+            throw RHIError(fmt::format("BindlessTable {}: {} is not supported by the device", mDebugName, toString(type)));
+        }
+
+        if (slots.next >= slots.capacity)
+        {
+            throw RHIError(fmt::format("BindlessTable {}: Out of {} slots ({})", mDebugName, toString(type), slots.capacity));
+        }
+
+        return slots.next++;
+    }
+
+    void BindlessTable::writeDescriptor(
+        const BindlessResourceType      type,
+        const uint32_t                  index,
+        const vk::DescriptorBufferInfo* pBufferInfo,
+        const vk::DescriptorImageInfo*  pImageInfo) const
+    {
+        const auto binding = static_cast<uint32_t>(type);
+        const auto write = vk::WriteDescriptorSet()
+            .setDstSet(mDescriptorSet)
+            .setDstBinding(binding)
+            .setDstArrayElement(index)
+            .setDescriptorCount(1)
+            .setDescriptorType(gBindlessDescriptorTypes[binding])
+            .setPBufferInfo(pBufferInfo)
+            .setPImageInfo(pImageInfo);
+
+        mDevice->getHandle().updateDescriptorSets(1, &write, 0, nullptr);
+    }
+}
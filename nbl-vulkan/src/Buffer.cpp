@@ -17,9 +17,21 @@ namespace nbl
             case BufferType::AccelerationStructure: return "AccelerationStructure";
             case BufferType::ShaderBindingTable:    return "ShaderBindingTable";
             case BufferType::Staging:               return "Staging";
+            case BufferType::Descriptor:            return "Descriptor";
+            case BufferType::Readback:              return "Readback";
             default:                                return "Unknown";
         }
     }
+
+    std::string toString(const UploadPath uploadPath) noexcept
+    {
+        switch (uploadPath)
+        {
+            case UploadPath::Direct:  return "Direct";
+            case UploadPath::Staging: return "Staging";
+            default:                  return "Unknown";
+        }
+    }
     
     Buffer::Buffer(const BufferCreateInfo& createInfo)
     : mCreateSize(createInfo.size)
@@ -27,15 +39,24 @@ namespace nbl
     , mName(createInfo.debugName)
     , mDevice(createInfo.pDevice)
     {
+        vk::BufferUsageFlags usageFlags = getUsageFlags(mBufferType);
+        if (!mDevice->getCapabilities().accelerationStructure)
+        {
+            // Ray Tracing is an optional capability tier, its usage flags are invalid without the extensions.
+            usageFlags &= ~(vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR
+                | vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR
+                | vk::BufferUsageFlagBits::eShaderBindingTableKHR);
+        }
+
         auto bufferInfo = vk::BufferCreateInfo()
             .setSize(createInfo.size)
-            .setUsage(getUsageFlags(mBufferType));
+            .setUsage(usageFlags);
     
         VmaAllocationCreateInfo allocInfo = {};
         allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-        allocInfo.flags = getMemoryFlags(mBufferType);
+        allocInfo.flags = getMemoryFlags(mBufferType, createInfo.hostAccess);
     
-        if (mBufferType == BufferType::Staging)
+        if (mBufferType == BufferType::Staging || mBufferType == BufferType::Readback)
         {
             allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
         }
@@ -46,6 +67,12 @@ namespace nbl
             vmaCreateBuffer(mDevice->getAllocator(), pBufferInfo, &allocInfo,
                 pBuffer, &mAllocation, &mAllocationInfo)
         );
+
+        VkMemoryPropertyFlags memoryFlags = 0;
+        vmaGetAllocationMemoryProperties(mDevice->getAllocator(), mAllocation, &memoryFlags);
+        mMemoryFlags = vk::MemoryPropertyFlags(memoryFlags);
+
+        mDevice->getMemoryTracker()->onAllocate(mAllocation, toString(mBufferType), mName);
     
         mDevice->nameObject<vk::Buffer>({
             .debugName = mName,
@@ -59,7 +86,10 @@ namespace nbl
     
     Buffer::~Buffer()
     {
-        vmaDestroyBuffer(mDevice->getAllocator(), mBuffer, mAllocation);
+        mDevice->getDeletionQueue()->push([pDevice = mDevice, buffer = mBuffer, allocation = mAllocation]() {
+            pDevice->getMemoryTracker()->onFree(allocation);
+            vmaDestroyBuffer(pDevice->getAllocator(), buffer, allocation);
+        });
     }
     
     void Buffer::setData(const void* pData, const uint64_t size, const uint64_t offset) const
@@ -74,6 +104,21 @@ namespace nbl
             vmaCopyAllocationToMemory(mDevice->getAllocator(), mAllocation, offset, pData, size));
     }
     
+    std::span<std::byte> Buffer::map() const
+    {
+        if (!isMapped())
+        {
+            return {};
+        }
+        return { static_cast<std::byte*>(mAllocationInfo.pMappedData), mCreateSize };
+    }
+
+    void Buffer::flush(const uint64_t offset, const uint64_t size) const
+    {
+        nbl_VK_C_RESULT(
+            vmaFlushAllocation(mDevice->getAllocator(), mAllocation, offset, size));
+    }
+
     void Buffer::copy(const BufferCopyInfo& copyInfo) const
     {
         const auto copyRegion = vk::BufferCopy()
@@ -116,7 +161,8 @@ namespace nbl
                 break;
             }
             case BufferType::Indirect:{
-                result |= eIndirectBuffer;
+                // Indirect arguments are commonly written by compute passes.
+                result |= eIndirectBuffer | eStorageBuffer;
                 break;
             }
             case BufferType::Storage: {
@@ -135,7 +181,12 @@ namespace nbl
                 result |= eShaderBindingTableKHR;
                 break;
             }
-            case BufferType::Staging: {
+            case BufferType::Staging:
+            case BufferType::Readback: {
+                break;
+            }
+            case BufferType::Descriptor: {
+                result |= eResourceDescriptorBufferEXT | eSamplerDescriptorBufferEXT;
                 break;
             }
         }
@@ -143,10 +194,26 @@ namespace nbl
         return result;
     }
     
-    int32_t Buffer::getMemoryFlags(const BufferType bufferType)
+    int32_t Buffer::getMemoryFlags(const BufferType bufferType, const bool hostAccess)
     {
+        // Device-local types stay device-local, VMA maps them only if such memory is host-visible (ReBAR / UMA).
+        if (hostAccess && bufferType != BufferType::Descriptor && bufferType != BufferType::Readback)
+        {
+            return VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                   | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT
+                   | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        }
+
         switch (bufferType)
         {
+            case BufferType::Descriptor:
+                // Descriptors are written by the host and must always be mapped.
+                return VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                       | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            case BufferType::Readback:
+                // Random host reads of device writes, cached memory avoids uncached reads over PCIe.
+                return VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT
+                       | VMA_ALLOCATION_CREATE_MAPPED_BIT;
             case BufferType::Uniform:
             case BufferType::Staging:
                 return VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
@@ -0,0 +1,234 @@
+#include "BufferArena.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <fmt/format.h>
+#include "Device.hpp"
+
+namespace nbl
+{
+    // ================================
+    // BufferSlice
+    // ================================
+    #pragma region "BufferSlice"
+
+    BufferSlice::BufferSlice(
+        BufferArena*               pArena,
+        Buffer*                    pBuffer,
+        const uint32_t             blockIndex,
+        const VmaVirtualAllocation allocation,
+        const uint64_t             offset,
+        const uint64_t             size,
+        std::string                name)
+    : mArena(pArena)
+    , mBuffer(pBuffer)
+    , mBlockIndex(blockIndex)
+    , mAllocation(allocation)
+    , mOffset(offset)
+    , mSize(size)
+    , mName(std::move(name))
+    {
+    }
+
+    BufferSlice::~BufferSlice()
+    {
+        mArena->release(mBlockIndex, mAllocation);
+    }
+
+    void BufferSlice::setData(const void* pData, const uint64_t size, const uint64_t offset) const
+    {
+        mBuffer->setData(pData, size, mOffset + offset);
+    }
+
+    void BufferSlice::readBack(void* pData, const uint64_t size, const uint64_t offset) const
+    {
+        mBuffer->readBack(pData, size, mOffset + offset);
+    }
+
+    void BufferSlice::copyFrom(
+        const Buffer*            pSrcBuffer,
+        const vk::CommandBuffer& commandBuffer,
+        const uint64_t           size,
+        const uint64_t           srcOffset,
+        const uint64_t           dstOffset) const
+    {
+        pSrcBuffer->copy({
+            .pDstBuffer    = mBuffer,
+            .size          = size,
+            .srcOffset     = srcOffset,
+            .dstOffset     = mOffset + dstOffset,
+            .commandBuffer = commandBuffer,
+        });
+    }
+
+    #pragma endregion
+
+    // ================================
+    // BufferArena
+    // ================================
+    #pragma region "BufferArena"
+
+    BufferArena::BufferArena(const BufferArenaCreateInfo& createInfo)
+    : mBlockSize(createInfo.blockSize)
+    , mType(createInfo.type)
+    , mName(createInfo.debugName)
+    , mHostAccess(createInfo.hostAccess)
+    , mDevice(createInfo.pDevice)
+    {
+        mBlocks = std::make_shared<Blocks>();
+
+        const auto& limits = mDevice->getProperties().limits;
+        mMinAlignment = std::max({
+            mMinAlignment,
+            limits.minStorageBufferOffsetAlignment,
+            limits.minUniformBufferOffsetAlignment,
+        });
+    }
+
+    BufferArena::~BufferArena()
+    {
+        // Slices must not outlive the arena, pending frees keep the blocks alive until they ran.
+        mBlocks.reset();
+    }
+
+    BufferArena::Blocks::~Blocks()
+    {
+        // Leaked allocations are released with the block.
+        for (auto& block : blocks)
+        {
+            if (!block.virtualBlock) continue;
+
+            vmaClearVirtualBlock(block.virtualBlock);
+            vmaDestroyVirtualBlock(block.virtualBlock);
+        }
+    }
+
+    std::unique_ptr<BufferSlice> BufferArena::allocate(const BufferSliceCreateInfo& createInfo)
+    {
+        VmaVirtualAllocationCreateInfo allocInfo = {};
+        allocInfo.size      = createInfo.size;
+        allocInfo.alignment = std::max(createInfo.alignment, mMinAlignment);
+
+        std::lock_guard lock(mBlocks->mutex);
+        auto& blocks = mBlocks->blocks;
+
+        VmaVirtualAllocation allocation = VK_NULL_HANDLE;
+        VkDeviceSize         offset     = 0;
+        auto                 blockIndex = static_cast<uint32_t>(blocks.size());
+
+        // Dedicated blocks only ever hold the slice they were created for.
+        if (createInfo.size <= mBlockSize)
+        {
+            for (uint32_t i = 0; i < blocks.size(); i++)
+            {
+                if (!blocks[i].virtualBlock || blocks[i].dedicated) continue;
+
+                if (vmaVirtualAllocate(blocks[i].virtualBlock, &allocInfo, &allocation, &offset) == VK_SUCCESS)
+                {
+                    blockIndex = i;
+                    break;
+                }
+            }
+        }
+
+        if (blockIndex == blocks.size())
+        {
+            const bool dedicated = createInfo.size > mBlockSize;
+            blockIndex = createBlock(dedicated ? createInfo.size : mBlockSize, dedicated);
+            nbl_VK_C_RESULT(
+                vmaVirtualAllocate(blocks[blockIndex].virtualBlock, &allocInfo, &allocation, &offset));
+        }
+
+        return std::make_unique<BufferSlice>(
+            this, blocks[blockIndex].buffer.get(), blockIndex,
+            allocation, offset, createInfo.size, createInfo.debugName);
+    }
+
+    BufferArenaStatistics BufferArena::getStatistics() const
+    {
+        std::lock_guard lock(mBlocks->mutex);
+
+        BufferArenaStatistics result = {};
+        for (const auto& block : mBlocks->blocks)
+        {
+            if (!block.virtualBlock) continue;
+
+            result.blockCount++;
+
+            VmaDetailedStatistics stats = {};
+            vmaCalculateVirtualBlockStatistics(block.virtualBlock, &stats);
+            result.allocationCount  += stats.statistics.allocationCount;
+            result.allocatedBytes   += stats.statistics.allocationBytes;
+            result.totalBytes       += stats.statistics.blockBytes;
+            if (stats.unusedRangeCount > 0)
+            {
+                result.largestFreeRange = std::max(result.largestFreeRange, stats.unusedRangeSizeMax);
+            }
+        }
+        return result;
+    }
+
+    void BufferArena::release(const uint32_t blockIndex, const VmaVirtualAllocation allocation) const
+    {
+        // In-flight frames may still read the range, it is only handed out again after they completed.
+        mDevice->getDeletionQueue()->push([blocks = mBlocks, blockIndex, allocation]() {
+            free(*blocks, blockIndex, allocation);
+        });
+    }
+
+    void BufferArena::free(Blocks& blocks, const uint32_t blockIndex, const VmaVirtualAllocation allocation)
+    {
+        std::unique_ptr<Buffer> releasedBuffer;
+        {
+            std::lock_guard lock(blocks.mutex);
+
+            Block& block = blocks.blocks[blockIndex];
+            vmaVirtualFree(block.virtualBlock, allocation);
+
+            if (block.dedicated && vmaIsVirtualBlockEmpty(block.virtualBlock))
+            {
+                vmaDestroyVirtualBlock(block.virtualBlock);
+                releasedBuffer = std::move(block.buffer);
+                block = {};
+            }
+        }
+
+        // Outside the lock, the Buffer defers its own handles to the DeletionQueue.
+        releasedBuffer.reset();
+    }
+
+    uint32_t BufferArena::createBlock(const uint64_t size, const bool dedicated)
+    {
+        auto& blocks = mBlocks->blocks;
+
+        // Slots of released dedicated blocks are reused, live slices keep their block index.
+        const auto freeSlot = std::ranges::find(blocks, VmaVirtualBlock(VK_NULL_HANDLE), &Block::virtualBlock);
+        const auto index    = static_cast<uint32_t>(std::distance(blocks.begin(), freeSlot));
+
+        Block block = {};
+        block.dedicated = dedicated;
+        block.buffer    = Buffer::createBuffer({
+            .size       = size,
+            .type       = mType,
+            .pDevice    = mDevice,
+            .debugName  = fmt::format("{} ({} {})", mName, dedicated ? "Dedicated Block" : "Block", index),
+            .hostAccess = mHostAccess,
+        });
+
+        VmaVirtualBlockCreateInfo blockInfo = {};
+        blockInfo.size = size;
+        nbl_VK_C_RESULT(vmaCreateVirtualBlock(&blockInfo, &block.virtualBlock));
+
+        if (freeSlot == blocks.end())
+        {
+            blocks.push_back(std::move(block));
+        }
+        else
+        {
+            *freeSlot = std::move(block);
+        }
+        return index;
+    }
+
+    #pragma endregion
+}
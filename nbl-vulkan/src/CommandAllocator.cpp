@@ -0,0 +1,88 @@
+#include "CommandAllocator.hpp"
+
+#include <stdexcept>
+#include <fmt/format.h>
+#include "Device.hpp"
+
+namespace nbl
+{
+    CommandAllocator::CommandAllocator(const CommandAllocatorCreateInfo& createInfo)
+    : mFrameCount(createInfo.frameCount)
+    , mThreadCount(createInfo.threadCount)
+    , mDevice(createInfo.pDevice)
+    , mDebugName(createInfo.debugName)
+    {
+        // Transient without eResetCommandBuffer: buffers are only reset together with their pool.
+        const auto poolCreateInfo = vk::CommandPoolCreateInfo()
+            .setQueueFamilyIndex(createInfo.pQueue->familyIndex)
+            .setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+
+        mPools.resize(mFrameCount * mThreadCount);
+        for (uint32_t frame = 0; frame < mFrameCount; frame++)
+        {
+            for (uint32_t thread = 0; thread < mThreadCount; thread++)
+            {
+                auto& pool = getPool(frame, thread);
+                nbl_VK_TRY(pool.pool = mDevice->getHandle().createCommandPool(poolCreateInfo);)
+
+                mDevice->nameObject<vk::CommandPool>({
+                    .debugName = fmt::format("{} Pool [Frame {}, Thread {}]", mDebugName, frame, thread),
+                    .handle    = pool.pool,
+                });
+            }
+        }
+    }
+
+    CommandAllocator::~CommandAllocator()
+    {
+        for (const auto& pool : mPools)
+        {
+            // Destroying the pool frees its command buffers.
+            mDevice->getHandle().destroyCommandPool(pool.pool);
+        }
+    }
+
+    void CommandAllocator::beginFrame(const uint32_t frameIndex)
+    {
+        mCurrentFrame = frameIndex % mFrameCount;
+        for (uint32_t thread = 0; thread < mThreadCount; thread++)
+        {
+            auto& pool = getPool(mCurrentFrame, thread);
+            mDevice->getHandle().resetCommandPool(pool.pool);
+            pool.used[0] = 0;
+            pool.used[1] = 0;
+        }
+    }
+
+    vk::CommandBuffer CommandAllocator::allocate(const uint32_t threadIndex, const vk::CommandBufferLevel level)
+    {
+        if (threadIndex >= mThreadCount)
+        {
+            throw std::out_of_range(std::to_string(threadIndex));
+        }
+
+        auto&          pool     = getPool(mCurrentFrame, threadIndex);
+        const uint32_t levelIdx = level == vk::CommandBufferLevel::ePrimary ? 0 : 1;
+        auto&          buffers  = pool.commandBuffers[levelIdx];
+
+        if (pool.used[levelIdx] == buffers.size())
+        {
+            const auto allocateInfo = vk::CommandBufferAllocateInfo()
+                .setCommandPool(pool.pool)
+                .setLevel(level)
+                .setCommandBufferCount(1);
+
+            vk::CommandBuffer commandBuffer;
+            nbl_VK_RESULT(mDevice->getHandle().allocateCommandBuffers(&allocateInfo, &commandBuffer));
+
+            mDevice->nameObject<vk::CommandBuffer>({
+                .debugName = fmt::format("{} {} [Frame {}, Thread {}] {}", mDebugName,
+                    levelIdx == 0 ? "Primary" : "Secondary", mCurrentFrame, threadIndex, buffers.size()),
+                .handle    = commandBuffer,
+            });
+            buffers.push_back(commandBuffer);
+        }
+
+        return buffers[pool.used[levelIdx]++];
+    }
+}
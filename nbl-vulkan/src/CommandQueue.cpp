@@ -1,5 +1,6 @@
 #include "CommandQueue.hpp"
 
+#include <limits>
 #include <ranges>
 #include <stdexcept>
 #include <fmt/format.h>
@@ -26,6 +27,31 @@ namespace nbl
         mIsRecording = true;
     }
     
+    void CommandList::beginSecondary(const vk::CommandBufferInheritanceRenderingInfo* pRenderingInfo)
+    {
+        if (mIsRecording)
+        {
+            fmt::println("CommandList is already in recording state.");
+            return;
+        }
+
+        const auto inheritanceInfo = vk::CommandBufferInheritanceInfo()
+            .setPNext(pRenderingInfo);
+
+        auto flags = vk::CommandBufferUsageFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+        if (pRenderingInfo)
+        {
+            flags |= vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+        }
+
+        const auto beginInfo = vk::CommandBufferBeginInfo()
+            .setFlags(flags)
+            .setPInheritanceInfo(&inheritanceInfo);
+
+        nbl_VK_RESULT(mCommandBuffer.begin(&beginInfo));
+        mIsRecording = true;
+    }
+
     void CommandList::end()
     {
         if (!mIsRecording)
@@ -69,11 +95,26 @@ namespace nbl
                 .commandBuffer = commandBuffer
             }));
         }
+
+        auto semaphoreTypeInfo = vk::SemaphoreTypeCreateInfo()
+            .setSemaphoreType(vk::SemaphoreType::eTimeline)
+            .setInitialValue(0);
+
+        const auto semaphoreCreateInfo = vk::SemaphoreCreateInfo()
+            .setPNext(&semaphoreTypeInfo);
+
+        nbl_VK_TRY(mTimeline = mDevice->getHandle().createSemaphore(semaphoreCreateInfo);)
+
+        mDevice->nameObject<vk::Semaphore>({
+            .debugName = fmt::format("{} Timeline", mQueue->name),
+            .handle = mTimeline,
+        });
     }
     
     CommandQueue::~CommandQueue()
     {
-        mDevice->waitIdle();
+        wait(getSubmittedValue());
+        mDevice->getHandle().destroy(mTimeline);
         mCommandLists.clear();
         mDevice->getHandle().freeCommandBuffers(mPool, mCommandBuffers.size(), mCommandBuffers.data());
         mDevice->getHandle().destroyCommandPool(mPool);
@@ -108,12 +149,64 @@ namespace nbl
         lambda(commandBuffer);
         commandBuffer.end();
     
-        const auto submitInfo = vk::SubmitInfo()
-            .setCommandBufferCount(1)
-            .setPCommandBuffers(&commandBuffer);
-        nbl_VK_RESULT(mQueue->queue.submit(1, &submitInfo, nullptr));
-    
-        mQueue->queue.waitIdle();
+        wait(submit({ .commandBuffers = { commandBuffer } }));
         mDevice->getHandle().freeCommandBuffers(mPool, 1, &commandBuffer);
     }
+
+    uint64_t CommandQueue::submit(const QueueSubmitInfo& submitInfo) const
+    {
+        std::vector<vk::CommandBufferSubmitInfo> commandBufferInfos;
+        for (const auto& commandBuffer : submitInfo.commandBuffers)
+        {
+            commandBufferInfos.push_back(vk::CommandBufferSubmitInfo().setCommandBuffer(commandBuffer));
+        }
+
+        std::vector<vk::SemaphoreSubmitInfo> waitInfos = submitInfo.binaryWaits;
+        for (const auto& queueWait : submitInfo.queueWaits)
+        {
+            waitInfos.push_back(vk::SemaphoreSubmitInfo()
+                .setSemaphore(queueWait.pQueue->getTimeline())
+                .setValue(queueWait.value)
+                .setStageMask(queueWait.stageMask));
+        }
+
+        std::lock_guard lock(mSubmitMutex);
+
+        const uint64_t signalValue = mSubmittedValue + 1;
+        std::vector<vk::SemaphoreSubmitInfo> signalInfos = submitInfo.binarySignals;
+        signalInfos.push_back(vk::SemaphoreSubmitInfo()
+            .setSemaphore(mTimeline)
+            .setValue(signalValue)
+            .setStageMask(vk::PipelineStageFlagBits2::eAllCommands));
+
+        const auto vkSubmitInfo = vk::SubmitInfo2()
+            .setCommandBufferInfos(commandBufferInfos)
+            .setWaitSemaphoreInfos(waitInfos)
+            .setSignalSemaphoreInfos(signalInfos);
+
+        nbl_VK_RESULT(mQueue->queue.submit2(1, &vkSubmitInfo, nullptr));
+
+        mSubmittedValue = signalValue;
+        return signalValue;
+    }
+
+    void CommandQueue::wait(const uint64_t value) const
+    {
+        const auto waitInfo = vk::SemaphoreWaitInfo()
+            .setSemaphores(mTimeline)
+            .setValues(value);
+
+        nbl_VK_RESULT(mDevice->getHandle().waitSemaphores(&waitInfo, std::numeric_limits<uint64_t>::max()));
+    }
+
+    uint64_t CommandQueue::getCompletedValue() const
+    {
+        return mDevice->getHandle().getSemaphoreCounterValue(mTimeline);
+    }
+
+    uint64_t CommandQueue::getSubmittedValue() const
+    {
+        std::lock_guard lock(mSubmitMutex);
+        return mSubmittedValue;
+    }
 }
@@ -0,0 +1,56 @@
+#include "DeletionQueue.hpp"
+
+#include <vector>
+
+namespace nbl
+{
+    DeletionQueue::~DeletionQueue()
+    {
+        flush();
+    }
+
+    void DeletionQueue::push(std::function<void()> deleter)
+    {
+        std::lock_guard lock(mMutex);
+        mEntries.push_back({ .submission = mCurrentSubmission, .deleter = std::move(deleter) });
+    }
+
+    uint64_t DeletionQueue::nextSubmission()
+    {
+        std::lock_guard lock(mMutex);
+        return mCurrentSubmission++;
+    }
+
+    void DeletionQueue::collect(const uint64_t completedValue)
+    {
+        // Deleters run outside the lock, they may destroy objects that defer their own handles.
+        std::vector<std::function<void()>> ready;
+        {
+            std::lock_guard lock(mMutex);
+            while (!mEntries.empty() && mEntries.front().submission <= completedValue)
+            {
+                ready.push_back(std::move(mEntries.front().deleter));
+                mEntries.pop_front();
+            }
+        }
+
+        for (const auto& deleter : ready)
+        {
+            deleter();
+        }
+    }
+
+    void DeletionQueue::flush()
+    {
+        while (getPendingCount() > 0)
+        {
+            collect(UINT64_MAX);
+        }
+    }
+
+    size_t DeletionQueue::getPendingCount() const
+    {
+        std::lock_guard lock(mMutex);
+        return mEntries.size();
+    }
+}
@@ -1,21 +1,62 @@
 #include "Descriptor.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <ranges>
 #include <stdexcept>
 #include <fmt/format.h>
+#include "Buffer.hpp"
 #include "Device.hpp"
 
 namespace nbl
 {
+    std::string toString(const DescriptorBackend backend) noexcept
+    {
+        switch (backend)
+        {
+            case DescriptorBackend::Pool:   return "Pool";
+            case DescriptorBackend::Buffer: return "Buffer";
+            default:                        return "Unknown";
+        }
+    }
+
     Descriptor::Descriptor(const DescriptorCreateInfo& createInfo)
     : mBindings(createInfo.bindings)
-    , mSetCount(createInfo.setCount)
+    , mBackend(createInfo.backend)
+    , mPushDescriptor(createInfo.pushDescriptor)
+    , mSetCount(createInfo.pushDescriptor ? 0 : createInfo.setCount)
     , mDebugName(createInfo.debugName)
     , mDevice(createInfo.pDevice)
     {
-        createPool();
-        createLayout();
-        createSets();
+        if (mBackend == DescriptorBackend::Buffer && !mDevice->getCapabilities().descriptorBuffer)
+        {
+            fmt::println("Descriptor {}: VK_EXT_descriptor_buffer is not supported, using the Pool backend.", mDebugName);
+            mBackend = DescriptorBackend::Pool;
+        }
+
+        if (mPushDescriptor && mBackend == DescriptorBackend::Buffer)
+        {
+            fmt::println("Descriptor {}: Push descriptors use the Pool backend.", mDebugName);
+            mBackend = DescriptorBackend::Pool;
+        }
+
+        if (mPushDescriptor)
+        {
+            createLayout();
+        }
+        else if (mBackend == DescriptorBackend::Buffer)
+        {
+            createLayout();
+            createDescriptorBuffer();
+        }
+        else
+        {
+            createPool();
+            createLayout();
+            createSets();
+        }
+
+        createUpdateTemplate();
     
         if (createInfo.initialWriteInfo.has_value())
         {
@@ -26,9 +67,29 @@ namespace nbl
     
     Descriptor::~Descriptor()
     {
-        mDevice->getHandle().freeDescriptorSets(mDescriptorPool, mSetCount, mDescriptorSets.data());
-        mDevice->getHandle().destroy(mDescriptorPool);
-        mDevice->getHandle().destroy(mLayout);
+        std::vector<vk::DescriptorUpdateTemplate> updateTemplates;
+        updateTemplates.append_range(mPushTemplates | std::views::values);
+        if (mUpdateTemplate)
+        {
+            updateTemplates.push_back(mUpdateTemplate);
+        }
+
+        const bool ownsPool = mBackend == DescriptorBackend::Pool && !mPushDescriptor;
+
+        // The descriptor buffer itself is a Buffer and deferred on its own.
+        mDevice->getDeletionQueue()->push([device = mDevice->getHandle(), updateTemplates = std::move(updateTemplates), ownsPool,
+                                           pool = mDescriptorPool, sets = mDescriptorSets, layout = mLayout]() {
+            for (const auto& updateTemplate : updateTemplates)
+            {
+                device.destroy(updateTemplate);
+            }
+            if (ownsPool)
+            {
+                device.freeDescriptorSets(pool, sets.size(), sets.data());
+                device.destroy(pool);
+            }
+            device.destroy(layout);
+        });
     }
     
     void Descriptor::write(DescriptorWriteInfo writeInfo) const
@@ -44,6 +105,12 @@ namespace nbl
             return;
         }
     
+        if (mBackend == DescriptorBackend::Buffer)
+        {
+            writeDescriptorBuffer(writeInfo);
+            return;
+        }
+
         for (auto&& write : writeInfo.writes)
         {
             write.setDstSet(mDescriptorSets[writeInfo.setIndex]);
@@ -55,8 +122,177 @@ namespace nbl
             0, nullptr);
     }
     
+    void Descriptor::updateWithTemplate(const size_t i, const void* pData, const size_t size) const
+    {
+        if (i >= mSetCount)
+        {
+            throw std::out_of_range(std::to_string(i));
+        }
+        validateTemplateData(size);
+
+        if (mBackend == DescriptorBackend::Pool)
+        {
+            mDevice->getHandle().updateDescriptorSetWithTemplate(mDescriptorSets[i], mUpdateTemplate, pData);
+            return;
+        }
+
+        // Descriptor buffers have no template path, unpack the template data into writes.
+        DescriptorWriteInfo writeInfo;
+        writeInfo.setIndex = i;
+        const auto* pBytes = static_cast<const std::byte*>(pData);
+        for (const auto& entry : mTemplateEntries)
+        {
+            auto write = vk::WriteDescriptorSet()
+                .setDstBinding(entry.dstBinding)
+                .setDstArrayElement(entry.dstArrayElement)
+                .setDescriptorCount(entry.descriptorCount)
+                .setDescriptorType(entry.descriptorType);
+
+            const std::byte* pEntry = pBytes + entry.offset;
+            switch (entry.descriptorType)
+            {
+                case vk::DescriptorType::eUniformBuffer:
+                case vk::DescriptorType::eStorageBuffer:
+                    write.setPBufferInfo(reinterpret_cast<const vk::DescriptorBufferInfo*>(pEntry));
+                    break;
+                case vk::DescriptorType::eAccelerationStructureKHR: {
+                    const auto asInfo = vk::WriteDescriptorSetAccelerationStructureKHR()
+                        .setAccelerationStructureCount(entry.descriptorCount)
+                        .setPAccelerationStructures(reinterpret_cast<const vk::AccelerationStructureKHR*>(pEntry));
+                    writeInfo.accelerationStructureInfos.push_back(asInfo);
+                    write.setPNext(&writeInfo.accelerationStructureInfos.back());
+                    break;
+                }
+                default:
+                    write.setPImageInfo(reinterpret_cast<const vk::DescriptorImageInfo*>(pEntry));
+                    break;
+            }
+            writeInfo.writes.push_back(write);
+        }
+
+        writeDescriptorBuffer(writeInfo);
+    }
+
+    void Descriptor::pushWithTemplate(
+        const vk::CommandBuffer&    commandBuffer,
+        const vk::PipelineBindPoint bindPoint,
+        const vk::PipelineLayout&   pipelineLayout,
+        const void*                 pData,
+        const size_t                size,
+        const uint32_t              set) const
+    {
+        if (!mPushDescriptor)
+        {
+            throw RHIError(fmt::format("Descriptor {} was not created with pushDescriptor", mDebugName));
+        }
+        validateTemplateData(size);
+
+        // Push templates are tied to a pipeline layout, they are created on first use.
+        vk::DescriptorUpdateTemplate pushTemplate;
+        {
+            std::lock_guard lock(mPushTemplateMutex);
+            const VkPipelineLayout key = pipelineLayout;
+            if (const auto it = mPushTemplates.find(key); it != mPushTemplates.end())
+            {
+                pushTemplate = it->second;
+            }
+            else
+            {
+                const auto createInfo = vk::DescriptorUpdateTemplateCreateInfo()
+                    .setTemplateType(vk::DescriptorUpdateTemplateType::ePushDescriptors)
+                    .setDescriptorUpdateEntries(mTemplateEntries)
+                    .setPipelineBindPoint(bindPoint)
+                    .setPipelineLayout(pipelineLayout)
+                    .setSet(set);
+
+                nbl_VK_TRY(pushTemplate = mDevice->getHandle().createDescriptorUpdateTemplate(createInfo);)
+
+                mDevice->nameObject<vk::DescriptorUpdateTemplate>({
+                    .debugName = fmt::format("{} Push Template {}", mDebugName, mPushTemplates.size()),
+                    .handle    = pushTemplate,
+                });
+                mPushTemplates.emplace(key, pushTemplate);
+            }
+        }
+
+        commandBuffer.pushDescriptorSetWithTemplate(pushTemplate, pipelineLayout, set, pData);
+    }
+
+    void Descriptor::bind(
+        const vk::CommandBuffer&  commandBuffer,
+        const vk::PipelineBindPoint bindPoint,
+        const vk::PipelineLayout& pipelineLayout,
+        const size_t              i,
+        const uint32_t            firstSet,
+        const uint32_t            bufferIndex) const
+    {
+        if (mPushDescriptor)
+        {
+            throw RHIError(fmt::format("Descriptor {} uses push descriptors, bind it with Descriptor::push", mDebugName));
+        }
+
+        if (mBackend == DescriptorBackend::Pool)
+        {
+            commandBuffer.bindDescriptorSets(bindPoint, pipelineLayout, firstSet, 1, &getSet(i), 0, nullptr);
+            return;
+        }
+
+        if (i >= mSetCount)
+        {
+            throw std::out_of_range(std::to_string(i));
+        }
+
+        // The buffer itself was bound by bindDescriptorBuffers.
+        const vk::DeviceSize offset = mSetStride * i;
+        commandBuffer.setDescriptorBufferOffsetsEXT(bindPoint, pipelineLayout, firstSet, 1, &bufferIndex, &offset);
+    }
+
+    void Descriptor::bindDescriptorBuffers(const vk::CommandBuffer& commandBuffer, const std::span<const Descriptor* const> descriptors)
+    {
+        std::vector<vk::DescriptorBufferBindingInfoEXT> bindingInfos;
+        for (const Descriptor* pDescriptor : descriptors)
+        {
+            if (pDescriptor->mBackend != DescriptorBackend::Buffer)
+            {
+                continue;
+            }
+
+            bindingInfos.push_back(vk::DescriptorBufferBindingInfoEXT()
+                .setAddress(pDescriptor->mDescriptorBuffer->getAddress())
+                .setUsage(vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT | vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT));
+        }
+
+        if (bindingInfos.empty())
+        {
+            return;
+        }
+
+        if (bindingInfos.size() != descriptors.size())
+        {
+            throw RHIError("Pool and Buffer backend Descriptors can not be bound in the same command buffer");
+        }
+
+        if (const uint32_t maxBindings = descriptors.front()->mDescriptorBufferProperties.maxDescriptorBufferBindings;
+            bindingInfos.size() > maxBindings)
+        {
+            throw RHIError(fmt::format("{} descriptor buffers exceed maxDescriptorBufferBindings ({})", bindingInfos.size(), maxBindings));
+        }
+
+        commandBuffer.bindDescriptorBuffersEXT(bindingInfos);
+    }
+
     const vk::DescriptorSet& Descriptor::getSet(const size_t i) const
     {
+        if (mPushDescriptor)
+        {
+            throw RHIError(fmt::format("Descriptor {} uses push descriptors and has no sets", mDebugName));
+        }
+
+        if (mBackend == DescriptorBackend::Buffer)
+        {
+            throw RHIError(fmt::format("Descriptor {} uses descriptor buffers, bind it with Descriptor::bind", mDebugName));
+        }
+
         if (i >= mSetCount)
         {
             throw std::out_of_range(std::to_string(i));
@@ -93,9 +329,18 @@ namespace nbl
     
     void Descriptor::createLayout()
     {
-        const auto createInfo = vk::DescriptorSetLayoutCreateInfo()
+        auto createInfo = vk::DescriptorSetLayoutCreateInfo()
             .setBindingCount(mBindings.size())
             .setPBindings(mBindings.data());
+
+        if (mPushDescriptor)
+        {
+            createInfo.setFlags(vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptor);
+        }
+        else if (mBackend == DescriptorBackend::Buffer)
+        {
+            createInfo.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT);
+        }
     
         nbl_VK_TRY(mLayout = mDevice->getHandle().createDescriptorSetLayout(createInfo);)
     
@@ -124,4 +369,173 @@ namespace nbl
             });
         }
     }
-}
\ No newline at end of file
+
+    void Descriptor::createDescriptorBuffer()
+    {
+        const auto properties = mDevice->getPhysicalDevice().getProperties2<
+            vk::PhysicalDeviceProperties2,
+            vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+        mDescriptorBufferProperties = properties.get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+
+        const vk::DeviceSize alignment  = mDescriptorBufferProperties.descriptorBufferOffsetAlignment;
+        const vk::DeviceSize layoutSize = mDevice->getHandle().getDescriptorSetLayoutSizeEXT(mLayout);
+        mSetStride = (layoutSize + alignment - 1) & ~(alignment - 1);
+
+        // Offsets are indexed by binding number, bindings may be sparse.
+        uint32_t maxBinding = 0;
+        for (const auto& binding : mBindings)
+        {
+            maxBinding = std::max(maxBinding, binding.binding);
+        }
+        mBindingOffsets.resize(maxBinding + 1, 0);
+        for (const auto& binding : mBindings)
+        {
+            mBindingOffsets[binding.binding] = mDevice->getHandle().getDescriptorSetLayoutBindingOffsetEXT(mLayout, binding.binding);
+        }
+
+        mDescriptorBuffer = Buffer::createBuffer({
+            .size      = mSetStride * mSetCount,
+            .type      = BufferType::Descriptor,
+            .pDevice   = mDevice,
+            .debugName = fmt::format("{} Descriptor Buffer", mDebugName),
+        });
+    }
+
+    void Descriptor::writeDescriptorBuffer(const DescriptorWriteInfo& writeInfo) const
+    {
+        const auto& props  = mDescriptorBufferProperties;
+        const auto  mapped = mDescriptorBuffer->map();
+        std::byte*  pSet   = mapped.data() + mSetStride * writeInfo.setIndex;
+
+        const auto getBufferAddress = [&](const vk::DescriptorBufferInfo& info) -> vk::DescriptorAddressInfoEXT {
+            if (info.range == vk::WholeSize)
+            {
+                throw RHIError(fmt::format("Descriptor {}: The Buffer backend requires explicit buffer ranges", mDebugName));
+            }
+            const vk::DeviceAddress address = mDevice->getHandle().getBufferAddress(vk::BufferDeviceAddressInfo().setBuffer(info.buffer));
+            return vk::DescriptorAddressInfoEXT()
+                .setAddress(address + info.offset)
+                .setRange(info.range);
+        };
+
+        for (const auto& write : writeInfo.writes)
+        {
+            for (uint32_t i = 0; i < write.descriptorCount; i++)
+            {
+                auto getInfo = vk::DescriptorGetInfoEXT().setType(write.descriptorType);
+                vk::DescriptorAddressInfoEXT addressInfo;
+                size_t descriptorSize = 0;
+
+                switch (write.descriptorType)
+                {
+                    case vk::DescriptorType::eUniformBuffer: {
+                        addressInfo = getBufferAddress(write.pBufferInfo[i]);
+                        getInfo.data.setPUniformBuffer(&addressInfo);
+                        descriptorSize = props.uniformBufferDescriptorSize;
+                        break;
+                    }
+                    case vk::DescriptorType::eStorageBuffer: {
+                        addressInfo = getBufferAddress(write.pBufferInfo[i]);
+                        getInfo.data.setPStorageBuffer(&addressInfo);
+                        descriptorSize = props.storageBufferDescriptorSize;
+                        break;
+                    }
+                    case vk::DescriptorType::eCombinedImageSampler: {
+                        getInfo.data.setPCombinedImageSampler(&write.pImageInfo[i]);
+                        descriptorSize = props.combinedImageSamplerDescriptorSize;
+                        break;
+                    }
+                    case vk::DescriptorType::eStorageImage: {
+                        getInfo.data.setPStorageImage(&write.pImageInfo[i]);
+                        descriptorSize = props.storageImageDescriptorSize;
+                        break;
+                    }
+                    case vk::DescriptorType::eAccelerationStructureKHR: {
+                        const auto* pInfo = static_cast<const vk::WriteDescriptorSetAccelerationStructureKHR*>(write.pNext);
+                        const auto asAddressInfo = vk::AccelerationStructureDeviceAddressInfoKHR()
+                            .setAccelerationStructure(pInfo->pAccelerationStructures[i]);
+                        getInfo.data.setAccelerationStructure(mDevice->getHandle().getAccelerationStructureAddressKHR(asAddressInfo));
+                        descriptorSize = props.accelerationStructureDescriptorSize;
+                        break;
+                    }
+                    default:
+                        throw RHIError(fmt::format("Descriptor {}: {} is not supported by the Buffer backend",
+                            mDebugName, vk::to_string(write.descriptorType)));
+                }
+
+                std::byte* pDst = pSet + mBindingOffsets[write.dstBinding] + (write.dstArrayElement + i) * descriptorSize;
+                mDevice->getHandle().getDescriptorEXT(&getInfo, descriptorSize, pDst);
+            }
+        }
+
+        mDescriptorBuffer->flush(mSetStride * writeInfo.setIndex, mSetStride);
+    }
+
+    void Descriptor::createUpdateTemplate()
+    {
+        // Packed layout: bindings in declaration order, descriptors tightly packed by their info struct.
+        size_t offset = 0;
+        for (const auto& binding : mBindings)
+        {
+            size_t stride;
+            switch (binding.descriptorType)
+            {
+                case vk::DescriptorType::eUniformBuffer:
+                case vk::DescriptorType::eStorageBuffer:
+                    stride = sizeof(vk::DescriptorBufferInfo);
+                    break;
+                case vk::DescriptorType::eAccelerationStructureKHR:
+                    stride = sizeof(vk::AccelerationStructureKHR);
+                    break;
+                case vk::DescriptorType::eSampler:
+                case vk::DescriptorType::eCombinedImageSampler:
+                case vk::DescriptorType::eSampledImage:
+                case vk::DescriptorType::eStorageImage:
+                case vk::DescriptorType::eInputAttachment:
+                    stride = sizeof(vk::DescriptorImageInfo);
+                    break;
+                default:
+                    throw RHIError(fmt::format("Descriptor {}: {} is not supported by update templates",
+                        mDebugName, vk::to_string(binding.descriptorType)));
+            }
+
+            mTemplateEntries.push_back(vk::DescriptorUpdateTemplateEntry()
+                .setDstBinding(binding.binding)
+                .setDstArrayElement(0)
+                .setDescriptorCount(binding.descriptorCount)
+                .setDescriptorType(binding.descriptorType)
+                .setOffset(offset)
+                .setStride(stride));
+
+            mTemplateOffsets[binding.binding] = offset;
+            offset += stride * binding.descriptorCount;
+        }
+        mTemplateSize = offset;
+
+        // Push descriptor templates need a pipeline layout, descriptor buffers are written with getDescriptorEXT.
+        if (mPushDescriptor || mBackend == DescriptorBackend::Buffer)
+        {
+            return;
+        }
+
+        const auto createInfo = vk::DescriptorUpdateTemplateCreateInfo()
+            .setTemplateType(vk::DescriptorUpdateTemplateType::eDescriptorSet)
+            .setDescriptorUpdateEntries(mTemplateEntries)
+            .setDescriptorSetLayout(mLayout);
+
+        nbl_VK_TRY(mUpdateTemplate = mDevice->getHandle().createDescriptorUpdateTemplate(createInfo);)
+
+        mDevice->nameObject<vk::DescriptorUpdateTemplate>({
+            .debugName = fmt::format("{} Update Template", mDebugName),
+            .handle    = mUpdateTemplate,
+        });
+    }
+
+    void Descriptor::validateTemplateData(const size_t size) const
+    {
+        if (size != mTemplateSize)
+        {
+            throw RHIError(fmt::format("Descriptor {}: Template data is {} bytes, expected {} bytes", mDebugName, size, mTemplateSize));
+        }
+    }
+}
@@ -1,12 +1,19 @@
 #include "Device.hpp"
 
+#include <cstddef>
+#include <cstring>
+#include <optional>
 #include "Extensions.hpp"
 
 namespace nbl
 {
-    inline vk::PhysicalDeviceFeatures getBaseDeviceFeatures() noexcept
+    /**
+     * Base features requested from every PhysicalDevice, cleared where the device does not support them.
+     * vk::PhysicalDeviceFeatures has no structure header and holds vk::Bool32 members only.
+     */
+    inline vk::PhysicalDeviceFeatures getBaseDeviceFeatures(const vk::PhysicalDevice& physicalDevice)
     {
-        return vk::PhysicalDeviceFeatures()
+        auto requested = vk::PhysicalDeviceFeatures()
             .setGeometryShader(true)
             .setTessellationShader(true)
             .setMultiDrawIndirect(true)
@@ -14,7 +21,42 @@ namespace nbl
             .setFillModeNonSolid(true)
             .setSamplerAnisotropy(true)
             .setSampleRateShading(true)
-            .setShaderInt64(true);
+            .setFragmentStoresAndAtomics(true)
+            .setShaderInt64(true)
+            .setPipelineStatisticsQuery(true);
+
+        const vk::PhysicalDeviceFeatures supported = physicalDevice.getFeatures();
+
+        constexpr size_t featureCount = sizeof(vk::PhysicalDeviceFeatures) / sizeof(vk::Bool32);
+
+        auto*       pRequested = reinterpret_cast<vk::Bool32*>(&requested);
+        const auto* pSupported = reinterpret_cast<const vk::Bool32*>(&supported);
+        for (size_t i = 0; i < featureCount; i++)
+        {
+            pRequested[i] = pRequested[i] && pSupported[i];
+        }
+
+        return requested;
+    }
+
+    std::string toString(const DeviceTier deviceTier) noexcept
+    {
+        switch (deviceTier)
+        {
+            case DeviceTier::Baseline:      return "Baseline";
+            case DeviceTier::MeshShading:   return "MeshShading";
+            case DeviceTier::RayTracing:    return "RayTracing";
+            default:                        return "Unknown";
+        }
+    }
+
+    DeviceTier DeviceCapabilities::getTier() const noexcept
+    {
+        if (!meshShader)
+        {
+            return DeviceTier::Baseline;
+        }
+        return hasRayTracing() ? DeviceTier::RayTracing : DeviceTier::MeshShading;
     }
 
     Device::Device(const DeviceCreateInfo& createInfo)
@@ -33,30 +75,48 @@ namespace nbl
     Device::~Device()
     {
         waitIdle();
+        mDeletionQueue->flush();
+    }
+
+    bool Device::isExtensionEnabled(const char* extensionName) const
+    {
+        return std::ranges::any_of(mDeviceExtensionNames, [extensionName](const char* name) {
+            return !std::strcmp(name, extensionName);
+        });
     }
 
     void Device::selectPhysicalDevice()
     {
-        const auto physicalDevices = mInstance.enumeratePhysicalDevices();
-        const auto candidate = std::ranges::find_if(physicalDevices, [&](const vk::PhysicalDevice& physicalDevice) {
-            bool requirementsPassed = true;
-            for (const auto& extension : VulkanDeviceExtension::getRHIDeviceExtensions(physicalDevice))
+        // Pick the highest tier PhysicalDevice that supports every required extension.
+        std::optional<vk::PhysicalDevice> candidate;
+        DeviceTier                        candidateTier = DeviceTier::Baseline;
+
+        for (const auto& physicalDevice : mInstance.enumeratePhysicalDevices())
+        {
+            const auto extensions = VulkanDeviceExtension::getRHIDeviceExtensions(physicalDevice);
+            const bool requirementsPassed = std::ranges::none_of(extensions, [](const auto& extension) {
+                return extension->isRequired() and !extension->isSupported();
+            });
+
+            if (!requirementsPassed)
             {
-                if (extension->isRequested() and !extension->isSupported())
-                {
-                    requirementsPassed = false;
-                }
+                continue;
             }
 
-            return requirementsPassed;
-        });
+            if (const DeviceTier tier = queryCapabilities(physicalDevice, extensions).getTier();
+                !candidate.has_value() || tier > candidateTier)
+            {
+                candidate     = physicalDevice;
+                candidateTier = tier;
+            }
+        }
 
-        if (candidate == std::end(physicalDevices))
+        if (!candidate.has_value())
         {
             throw RHIError("Failed to find a suitable PhysicalDevice");
         }
 
-        mPhysicalDevice = *candidate;
+        mPhysicalDevice = candidate.value();
         mPhysicalDeviceProperties = mPhysicalDevice.getProperties();
         mDeviceName = std::string(mPhysicalDeviceProperties.deviceName.data());
     }
@@ -70,7 +130,7 @@ namespace nbl
         {
             if (extension->shouldActivate())
             {
-                extension->postSupportCheck();
+                extension->postSupportCheck(mPhysicalDevice);
                 if (extension->isExtension())
                 {
                     mDeviceExtensionNames.push_back(extension->getExtensionName());
@@ -78,6 +138,8 @@ namespace nbl
             }
         }
 
+        mCapabilities = queryCapabilities(mPhysicalDevice, mDeviceExtensions);
+
         #pragma endregion
 
         #pragma region "Queues"
@@ -90,7 +152,12 @@ namespace nbl
             uniqueQueueFamilies.insert(queueGraphics->familyIndex);
         }
 
-        const auto queueCompute = findQueue(mPhysicalDevice, vk::QueueFlagBits::eCompute, vk::QueueFlagBits::eGraphics);
+        // Software rasterizers and older GPUs may not expose a dedicated compute family.
+        auto queueCompute = findQueue(mPhysicalDevice, vk::QueueFlagBits::eCompute, vk::QueueFlagBits::eGraphics);
+        if (!queueCompute.has_value())
+        {
+            queueCompute = queueGraphics;
+        }
         if (queueCompute.has_value())
         {
             uniqueQueueFamilies.insert(queueCompute->familyIndex);
@@ -110,7 +177,7 @@ namespace nbl
 
         #pragma endregion
 
-        const auto deviceFeatures = getBaseDeviceFeatures();
+        const auto deviceFeatures = getBaseDeviceFeatures(mPhysicalDevice);
 
         auto createInfo = vk::DeviceCreateInfo()
             .setEnabledExtensionCount(mDeviceExtensionNames.size())
@@ -132,17 +199,27 @@ namespace nbl
             .name = "Graphics Queue",
         });
 
-        mAsyncComputeQueue = createQueue({
-            .queueFamilyIndex = queueCompute->familyIndex,
-            .queueIndex = 0,
-            .name = "Compute Queue",
-        });
+        // Another Queue for the same vk::Queue would need external synchronization with the graphics one.
+        if (queueCompute->familyIndex != queueGraphics->familyIndex)
+        {
+            mAsyncComputeQueue = createQueue({
+                .queueFamilyIndex = queueCompute->familyIndex,
+                .queueIndex = 0,
+                .name = "Compute Queue",
+            });
+        }
     }
 
     void Device::createAllocator()
     {
+        VmaAllocatorCreateFlags flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+        if (mCapabilities.memoryBudget)
+        {
+            flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
+
         const VmaAllocatorCreateInfo createInfo = {
-            .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+            .flags = flags,
             .physicalDevice = mPhysicalDevice,
             .device = mDevice,
             .instance = mInstance,
@@ -150,6 +227,50 @@ namespace nbl
         };
 
         nbl_VK_C_RESULT(vmaCreateAllocator(&createInfo, &mAllocator));
+
+        mMemoryTracker = std::make_unique<MemoryTracker>(mAllocator);
+        mDeletionQueue = std::make_unique<DeletionQueue>();
+    }
+
+    DeviceCapabilities Device::queryCapabilities(const vk::PhysicalDevice& physicalDevice, const std::vector<std::unique_ptr<VulkanDeviceExtension>>& extensions)
+    {
+        const auto hasExtension = [&](const char* extensionName) -> bool {
+            return std::ranges::any_of(extensions, [extensionName](const auto& extension) {
+                return extension->shouldActivate() and !std::strcmp(extension->getExtensionName(), extensionName);
+            });
+        };
+
+        DeviceCapabilities capabilities = {
+            .accelerationStructure = hasExtension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME),
+            .rayTracingPipeline    = hasExtension(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME),
+            .rayQuery              = hasExtension(VK_KHR_RAY_QUERY_EXTENSION_NAME),
+            .memoryBudget          = hasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME),
+            .presentWait           = hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) and hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME),
+            .pipelineStatistics    = static_cast<bool>(physicalDevice.getFeatures().pipelineStatisticsQuery),
+        };
+
+        const auto core12 = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>()
+            .get<vk::PhysicalDeviceVulkan12Features>();
+        capabilities.bindlessStorageImages = core12.shaderStorageImageArrayNonUniformIndexing
+                                         and core12.descriptorBindingStorageImageUpdateAfterBind;
+
+        // Feature structs of an extension may only be queried if the device supports it.
+        if (hasExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME))
+        {
+            const auto features = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceMeshShaderFeaturesEXT>()
+                .get<vk::PhysicalDeviceMeshShaderFeaturesEXT>();
+            capabilities.meshShader        = features.meshShader and features.taskShader;
+            capabilities.meshShaderQueries = capabilities.meshShader and features.meshShaderQueries;
+        }
+
+        if (hasExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME))
+        {
+            const auto features = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceDescriptorBufferFeaturesEXT>()
+                .get<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+            capabilities.descriptorBuffer = features.descriptorBuffer;
+        }
+
+        return capabilities;
     }
 
     std::unique_ptr<Queue> Device::createQueue(const QueueCreateInfo& createInfo) const
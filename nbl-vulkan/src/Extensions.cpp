@@ -1,5 +1,8 @@
 #include "Extensions.hpp"
 
+#include <cstddef>
+#include <string_view>
+
 #include "Util.hpp"
 
 namespace nbl
@@ -12,28 +15,38 @@ namespace nbl
 
     VulkanDeviceExtension::VulkanDeviceExtension(
         const char* extensionName,
-        const bool  requested)
+        const bool  requested,
+        const bool  optional)
     : mExtensionName(extensionName)
     , mIsRequested(requested)
+    , mIsOptional(optional)
     {
     }
 
     VulkanDeviceExtension::VulkanDeviceExtension(
-        const char*                  extensionName,
-        const std::function<void()>& structInitFn,
-        const bool                   requested)
+        const char*                                           extensionName,
+        const std::function<void(const vk::PhysicalDevice&)>& structInitFn,
+        const bool                                            requested,
+        const bool                                            optional)
     : mExtensionName(extensionName)
     , mIsRequested(requested)
+    , mIsOptional(optional)
     , mStructInitFn(structInitFn)
     {
         mIsCoreFeatureStruct = std::string(mExtensionName).contains("VulkanCore");
+        if (mIsCoreFeatureStruct)
+        {
+            // "VulkanCore1.x"
+            const std::string_view version = std::string_view(mExtensionName).substr(std::string_view("VulkanCore").size());
+            mCoreApiVersion = VK_MAKE_API_VERSION(0, version[0] - '0', version[2] - '0', 0);
+        }
     }
 
-    void VulkanDeviceExtension::postSupportCheck()
+    void VulkanDeviceExtension::postSupportCheck(const vk::PhysicalDevice& physicalDevice)
     {
         if (!shouldActivate()) return;
         mIsEnabled = true;
-        mStructInitFn();
+        mStructInitFn(physicalDevice);
     }
 
     void VulkanDeviceExtension::preCreateDevice(vk::DeviceCreateInfo& deviceCreateInfo) const
@@ -52,10 +65,33 @@ namespace nbl
         deviceCreateInfo.setPNext(featureInfo);
     }
 
+    /**
+     * Clear the requested features the PhysicalDevice does not support.
+     * Feature structs are a vk::BaseOutStructure header followed by vk::Bool32 members only.
+     */
+    template <class T>
+    T getSupportedFeatures(const vk::PhysicalDevice& physicalDevice, T requested)
+    {
+        const T supported = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, T>().template get<T>();
+
+        constexpr size_t headerSize   = sizeof(vk::BaseOutStructure);
+        constexpr size_t featureCount = (sizeof(T) - headerSize) / sizeof(vk::Bool32);
+
+        auto*       pRequested = reinterpret_cast<vk::Bool32*>(reinterpret_cast<std::byte*>(&requested) + headerSize);
+        const auto* pSupported = reinterpret_cast<const vk::Bool32*>(reinterpret_cast<const std::byte*>(&supported) + headerSize);
+        for (size_t i = 0; i < featureCount; i++)
+        {
+            pRequested[i] = pRequested[i] && pSupported[i];
+        }
+
+        return requested;
+    }
+
     #define def_VulkanExt(NAME, strEXT_NAME, tSTRUCT, FN)                       \
     class Vulkan##NAME : public VulkanDeviceExtension {                         \
     public:                                                                     \
-        Vulkan##NAME() : VulkanDeviceExtension(strEXT_NAME, FN, true) {         \
+        explicit Vulkan##NAME(const bool optional = false)                      \
+        : VulkanDeviceExtension(strEXT_NAME, FN, true, optional) {              \
             mFeatureStructPtr = &mFeatureStruct;                                \
         }                                                                       \
         ~Vulkan##NAME() override = default;                                     \
@@ -64,33 +100,43 @@ namespace nbl
 
     #pragma region "vk::PhysicalDeviceVulkan1(x)Features"
 
-    def_VulkanExt(Core11, "VulkanCore1.1", vk::PhysicalDeviceVulkan11Features, [&]() -> void {
-        mFeatureStruct = vk::PhysicalDeviceVulkan11Features();
+    def_VulkanExt(Core11, "VulkanCore1.1", vk::PhysicalDeviceVulkan11Features, [&](const vk::PhysicalDevice& physicalDevice) -> void {
+        mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceVulkan11Features());
     });
 
-    def_VulkanExt(Core12, "VulkanCore1.2", vk::PhysicalDeviceVulkan12Features, [&]() -> void {
-        mFeatureStruct = vk::PhysicalDeviceVulkan12Features()
+    def_VulkanExt(Core12, "VulkanCore1.2", vk::PhysicalDeviceVulkan12Features, [&](const vk::PhysicalDevice& physicalDevice) -> void {
+        mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceVulkan12Features()
             .setBufferDeviceAddress(true)
             .setDescriptorIndexing(true)
+            .setRuntimeDescriptorArray(true)
+            .setDescriptorBindingPartiallyBound(true)
+            .setDescriptorBindingUpdateUnusedWhilePending(true)
+            .setDescriptorBindingStorageBufferUpdateAfterBind(true)
+            .setDescriptorBindingSampledImageUpdateAfterBind(true)
+            .setDescriptorBindingStorageImageUpdateAfterBind(true)
+            .setShaderStorageBufferArrayNonUniformIndexing(true)
+            .setShaderSampledImageArrayNonUniformIndexing(true)
+            .setShaderStorageImageArrayNonUniformIndexing(true)
             .setScalarBlockLayout(true)
             .setShaderInt8(true)
             .setTimelineSemaphore(true)
             .setHostQueryReset(true)
             .setScalarBlockLayout(true)
-            .setDrawIndirectCount(true);
+            .setDrawIndirectCount(true));
     });
 
-    def_VulkanExt(Core13, "VulkanCore1.3", vk::PhysicalDeviceVulkan13Features, [&]() -> void {
-        mFeatureStruct = vk::PhysicalDeviceVulkan13Features()
+    def_VulkanExt(Core13, "VulkanCore1.3", vk::PhysicalDeviceVulkan13Features, [&](const vk::PhysicalDevice& physicalDevice) -> void {
+        mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceVulkan13Features()
             .setMaintenance4(true)
             .setDynamicRendering(true)
             .setSynchronization2(true)
-            .setInlineUniformBlock(true);
+            .setInlineUniformBlock(true));
     });
 
-    def_VulkanExt(Core14, "VulkanCore1.4", vk::PhysicalDeviceVulkan14Features, [&]() -> void {
-        mFeatureStruct = vk::PhysicalDeviceVulkan14Features()
-            .setHostImageCopy(true);
+    def_VulkanExt(Core14, "VulkanCore1.4", vk::PhysicalDeviceVulkan14Features, [&](const vk::PhysicalDevice& physicalDevice) -> void {
+        mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceVulkan14Features()
+            .setHostImageCopy(true)
+            .setPushDescriptor(true));
     });
 
     #pragma endregion
@@ -102,9 +148,9 @@ namespace nbl
         AccelerationStructureExt,
         VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
         vk::PhysicalDeviceAccelerationStructureFeaturesKHR,
-        [&]() -> void {
-            mFeatureStruct = vk::PhysicalDeviceAccelerationStructureFeaturesKHR()
-                .setAccelerationStructure(true);
+        [&](const vk::PhysicalDevice& physicalDevice) -> void {
+            mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceAccelerationStructureFeaturesKHR()
+                .setAccelerationStructure(true));
         }
     );
 
@@ -113,9 +159,9 @@ namespace nbl
         RayTracingPipelineExt,
         VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
         vk::PhysicalDeviceRayTracingPipelineFeaturesKHR,
-        [&]() -> void {
-            mFeatureStruct = vk::PhysicalDeviceRayTracingPipelineFeaturesKHR()
-                .setRayTracingPipeline(true);
+        [&](const vk::PhysicalDevice& physicalDevice) -> void {
+            mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceRayTracingPipelineFeaturesKHR()
+                .setRayTracingPipeline(true));
         }
     );
 
@@ -124,9 +170,9 @@ namespace nbl
         RayQueryExt,
         VK_KHR_RAY_QUERY_EXTENSION_NAME,
         vk::PhysicalDeviceRayQueryFeaturesKHR,
-        [&]() -> void {
-            mFeatureStruct = vk::PhysicalDeviceRayQueryFeaturesKHR()
-                .setRayQuery(true);
+        [&](const vk::PhysicalDevice& physicalDevice) -> void {
+            mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceRayQueryFeaturesKHR()
+                .setRayQuery(true));
         }
     );
 
@@ -135,11 +181,44 @@ namespace nbl
         MeshShaderExt,
         VK_EXT_MESH_SHADER_EXTENSION_NAME,
         vk::PhysicalDeviceMeshShaderFeaturesEXT,
-        [&]() -> void {
-            mFeatureStruct = vk::PhysicalDeviceMeshShaderFeaturesEXT()
+        [&](const vk::PhysicalDevice& physicalDevice) -> void {
+            mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceMeshShaderFeaturesEXT()
                 .setMeshShader(true)
                 .setTaskShader(true)
-                .setMeshShaderQueries(true);
+                .setMeshShaderQueries(true));
+        }
+    );
+
+    // VK_EXT_descriptor_buffer
+    def_VulkanExt(
+        DescriptorBufferExt,
+        VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+        vk::PhysicalDeviceDescriptorBufferFeaturesEXT,
+        [&](const vk::PhysicalDevice& physicalDevice) -> void {
+            mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDeviceDescriptorBufferFeaturesEXT()
+                .setDescriptorBuffer(true));
+        }
+    );
+
+    // VK_KHR_present_id
+    def_VulkanExt(
+        PresentIdExt,
+        VK_KHR_PRESENT_ID_EXTENSION_NAME,
+        vk::PhysicalDevicePresentIdFeaturesKHR,
+        [&](const vk::PhysicalDevice& physicalDevice) -> void {
+            mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDevicePresentIdFeaturesKHR()
+                .setPresentId(true));
+        }
+    );
+
+    // VK_KHR_present_wait
+    def_VulkanExt(
+        PresentWaitExt,
+        VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+        vk::PhysicalDevicePresentWaitFeaturesKHR,
+        [&](const vk::PhysicalDevice& physicalDevice) -> void {
+            mFeatureStruct = getSupportedFeatures(physicalDevice, vk::PhysicalDevicePresentWaitFeaturesKHR()
+                .setPresentWait(true));
         }
     );
 
@@ -151,17 +230,25 @@ namespace nbl
     {
         std::vector<std::unique_ptr<VulkanDeviceExtension>> extensions = {};
 
-        extensions.push_back(std::make_unique<VulkanDeviceExtension>(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME, true));
+        // Optional extensions define capability tiers above the baseline,
+        // a PhysicalDevice without them is still selectable.
+        constexpr bool optional = true;
+
+        extensions.push_back(std::make_unique<VulkanDeviceExtension>(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME, true, optional));
         extensions.push_back(std::make_unique<VulkanDeviceExtension>(VK_KHR_SHADER_NON_SEMANTIC_INFO_EXTENSION_NAME, true));
         extensions.push_back(std::make_unique<VulkanDeviceExtension>(VK_KHR_SWAPCHAIN_EXTENSION_NAME, true));
+        extensions.push_back(std::make_unique<VulkanDeviceExtension>(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, true, optional));
         extensions.push_back(std::make_unique<VulkanCore11>());
         extensions.push_back(std::make_unique<VulkanCore12>());
         extensions.push_back(std::make_unique<VulkanCore13>());
-        extensions.push_back(std::make_unique<VulkanCore14>());
-        extensions.push_back(std::make_unique<VulkanAccelerationStructureExt>());
-        extensions.push_back(std::make_unique<VulkanRayTracingPipelineExt>());
-        extensions.push_back(std::make_unique<VulkanRayQueryExt>());
-        extensions.push_back(std::make_unique<VulkanMeshShaderExt>());
+        extensions.push_back(std::make_unique<VulkanCore14>(optional));
+        extensions.push_back(std::make_unique<VulkanAccelerationStructureExt>(optional));
+        extensions.push_back(std::make_unique<VulkanRayTracingPipelineExt>(optional));
+        extensions.push_back(std::make_unique<VulkanRayQueryExt>(optional));
+        extensions.push_back(std::make_unique<VulkanMeshShaderExt>(optional));
+        extensions.push_back(std::make_unique<VulkanDescriptorBufferExt>(optional));
+        extensions.push_back(std::make_unique<VulkanPresentIdExt>(optional));
+        extensions.push_back(std::make_unique<VulkanPresentWaitExt>(optional));
 
         if (!physicalDevice.has_value())
         {
@@ -170,10 +257,11 @@ namespace nbl
 
         const vk::PhysicalDevice gpu = physicalDevice.value();
         const std::vector<vk::ExtensionProperties> availableExtensions = gpu.enumerateDeviceExtensionProperties();
+        const uint32_t apiVersion = gpu.getProperties().apiVersion;
 
         for (const auto& extension : extensions)
         {
-            if (!extension->mIsCoreFeatureStruct && findExtension(extension->getExtensionName(), availableExtensions))
+            if (!extension->mIsCoreFeatureStruct && findExtension(extension->getExtensionName(), availableExtensions) != gInvalidIndex)
             {
                 extension->setSupported();
                 if (extension->isRequested())
@@ -182,7 +270,8 @@ namespace nbl
                 }
             }
 
-            if (extension->mIsCoreFeatureStruct)
+            // Chaining a Vulkan1xFeatures struct the device version does not know is invalid.
+            if (extension->mIsCoreFeatureStruct && apiVersion >= extension->mCoreApiVersion)
             {
                 extension->setSupported();
                 extension->setEnabled();
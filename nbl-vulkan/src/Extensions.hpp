@@ -19,12 +19,17 @@ namespace nbl
 
         explicit VulkanDeviceExtension(
             const char*                  extensionName,
-            bool                         requested = true);
+            bool                         requested = true,
+            bool                         optional  = false);
 
+        /**
+         * @param structInitFn Fills the feature struct, features the PhysicalDevice does not support must be left disabled.
+         */
         VulkanDeviceExtension(
-            const char*                  extensionName,
-            const std::function<void()>& structInitFn,
-            bool                         requested = true);
+            const char*                                           extensionName,
+            const std::function<void(const vk::PhysicalDevice&)>& structInitFn,
+            bool                                                  requested = true,
+            bool                                                  optional  = false);
 
         virtual ~VulkanDeviceExtension() = default;
 
@@ -32,13 +37,15 @@ namespace nbl
         void setSupported() noexcept { mIsSupported = true; }
         void setEnabled  () noexcept { mIsEnabled   = true; }
 
-        void postSupportCheck();
+        void postSupportCheck(const vk::PhysicalDevice& physicalDevice);
 
         void preCreateDevice(vk::DeviceCreateInfo& deviceCreateInfo) const;
 
         const char* getExtensionName() const noexcept { return mExtensionName;                    }
         bool        isRequested     () const noexcept { return mIsRequested;                      }
-        bool        isSupported     () const noexcept { return mIsRequested;                      }
+        bool        isSupported     () const noexcept { return mIsSupported;                      }
+        bool        isOptional      () const noexcept { return mIsOptional;                       }
+        bool        isRequired      () const noexcept { return mIsRequested     and !mIsOptional; }
         bool        shouldActivate  () const noexcept { return mIsRequested     and mIsSupported; }
         bool        isActive        () const noexcept { return shouldActivate() and mIsEnabled;   }
         bool        isExtension     () const noexcept { return !mIsCoreFeatureStruct;             }
@@ -51,10 +58,12 @@ namespace nbl
 
         const char* mExtensionName       = nullptr;
         bool        mIsCoreFeatureStruct = false;       // For Vulkan1xFeatures
+        uint32_t    mCoreApiVersion      = 0;           // Device apiVersion a Vulkan1xFeatures struct needs
         bool        mIsRequested         = false;
+        bool        mIsOptional          = false;       // Device selection does not fail when unsupported
         bool        mIsSupported         = false;
         bool        mIsEnabled           = false;
 
-        std::function<void()> mStructInitFn = [](){};
+        std::function<void(const vk::PhysicalDevice&)> mStructInitFn = [](const vk::PhysicalDevice&){};
     };
 }
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <ranges>
+#include <fmt/format.h>
+
+#include "Common.hpp"
+#include "Device.hpp"
+
+namespace nbl
+{
+    std::string toString(const FrameBound frameBound) noexcept
+    {
+        switch (frameBound)
+        {
+            case FrameBound::CpuBound:     return "CPU";
+            case FrameBound::GpuBound:     return "GPU";
+            case FrameBound::PresentBound: return "Present";
+            default:                       return "Unknown";
+        }
+    }
+
+    FrameProfiler::FrameProfiler(const FrameProfilerCreateInfo& createInfo)
+    : mFrameCount(std::max(1u, createInfo.frameCount))
+    , mHistorySize(std::max(1u, createInfo.historySize))
+    , mPercentileWindow(std::max(1u, createInfo.percentileWindow))
+    , mDevice(createInfo.pDevice)
+    {
+        #pragma region "GPU Timestamps"
+
+        const auto& properties       = mDevice->getProperties();
+        const auto  familyProperties = mDevice->getPhysicalDevice().getQueueFamilyProperties();
+        const auto  familyIndex      = mDevice->getGraphicsQueue()->familyIndex;
+
+        if (familyProperties[familyIndex].timestampValidBits > 0 && properties.limits.timestampPeriod > 0.0f)
+        {
+            const auto queryPoolCreateInfo = vk::QueryPoolCreateInfo()
+                .setQueryType(vk::QueryType::eTimestamp)
+                .setQueryCount(2 * mFrameCount);
+
+            nbl_VK_TRY(mQueryPool = mDevice->getHandle().createQueryPool(queryPoolCreateInfo);)
+            mDevice->nameObject<vk::QueryPool>({
+                .debugName = "Frame Timestamps",
+                .handle    = mQueryPool,
+            });
+
+            // Host query reset (Vulkan 1.2), queries are reset again after every read.
+            mDevice->getHandle().resetQueryPool(mQueryPool, 0, 2 * mFrameCount);
+            mTimestampPeriod = properties.limits.timestampPeriod;
+        }
+        else
+        {
+            fmt::println("[Notice] Graphics queue does not support timestamps, GPU frame times are unavailable.");
+        }
+
+        #pragma endregion
+
+        #pragma region "Present Wait"
+
+        mPresentWait = mDevice->getCapabilities().presentWait;
+        if (mPresentWait)
+        {
+            mPresentThread = std::jthread([this](const std::stop_token& stopToken) { presentWaitThread(stopToken); });
+        }
+        else
+        {
+            fmt::println("[Notice] VK_KHR_present_wait is unavailable, frame latency ends at vkQueuePresentKHR.");
+        }
+
+        #pragma endregion
+    }
+
+    FrameProfiler::~FrameProfiler()
+    {
+        if (mPresentThread.joinable())
+        {
+            mPresentThread.request_stop();
+            mPresentThread.join();
+        }
+
+        if (mQueryPool)
+        {
+            mDevice->getDeletionQueue()->push([device = mDevice->getHandle(), queryPool = mQueryPool] {
+                device.destroy(queryPool);
+            });
+        }
+    }
+
+    void FrameProfiler::mark(const FramePhase phase)
+    {
+        mPhases[static_cast<size_t>(phase)] = Clock::now();
+    }
+
+    void FrameProfiler::writeBeginTimestamp(const vk::CommandBuffer& commandBuffer, const uint32_t frameIndex) const
+    {
+        if (!mQueryPool) return;
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eNone, mQueryPool, 2 * frameIndex);
+    }
+
+    void FrameProfiler::writeEndTimestamp(const vk::CommandBuffer& commandBuffer, const uint32_t frameIndex) const
+    {
+        if (!mQueryPool) return;
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, mQueryPool, 2 * frameIndex + 1);
+    }
+
+    uint64_t FrameProfiler::getPresentId() const
+    {
+        // Present ids must increase per Swapchain, the frame number is never reused.
+        return mPresentWait ? mFrameNumber + 1 : 0;
+    }
+
+    void FrameProfiler::endFrame(const uint32_t frameIndex, const vk::SwapchainKHR swapchain)
+    {
+        const auto phase = [this](const FramePhase framePhase) { return mPhases[static_cast<size_t>(framePhase)]; };
+
+        const Clock::time_point waitBegin = phase(FramePhase::WaitBegin);
+        const Clock::time_point presentEnd = phase(FramePhase::PresentEnd);
+
+        // Applications that do not mark InputPoll start their frames at beginFrame.
+        Clock::time_point inputPoll = phase(FramePhase::InputPoll);
+        if (inputPoll < mLastWaitBegin || inputPoll > waitBegin)
+        {
+            inputPoll = waitBegin;
+        }
+
+        PendingFrame pending {
+            .record = {
+                .frameNumber = mFrameNumber,
+                .frameMs     = mLastWaitBegin == Clock::time_point() ? 0.0 : toMs(waitBegin - mLastWaitBegin),
+                .waitMs      = toMs(phase(FramePhase::WaitEnd)    - waitBegin),
+                .acquireMs   = toMs(phase(FramePhase::AcquireEnd) - phase(FramePhase::AcquireBegin)),
+                .recordMs    = toMs(phase(FramePhase::SubmitBegin) - phase(FramePhase::AcquireEnd)),
+                .submitMs    = toMs(phase(FramePhase::SubmitEnd)  - phase(FramePhase::SubmitBegin)),
+                .presentMs   = toMs(presentEnd - phase(FramePhase::PresentBegin)),
+                .latencyMs   = toMs(presentEnd - inputPoll),
+            },
+            .frameIndex  = frameIndex,
+            .presentId   = getPresentId(),
+            .inputPoll   = inputPoll,
+            .gpuResolved = !mQueryPool,
+        };
+
+        // A frame is limited by whatever it blocked on for a significant share of its time.
+        const double cpuTime = toMs(presentEnd - waitBegin);
+        FrameRecord& record = pending.record;
+        if (record.waitMs >= 0.25 * cpuTime)
+        {
+            record.bound = FrameBound::GpuBound;
+        }
+        else if (record.acquireMs + record.presentMs >= 0.25 * cpuTime)
+        {
+            record.bound = FrameBound::PresentBound;
+        }
+
+        if (pending.presentId != 0)
+        {
+            std::lock_guard lock(mPresentMutex);
+            mPresentWaits.push_back({ .swapchain = swapchain, .presentId = pending.presentId });
+            mPresentCondition.notify_one();
+        }
+
+        mPending.push_back(pending);
+        mLastWaitBegin = waitBegin;
+        mFrameNumber++;
+
+        finalizeFrames();
+    }
+
+    void FrameProfiler::resolve(const uint32_t frameIndex)
+    {
+        if (mQueryPool)
+        {
+            // Pointer overload: returns eNotReady for a slot that was never submitted instead of throwing.
+            uint64_t timestamps[2] = {};
+            const vk::Result result = mDevice->getHandle().getQueryPoolResults(
+                mQueryPool, 2 * frameIndex, 2, sizeof(timestamps), timestamps, sizeof(uint64_t),
+                vk::QueryResultFlagBits::e64);
+
+            if (result == vk::Result::eSuccess)
+            {
+                const auto it = std::ranges::find_if(mPending, [frameIndex](const PendingFrame& pending) {
+                    return pending.frameIndex == frameIndex && !pending.gpuResolved;
+                });
+                if (it != std::end(mPending))
+                {
+                    it->record.gpuMs = static_cast<double>(timestamps[1] - timestamps[0]) * mTimestampPeriod / 1e6;
+                    it->gpuResolved  = true;
+                }
+                mDevice->getHandle().resetQueryPool(mQueryPool, 2 * frameIndex, 2);
+            }
+        }
+
+        finalizeFrames();
+    }
+
+    void FrameProfiler::drain()
+    {
+        for (uint32_t i = 0; i < mFrameCount; i++)
+        {
+            resolve(i);
+        }
+        finalizeFrames(true);
+    }
+
+    void FrameProfiler::retireSwapchain()
+    {
+        if (!mPresentWait) return;
+
+        // The worker must not wait on a Swapchain that is about to be destroyed.
+        std::unique_lock lock(mPresentMutex);
+        for (const auto& presentWait : mPresentWaits)
+        {
+            mPresentTimes[presentWait.presentId] = Clock::time_point();
+        }
+        mPresentWaits.clear();
+        mRetired = true;
+        mPresentCondition.notify_all();
+        mPresentCondition.wait(lock, [this] { return !mWaiting; });
+        mRetired = false;
+    }
+
+    FramePacingSummary FrameProfiler::getSummary() const
+    {
+        const size_t count = std::min<size_t>(mHistory.size(), mPercentileWindow);
+        const std::vector<FrameRecord> records(mHistory.end() - static_cast<ptrdiff_t>(count), mHistory.end());
+        return summarize(records);
+    }
+
+    FramePacingSummary FrameProfiler::summarize(const std::span<const FrameRecord> records)
+    {
+        if (records.empty())
+        {
+            return {};
+        }
+
+        std::vector<double> frameTimes;
+        std::vector<double> gpuTimes;
+        std::vector<double> latencies;
+        FramePacingSummary  summary { .frameCount = static_cast<uint32_t>(records.size()) };
+
+        for (const auto& record : records)
+        {
+            frameTimes.push_back(record.frameMs);
+            latencies.push_back(record.latencyMs);
+            if (record.gpuMs >= 0.0)
+            {
+                gpuTimes.push_back(record.gpuMs);
+            }
+
+            switch (record.bound)
+            {
+                case FrameBound::CpuBound:     summary.cpuBound++;     break;
+                case FrameBound::GpuBound:     summary.gpuBound++;     break;
+                case FrameBound::PresentBound: summary.presentBound++; break;
+            }
+        }
+
+        const auto percentile = [](std::vector<double>& values, const double p) -> double {
+            if (values.empty()) return 0.0;
+            const auto n = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+            std::ranges::nth_element(values, values.begin() + static_cast<ptrdiff_t>(n));
+            return values[n];
+        };
+
+        summary.p50Ms        = percentile(frameTimes, 0.50);
+        summary.p95Ms        = percentile(frameTimes, 0.95);
+        summary.p99Ms        = percentile(frameTimes, 0.99);
+        summary.maxMs        = std::ranges::max(frameTimes);
+        summary.gpuP50Ms     = percentile(gpuTimes, 0.50);
+        summary.latencyP50Ms = percentile(latencies, 0.50);
+
+        return summary;
+    }
+
+    void FrameProfiler::writeCsv(const std::string& filePath) const
+    {
+        std::ofstream file(filePath);
+        if (!file)
+        {
+            throw RHIError(fmt::format("Failed to open {} for writing", filePath));
+        }
+
+        file << "frame,frame_ms,wait_ms,acquire_ms,record_ms,submit_ms,present_ms,gpu_ms,latency_ms,present_wait,bound\n";
+        for (const auto& record : mHistory)
+        {
+            file << fmt::format("{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{},{}\n",
+                record.frameNumber, record.frameMs, record.waitMs, record.acquireMs, record.recordMs,
+                record.submitMs, record.presentMs, record.gpuMs, record.latencyMs,
+                record.presentWait ? 1 : 0, toString(record.bound));
+        }
+    }
+
+    void FrameProfiler::finalizeFrames(const bool force)
+    {
+        // Frames leave in order, a frame waiting for its GPU time or present holds back the later ones.
+        // Present waits that never return (e.g. minimized window) are given up after a few frames.
+        while (!mPending.empty())
+        {
+            PendingFrame& pending = mPending.front();
+            const bool expired = force || mPending.size() > mFrameCount + 8;
+
+            if (!pending.gpuResolved && !expired)
+            {
+                break;
+            }
+
+            if (pending.presentId != 0)
+            {
+                std::lock_guard lock(mPresentMutex);
+                const auto it = mPresentTimes.find(pending.presentId);
+                if (it == std::end(mPresentTimes) && !expired)
+                {
+                    break;
+                }
+                if (it != std::end(mPresentTimes))
+                {
+                    if (it->second != Clock::time_point())
+                    {
+                        pending.record.latencyMs   = toMs(it->second - pending.inputPoll);
+                        pending.record.presentWait = true;
+                    }
+                    mPresentTimes.erase(it);
+                }
+            }
+
+            mHistory.push_back(pending.record);
+            if (mHistory.size() > mHistorySize)
+            {
+                mHistory.pop_front();
+            }
+            mPending.pop_front();
+        }
+
+        // Results of frames that were given up on.
+        if (mPresentWait)
+        {
+            std::lock_guard lock(mPresentMutex);
+            const uint64_t oldest = mPending.empty() ? mFrameNumber + 1 : mPending.front().presentId;
+            std::erase_if(mPresentTimes, [oldest](const auto& entry) { return entry.first < oldest; });
+        }
+    }
+
+    void FrameProfiler::presentWaitThread(const std::stop_token& stopToken)
+    {
+        constexpr uint64_t timeout = 50'000'000;    // ns, bounds the delay of retireSwapchain and shutdown
+
+        std::unique_lock lock(mPresentMutex);
+        while (!stopToken.stop_requested())
+        {
+            if (!mPresentCondition.wait(lock, stopToken, [this] { return !mPresentWaits.empty(); }))
+            {
+                break;
+            }
+
+            const PresentWait presentWait = mPresentWaits.front();
+            mPresentWaits.pop_front();
+            mWaiting = true;
+
+            Clock::time_point presentTime;
+            bool              done = false;
+            while (!done && !stopToken.stop_requested() && !mRetired)
+            {
+                lock.unlock();
+                try
+                {
+                    const vk::Result result = mDevice->getHandle().waitForPresentKHR(presentWait.swapchain, presentWait.presentId, timeout);
+                    if (result != vk::Result::eTimeout)
+                    {
+                        presentTime = Clock::now();
+                        done        = true;
+                    }
+                }
+                catch (const vk::SystemError&)
+                {
+                    // Out of date or surface lost, the present completed without a usable time.
+                    done = true;
+                }
+                lock.lock();
+            }
+
+            mPresentTimes[presentWait.presentId] = presentTime;
+            mWaiting = false;
+            mPresentCondition.notify_all();
+        }
+    }
+
+    double FrameProfiler::toMs(const Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
@@ -9,33 +9,35 @@ namespace nbl
     Image::Image(const ImageCreateInfo& createInfo)
     : IAttachmentSource()
     , mDevice(createInfo.pDevice)
+    , mAliased(createInfo.aliasAllocation != nullptr)
     , mProperties(makeProperties(createInfo))
     , mDebugName(createInfo.debugName)
     {
         /**
          * Create Image
          */
-        auto imageCreateInfo = vk::ImageCreateInfo()
-            .setFormat(mProperties.format)
-            .setExtent({ mProperties.extent.width, mProperties.extent.height, 1 })
-            .setSamples(mProperties.sampleCount)
-            .setUsage(createInfo.usageFlags)
-            .setTiling(createInfo.tiling)
-            .setArrayLayers(1)
-            .setMipLevels(1)
-            .setImageType(vk::ImageType::e2D)
-            .setSharingMode(vk::SharingMode::eExclusive)
-            .setInitialLayout(vk::ImageLayout::eUndefined);
-    
-        VmaAllocationCreateInfo allocationInfo {};
-        allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    
+        auto imageCreateInfo = makeImageCreateInfo(createInfo, mProperties);
         const auto* pImageInfo = reinterpret_cast<VkImageCreateInfo*>(&imageCreateInfo);
         auto* pImage = reinterpret_cast<VkImage*>(&mImage);
-        nbl_VK_C_RESULT(
-            vmaCreateImage(mDevice->getAllocator(), pImageInfo, &allocationInfo, pImage, &mAllocation, &mAllocationInfo)
-        );
-    
+
+        if (mAliased)
+        {
+            nbl_VK_C_RESULT(
+                vmaCreateAliasingImage2(mDevice->getAllocator(), createInfo.aliasAllocation, createInfo.aliasOffset, pImageInfo, pImage)
+            );
+        }
+        else
+        {
+            VmaAllocationCreateInfo allocationInfo {};
+            allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+            nbl_VK_C_RESULT(
+                vmaCreateImage(mDevice->getAllocator(), pImageInfo, &allocationInfo, pImage, &mAllocation, &mAllocationInfo)
+            );
+
+            mDevice->getMemoryTracker()->onAllocate(mAllocation, "Image", mDebugName);
+        }
+
         mDevice->nameObject<vk::Image>({
             .debugName = mDebugName,
             .handle = mImage,
@@ -110,10 +112,24 @@ namespace nbl
     
     Image::~Image()
     {
-        if (!mSwapchainImage)
+        if (mSwapchainImage)
         {
-            vmaDestroyImage(mDevice->getAllocator(), mImage, mAllocation);
+            return;
         }
+
+        mDevice->getDeletionQueue()->push([pDevice = mDevice, image = mImage, imageView = mImageView, sampler = mSampler,
+                                           allocation = mAllocation, aliased = mAliased]() {
+            pDevice->getHandle().destroy(sampler);
+            pDevice->getHandle().destroy(imageView);
+            if (aliased)
+            {
+                // Memory belongs to the RenderGraph.
+                pDevice->getHandle().destroy(image);
+                return;
+            }
+            pDevice->getMemoryTracker()->onFree(allocation);
+            vmaDestroyImage(pDevice->getAllocator(), image, allocation);
+        });
     }
     
     void Image::blitImage(const BlitImageInfo& blitInfo)
@@ -187,6 +203,30 @@ namespace nbl
         return properties;
     }
     
+    vk::ImageCreateInfo Image::makeImageCreateInfo(const ImageCreateInfo& imageInfo, const ImageProperties& properties)
+    {
+        return vk::ImageCreateInfo()
+            .setFormat(properties.format)
+            .setExtent({ properties.extent.width, properties.extent.height, 1 })
+            .setSamples(properties.sampleCount)
+            .setUsage(imageInfo.usageFlags)
+            .setTiling(imageInfo.tiling)
+            .setArrayLayers(1)
+            .setMipLevels(1)
+            .setImageType(vk::ImageType::e2D)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined);
+    }
+
+    vk::MemoryRequirements Image::getMemoryRequirements(const ImageCreateInfo& createInfo)
+    {
+        const auto imageCreateInfo = makeImageCreateInfo(createInfo, makeProperties(createInfo));
+        const auto requirementsInfo = vk::DeviceImageMemoryRequirements()
+            .setPCreateInfo(&imageCreateInfo);
+
+        return createInfo.pDevice->getHandle().getImageMemoryRequirements(requirementsInfo).memoryRequirements;
+    }
+
     bool Image::isDepthFormat(const vk::Format format)
     {
         static std::set depthFormats = {
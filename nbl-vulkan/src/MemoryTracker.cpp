@@ -0,0 +1,196 @@
+#include "MemoryTracker.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <ranges>
+#include <fmt/format.h>
+#include "Util.hpp"
+
+namespace nbl
+{
+    MemoryTracker::MemoryTracker(const VmaAllocator allocator)
+    : mAllocator(allocator)
+    {
+        const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+        vmaGetMemoryProperties(mAllocator, &pMemoryProperties);
+
+        mHeaps.resize(pMemoryProperties->memoryHeapCount);
+        for (uint32_t i = 0; i < pMemoryProperties->memoryHeapCount; i++)
+        {
+            mHeaps[i].size        = pMemoryProperties->memoryHeaps[i].size;
+            mHeaps[i].deviceLocal = pMemoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+        }
+
+        update(0);
+    }
+
+    void MemoryTracker::onAllocate(const VmaAllocation allocation, const std::string& category, const std::string& name)
+    {
+        VmaAllocationInfo allocationInfo = {};
+        vmaGetAllocationInfo(mAllocator, allocation, &allocationInfo);
+
+        const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+        vmaGetMemoryProperties(mAllocator, &pMemoryProperties);
+
+        const Record record = {
+            .category  = category,
+            .name      = name,
+            .size      = allocationInfo.size,
+            .heapIndex = pMemoryProperties->memoryTypes[allocationInfo.memoryType].heapIndex,
+        };
+
+        std::lock_guard lock(mMutex);
+        mCategories[record.category].add(record.size);
+        mHeaps[record.heapIndex].tracked.add(record.size);
+        checkBudget(record.heapIndex, record);
+        mRecords.emplace(allocation, record);
+    }
+
+    void MemoryTracker::onFree(const VmaAllocation allocation)
+    {
+        std::lock_guard lock(mMutex);
+        const auto it = mRecords.find(allocation);
+        if (it == std::end(mRecords))
+        {
+            return;
+        }
+
+        const Record& record = it->second;
+        mCategories[record.category].remove(record.size);
+        mHeaps[record.heapIndex].tracked.remove(record.size);
+        mRecords.erase(it);
+    }
+
+    void MemoryTracker::update(const uint32_t frameIndex)
+    {
+        vmaSetCurrentFrameIndex(mAllocator, frameIndex);
+
+        std::vector<VmaBudget> budgets(mHeaps.size());
+        vmaGetHeapBudgets(mAllocator, budgets.data());
+
+        std::lock_guard lock(mMutex);
+        for (size_t i = 0; i < mHeaps.size(); i++)
+        {
+            mHeaps[i].usage  = budgets[i].usage;
+            mHeaps[i].budget = budgets[i].budget;
+        }
+    }
+
+    void MemoryTracker::checkBudget(const uint32_t heapIndex, const Record& record)
+    {
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(mAllocator, budgets);
+
+        MemoryHeapUsage& heap = mHeaps[heapIndex];
+        heap.usage  = budgets[heapIndex].usage;
+        heap.budget = budgets[heapIndex].budget;
+
+        if (heap.budget == 0)
+        {
+            return;
+        }
+
+        const double ratio = static_cast<double>(heap.usage) / static_cast<double>(heap.budget);
+        if (ratio >= mWarningThreshold)
+        {
+            fmt::println("[MemoryTracker] {} ({}, {:.2f} MiB) brings heap {} to {:.1f}% of its budget ({:.2f} / {:.2f} MiB)",
+                record.name, record.category, record.size / (1024.0 * 1024.0), heapIndex, ratio * 100.0,
+                heap.usage / (1024.0 * 1024.0), heap.budget / (1024.0 * 1024.0));
+        }
+    }
+
+    std::vector<MemoryHeapUsage> MemoryTracker::getHeapUsage() const
+    {
+        std::lock_guard lock(mMutex);
+        return mHeaps;
+    }
+
+    std::map<std::string, MemoryUsage> MemoryTracker::getCategoryUsage() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCategories;
+    }
+
+    uint64_t MemoryTracker::getUsageByName(const std::string& namePrefix) const
+    {
+        std::lock_guard lock(mMutex);
+        uint64_t result = 0;
+        for (const auto& record : mRecords | std::views::values)
+        {
+            if (record.name.starts_with(namePrefix))
+            {
+                result += record.size;
+            }
+        }
+        return result;
+    }
+
+    static std::string escapeJson(const std::string& value)
+    {
+        std::string result;
+        result.reserve(value.size());
+        for (const char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result;
+    }
+
+    std::string MemoryTracker::toJson() const
+    {
+        std::lock_guard lock(mMutex);
+
+        std::string result = "{\n  \"heaps\": [\n";
+        for (size_t i = 0; i < mHeaps.size(); i++)
+        {
+            const auto& heap = mHeaps[i];
+            result += fmt::format(
+                "    {{ \"index\": {}, \"deviceLocal\": {}, \"size\": {}, \"budget\": {}, \"usage\": {}, \"tracked\": {}, \"trackedPeak\": {} }}{}\n",
+                i, heap.deviceLocal, heap.size, heap.budget, heap.usage, heap.tracked.current, heap.tracked.peak,
+                i + 1 < mHeaps.size() ? "," : "");
+        }
+
+        result += "  ],\n  \"categories\": {\n";
+        size_t n = 0;
+        for (const auto& [category, usage] : mCategories)
+        {
+            result += fmt::format("    \"{}\": {{ \"current\": {}, \"peak\": {}, \"count\": {} }}{}\n",
+                escapeJson(category), usage.current, usage.peak, usage.count, ++n < mCategories.size() ? "," : "");
+        }
+
+        // Largest first
+        std::vector<const Record*> records;
+        records.reserve(mRecords.size());
+        for (const auto& record : mRecords | std::views::values)
+        {
+            records.push_back(&record);
+        }
+        std::ranges::sort(records, std::greater{}, &Record::size);
+
+        result += "  },\n  \"allocations\": [\n";
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            result += fmt::format("    {{ \"name\": \"{}\", \"category\": \"{}\", \"size\": {}, \"heap\": {} }}{}\n",
+                escapeJson(records[i]->name), escapeJson(records[i]->category), records[i]->size, records[i]->heapIndex,
+                i + 1 < records.size() ? "," : "");
+        }
+        result += "  ]\n}\n";
+
+        return result;
+    }
+
+    void MemoryTracker::writeJson(const std::string& filePath) const
+    {
+        std::ofstream file(filePath);
+        if (!file)
+        {
+            throw RHIError(fmt::format("Failed to open {} for writing", filePath));
+        }
+        file << toJson();
+    }
+}
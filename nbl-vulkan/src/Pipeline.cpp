@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <fmt/format.h>
+#include "Descriptor.hpp"
 #include "Device.hpp"
 #include "RenderPass.hpp"
 
@@ -178,6 +179,20 @@ namespace nbl
             throw error;
         }
 
+        std::vector<vk::SpecializationMapEntry> specializationEntries;
+        std::vector<uint32_t>                   specializationData;
+        for (const auto& [id, value] : createInfo.specializationConstants)
+        {
+            specializationEntries.emplace_back(id, static_cast<uint32_t>(specializationData.size() * sizeof(uint32_t)), sizeof(uint32_t));
+            specializationData.push_back(value);
+        }
+
+        const auto specializationInfo = vk::SpecializationInfo()
+            .setMapEntryCount(specializationEntries.size())
+            .setPMapEntries(specializationEntries.data())
+            .setDataSize(specializationData.size() * sizeof(uint32_t))
+            .setPData(specializationData.data());
+
         std::vector<vk::ShaderModule> shaders(createInfo.shaderCreateInfos.size());
         std::vector<vk::PipelineShaderStageCreateInfo> shaderStageInfos(createInfo.shaderCreateInfos.size());
         for (size_t index = 0; index < createInfo.shaderCreateInfos.size(); index++)
@@ -198,7 +213,8 @@ namespace nbl
             shaderStageInfos[index] = vk::PipelineShaderStageCreateInfo()
                 .setStage(shaderInfo.shaderStage)
                 .setModule(shaders[index])
-                .setPName(shaderInfo.entryPoint);
+                .setPName(shaderInfo.entryPoint)
+                .setPSpecializationInfo(specializationEntries.empty() ? nullptr : &specializationInfo);
         }
 
         if (createInfo.pipelineType == PipelineType::Graphics)
@@ -221,6 +237,11 @@ namespace nbl
                 .setRenderPass(nullptr)
                 .setPNext(nullptr);
 
+            if (createInfo.useDescriptorBuffers)
+            {
+                graphicsPipelineCreateInfo.setFlags(vk::PipelineCreateFlagBits::eDescriptorBufferEXT);
+            }
+
             if (createInfo.pRenderPass)
             {
                 for (auto&& colorAttachment : createInfo.pRenderPass->mColorAttachments)
@@ -258,7 +279,7 @@ namespace nbl
                 .setRenderPass(nullptr)
                 .setPNext(&renderingInfo);
 
-            nbl_VK_TRY(mPipeline = mDevice->getHandle().createGraphicsPipeline(nullptr, graphicsPipelineCreateInfo).value;)
+            nbl_VK_TRY(mPipeline = mDevice->getHandle().createGraphicsPipeline(createInfo.pipelineCache, graphicsPipelineCreateInfo).value;)
         }
 
         if (createInfo.pipelineType == PipelineType::Compute)
@@ -272,23 +293,46 @@ namespace nbl
                 throw;
             }
 
-            const auto computeCreateInfo = vk::ComputePipelineCreateInfo()
+            auto computeCreateInfo = vk::ComputePipelineCreateInfo()
                 .setLayout(mPipelineLayout)
                 .setStage(*it);
 
-            nbl_VK_RESULT(mDevice->getHandle().createComputePipelines({}, 1, &computeCreateInfo, nullptr, &mPipeline));
+            if (createInfo.useDescriptorBuffers)
+            {
+                computeCreateInfo.setFlags(vk::PipelineCreateFlagBits::eDescriptorBufferEXT);
+            }
+
+            nbl_VK_RESULT(mDevice->getHandle().createComputePipelines(createInfo.pipelineCache, 1, &computeCreateInfo, nullptr, &mPipeline));
         }
 
         mDevice->nameObject<vk::Pipeline>({
             .debugName = createInfo.debugName,
             .handle    = mPipeline,
         });
+
+        // Modules are only needed during pipeline creation.
+        for (const vk::ShaderModule& shader : shaders)
+        {
+            mDevice->getHandle().destroyShaderModule(shader);
+        }
+    }
+
+    void Pipeline::bindDescriptor(const vk::CommandBuffer& commandBuffer, const Descriptor* pDescriptor, const size_t i, const uint32_t firstSet, const uint32_t bufferIndex) const
+    {
+        pDescriptor->bind(commandBuffer, mBindPoint, mPipelineLayout, i, firstSet, bufferIndex);
+    }
+
+    void Pipeline::pushDescriptor(const vk::CommandBuffer& commandBuffer, const Descriptor* pDescriptor, const void* pData, const size_t size, const uint32_t set) const
+    {
+        pDescriptor->pushWithTemplate(commandBuffer, mBindPoint, mPipelineLayout, pData, size, set);
     }
 
     Pipeline::~Pipeline()
     {
-        mDevice->getHandle().destroyPipeline(mPipeline);
-        mDevice->getHandle().destroyPipelineLayout(mPipelineLayout);
+        mDevice->getDeletionQueue()->push([device = mDevice->getHandle(), pipeline = mPipeline, pipelineLayout = mPipelineLayout]() {
+            device.destroyPipeline(pipeline);
+            device.destroyPipelineLayout(pipelineLayout);
+        });
     }
 
     vk::PipelineBindPoint Pipeline::toBindPoint(const PipelineType type)
@@ -0,0 +1,269 @@
+#include "PipelineCompiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <fmt/format.h>
+
+#include "Common.hpp"
+#include "Device.hpp"
+
+namespace nbl
+{
+    PipelineCompiler::PipelineCompiler(const PipelineCompilerCreateInfo& createInfo)
+    : mCacheFilePath(createInfo.cacheFilePath)
+    , mDevice(createInfo.pDevice)
+    {
+        const std::vector<char> cacheData = loadCacheData();
+
+        // Not externally synchronized, workers share it without locking.
+        const auto pipelineCacheCreateInfo = vk::PipelineCacheCreateInfo()
+            .setInitialDataSize(cacheData.size())
+            .setPInitialData(cacheData.data());
+
+        nbl_VK_TRY(mPipelineCache = mDevice->getHandle().createPipelineCache(pipelineCacheCreateInfo);)
+        mDevice->nameObject<vk::PipelineCache>({
+            .debugName = "Shared Pipeline Cache",
+            .handle    = mPipelineCache,
+        });
+
+        const uint32_t threadCount = createInfo.threadCount > 0
+            ? createInfo.threadCount
+            : std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            mWorkers.emplace_back([this](const std::stop_token& stopToken) { workerThread(stopToken); });
+        }
+    }
+
+    PipelineCompiler::~PipelineCompiler()
+    {
+        // Requests being compiled finish, queued ones are abandoned.
+        for (auto& worker : mWorkers)
+        {
+            worker.request_stop();
+        }
+        mWorkers.clear();
+
+        if (!mCacheFilePath.empty())
+        {
+            saveCache();
+        }
+
+        mDevice->getHandle().destroy(mPipelineCache);
+    }
+
+    PipelineHandle PipelineCompiler::compile(const PipelineCreateInfo& createInfo, const bool urgent)
+    {
+        Request request = {
+            .createInfo  = createInfo,
+            .requestTime = Clock::now(),
+        };
+
+        PipelineHandle handle;
+        {
+            std::lock_guard lock(mMutex);
+            request.id = mNextRequestId++;
+            handle     = PipelineHandle(request.promise.get_future().share(), request.id);
+
+            if (urgent)
+            {
+                mRequests.push_front(std::move(request));
+            }
+            else
+            {
+                mRequests.push_back(std::move(request));
+            }
+        }
+        mCondition.notify_one();
+
+        return handle;
+    }
+
+    std::unique_ptr<Pipeline> PipelineCompiler::compileNow(const PipelineCreateInfo& createInfo)
+    {
+        return build(createInfo, Clock::now());
+    }
+
+    bool PipelineCompiler::compileQueued(const PipelineHandle& handle)
+    {
+        Request request;
+        {
+            std::lock_guard lock(mMutex);
+            const auto it = std::ranges::find(mRequests, handle.getRequestId(), &Request::id);
+            if (it == std::end(mRequests))
+            {
+                return false;
+            }
+
+            request = std::move(*it);
+            mRequests.erase(it);
+            mActiveCount++;
+        }
+
+        try
+        {
+            request.promise.set_value(build(std::move(request.createInfo), request.requestTime));
+        }
+        catch (...)
+        {
+            request.promise.set_exception(std::current_exception());
+        }
+
+        std::lock_guard lock(mMutex);
+        mActiveCount--;
+        return true;
+    }
+
+    void PipelineCompiler::cancel(const std::span<const PipelineHandle> handles)
+    {
+        // Promises are destroyed outside the lock, abandoning them wakes up waiting threads.
+        std::vector<Request> cancelled;
+        {
+            std::lock_guard lock(mMutex);
+            for (const PipelineHandle& handle : handles)
+            {
+                const auto it = std::ranges::find(mRequests, handle.getRequestId(), &Request::id);
+                if (it != std::end(mRequests))
+                {
+                    cancelled.push_back(std::move(*it));
+                    mRequests.erase(it);
+                }
+            }
+        }
+    }
+
+    std::vector<PipelineCompileResult> PipelineCompiler::getResults() const
+    {
+        std::lock_guard lock(mMutex);
+        return mResults;
+    }
+
+    uint32_t PipelineCompiler::getPendingCount() const
+    {
+        std::lock_guard lock(mMutex);
+        return static_cast<uint32_t>(mRequests.size()) + mActiveCount;
+    }
+
+    void PipelineCompiler::saveCache() const
+    {
+        const std::vector<uint8_t> cacheData = mDevice->getHandle().getPipelineCacheData(mPipelineCache);
+
+        std::ofstream file(mCacheFilePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            fmt::println("[Notice] Failed to write pipeline cache: {}", mCacheFilePath);
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(cacheData.data()), static_cast<std::streamsize>(cacheData.size()));
+    }
+
+    void PipelineCompiler::workerThread(const std::stop_token& stopToken)
+    {
+        std::unique_lock lock(mMutex);
+        while (!stopToken.stop_requested())
+        {
+            if (!mCondition.wait(lock, stopToken, [this] { return !mRequests.empty(); }))
+            {
+                break;
+            }
+
+            Request request = std::move(mRequests.front());
+            mRequests.pop_front();
+            mActiveCount++;
+
+            lock.unlock();
+            try
+            {
+                request.promise.set_value(build(std::move(request.createInfo), request.requestTime));
+            }
+            catch (...)
+            {
+                request.promise.set_exception(std::current_exception());
+            }
+            lock.lock();
+
+            mActiveCount--;
+        }
+    }
+
+    std::unique_ptr<Pipeline> PipelineCompiler::build(PipelineCreateInfo createInfo, const Clock::time_point requestTime)
+    {
+        createInfo.pipelineCache = mPipelineCache;
+
+        const auto begin = Clock::now();
+
+        PipelineCompileResult result = {
+            .debugName = createInfo.debugName,
+            .queueTime = std::chrono::duration<double, std::milli>(begin - requestTime).count(),
+        };
+
+        std::unique_ptr<Pipeline> pipeline;
+        std::exception_ptr        error;
+        try
+        {
+            pipeline = Pipeline::createPipeline(createInfo);
+        }
+        catch (...)
+        {
+            error         = std::current_exception();
+            result.failed = true;
+        }
+
+        result.compileTime = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        fmt::println("[Notice] Pipeline \"{}\" {} in {:.2f} ms (queued for {:.2f} ms)",
+            result.debugName, result.failed ? "failed" : "compiled", result.compileTime, result.queueTime);
+
+        {
+            std::lock_guard lock(mMutex);
+            mResults.push_back(result);
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        return pipeline;
+    }
+
+    std::vector<char> PipelineCompiler::loadCacheData() const
+    {
+        if (mCacheFilePath.empty())
+        {
+            return {};
+        }
+
+        std::ifstream file(mCacheFilePath, std::ios::ate | std::ios::binary);
+        if (!file.is_open())
+        {
+            return {};
+        }
+
+        std::vector<char> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+        vk::PipelineCacheHeaderVersionOne header;
+        if (data.size() < sizeof(header))
+        {
+            return {};
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        const vk::PhysicalDeviceProperties& properties = mDevice->getProperties();
+        if (header.headerVersion != vk::PipelineCacheHeaderVersion::eOne
+            || header.vendorID != properties.vendorID
+            || header.deviceID != properties.deviceID
+            || header.pipelineCacheUUID != properties.pipelineCacheUUID)
+        {
+            fmt::println("[Notice] Pipeline cache {} was written by another device or driver, it is rebuilt.", mCacheFilePath);
+            return {};
+        }
+
+        return data;
+    }
+}
@@ -0,0 +1,194 @@
+#include "PipelineStatistics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <fmt/format.h>
+
+#include "Common.hpp"
+#include "Device.hpp"
+
+namespace nbl
+{
+    namespace
+    {
+        using Statistic = std::pair<vk::QueryPipelineStatisticFlagBits, uint64_t PipelineStatisticsResult::*>;
+
+        // Query results are written in the order of the flag bits.
+        constexpr std::array gStatistics = {
+            Statistic { vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations,   &PipelineStatisticsResult::vertexShaderInvocations   },
+            Statistic { vk::QueryPipelineStatisticFlagBits::eClippingInvocations,       &PipelineStatisticsResult::clippingInvocations       },
+            Statistic { vk::QueryPipelineStatisticFlagBits::eClippingPrimitives,        &PipelineStatisticsResult::clippingPrimitives        },
+            Statistic { vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations, &PipelineStatisticsResult::fragmentShaderInvocations },
+            Statistic { vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations,  &PipelineStatisticsResult::computeShaderInvocations  },
+            Statistic { vk::QueryPipelineStatisticFlagBits::eTaskShaderInvocationsEXT,  &PipelineStatisticsResult::taskShaderInvocations     },
+            Statistic { vk::QueryPipelineStatisticFlagBits::eMeshShaderInvocationsEXT,  &PipelineStatisticsResult::meshShaderInvocations     },
+        };
+    }
+
+    PipelineStatistics::PipelineStatistics(const PipelineStatisticsCreateInfo& createInfo)
+    : mScopes(std::max(1u, createInfo.frameCount))
+    , mFrameCount(std::max(1u, createInfo.frameCount))
+    , mScopeCount(std::max(1u, createInfo.scopeCount))
+    , mDevice(createInfo.pDevice)
+    {
+        const DeviceCapabilities& capabilities = mDevice->getCapabilities();
+        if (!capabilities.pipelineStatistics)
+        {
+            fmt::println("[Notice] Device does not support pipelineStatisticsQuery, pipeline statistics are unavailable.");
+            return;
+        }
+
+        for (const auto& [flag, member] : gStatistics)
+        {
+            const bool meshStatistic = flag == vk::QueryPipelineStatisticFlagBits::eTaskShaderInvocationsEXT
+                                    || flag == vk::QueryPipelineStatisticFlagBits::eMeshShaderInvocationsEXT;
+            if (meshStatistic && !capabilities.meshShaderQueries) continue;
+
+            mStatisticFlags |= flag;
+            mStatisticCount++;
+        }
+
+        const uint32_t queryCount = mFrameCount * mScopeCount;
+
+        const auto queryPoolCreateInfo = vk::QueryPoolCreateInfo()
+            .setQueryType(vk::QueryType::ePipelineStatistics)
+            .setQueryCount(queryCount)
+            .setPipelineStatistics(mStatisticFlags);
+
+        nbl_VK_TRY(mQueryPool = mDevice->getHandle().createQueryPool(queryPoolCreateInfo);)
+        mDevice->nameObject<vk::QueryPool>({
+            .debugName = "Pipeline Statistics",
+            .handle    = mQueryPool,
+        });
+        mDevice->getHandle().resetQueryPool(mQueryPool, 0, queryCount);
+
+        if (capabilities.meshShaderQueries)
+        {
+            const auto meshQueryPoolCreateInfo = vk::QueryPoolCreateInfo()
+                .setQueryType(vk::QueryType::eMeshPrimitivesGeneratedEXT)
+                .setQueryCount(queryCount);
+
+            nbl_VK_TRY(mMeshQueryPool = mDevice->getHandle().createQueryPool(meshQueryPoolCreateInfo);)
+            mDevice->nameObject<vk::QueryPool>({
+                .debugName = "Mesh Primitives Generated",
+                .handle    = mMeshQueryPool,
+            });
+            mDevice->getHandle().resetQueryPool(mMeshQueryPool, 0, queryCount);
+        }
+    }
+
+    PipelineStatistics::~PipelineStatistics()
+    {
+        for (const vk::QueryPool queryPool : { mQueryPool, mMeshQueryPool })
+        {
+            if (!queryPool) continue;
+            mDevice->getDeletionQueue()->push([device = mDevice->getHandle(), queryPool] {
+                device.destroy(queryPool);
+            });
+        }
+    }
+
+    uint32_t PipelineStatistics::allocate(const uint32_t frameIndex, const std::string& name, const bool meshPrimitives)
+    {
+        auto& scopes = mScopes[frameIndex];
+        if (!mQueryPool || scopes.size() >= mScopeCount)
+        {
+            return sInvalidScope;
+        }
+
+        scopes.push_back({ .name = name, .meshPrimitives = meshPrimitives && mMeshQueryPool });
+        return frameIndex * mScopeCount + static_cast<uint32_t>(scopes.size() - 1);
+    }
+
+    void PipelineStatistics::begin(const vk::CommandBuffer& commandBuffer, const uint32_t scope) const
+    {
+        if (scope == sInvalidScope) return;
+
+        commandBuffer.beginQuery(mQueryPool, scope, {});
+        if (mScopes[scope / mScopeCount][scope % mScopeCount].meshPrimitives)
+        {
+            commandBuffer.beginQuery(mMeshQueryPool, scope, {});
+        }
+    }
+
+    void PipelineStatistics::end(const vk::CommandBuffer& commandBuffer, const uint32_t scope) const
+    {
+        if (scope == sInvalidScope) return;
+
+        if (mScopes[scope / mScopeCount][scope % mScopeCount].meshPrimitives)
+        {
+            commandBuffer.endQuery(mMeshQueryPool, scope);
+        }
+        commandBuffer.endQuery(mQueryPool, scope);
+    }
+
+    void PipelineStatistics::resolve(const uint32_t frameIndex, const uint64_t frameNumber)
+    {
+        auto& scopes = mScopes[frameIndex];
+        if (scopes.empty()) return;
+
+        const uint32_t firstQuery = frameIndex * mScopeCount;
+        const auto     scopeCount = static_cast<uint32_t>(scopes.size());
+
+        // Counters followed by the availability word, scopes whose pass was never recorded stay unavailable.
+        const uint32_t        stride = mStatisticCount + 1;
+        std::vector<uint64_t> statistics(stride * scopeCount);
+        std::vector<uint64_t> meshPrimitives(2 * scopeCount);
+
+        // Pointer overload: returns eNotReady for unavailable queries instead of throwing.
+        const auto flags = vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability;
+        (void) mDevice->getHandle().getQueryPoolResults(
+            mQueryPool, firstQuery, scopeCount,
+            statistics.size() * sizeof(uint64_t), statistics.data(), stride * sizeof(uint64_t), flags);
+
+        if (mMeshQueryPool)
+        {
+            (void) mDevice->getHandle().getQueryPoolResults(
+                mMeshQueryPool, firstQuery, scopeCount,
+                meshPrimitives.size() * sizeof(uint64_t), meshPrimitives.data(), 2 * sizeof(uint64_t), flags);
+        }
+
+        for (uint32_t i = 0; i < scopeCount; i++)
+        {
+            const uint64_t* values = statistics.data() + i * stride;
+            if (values[mStatisticCount] == 0) continue;
+
+            PipelineStatisticsResult result = { .frameNumber = frameNumber };
+
+            uint32_t value = 0;
+            for (const auto& [flag, member] : gStatistics)
+            {
+                if (mStatisticFlags & flag)
+                {
+                    result.*member = values[value++];
+                }
+            }
+
+            if (scopes[i].meshPrimitives && meshPrimitives[2 * i + 1] != 0)
+            {
+                result.meshPrimitivesGenerated = meshPrimitives[2 * i];
+            }
+
+            mResults[scopes[i].name] = result;
+        }
+
+        // Host query reset (Vulkan 1.2)
+        mDevice->getHandle().resetQueryPool(mQueryPool, firstQuery, scopeCount);
+        if (mMeshQueryPool)
+        {
+            mDevice->getHandle().resetQueryPool(mMeshQueryPool, firstQuery, scopeCount);
+        }
+
+        scopes.clear();
+    }
+
+    std::optional<PipelineStatisticsResult> PipelineStatistics::getResult(const std::string& name) const
+    {
+        if (const auto it = mResults.find(name); it != std::end(mResults))
+        {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+}
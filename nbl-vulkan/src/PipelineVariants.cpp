@@ -0,0 +1,146 @@
+#include "PipelineVariants.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <vector>
+
+namespace nbl
+{
+    PipelineVariants::PipelineVariants(const PipelineVariantsCreateInfo& createInfo)
+    : mBaseCreateInfo(createInfo.baseCreateInfo)
+    , mCompiler(createInfo.pCompiler)
+    {
+    }
+
+    PipelineVariants::~PipelineVariants()
+    {
+        // Requests reference the render pass of the base create info: queued ones are dropped, active ones finish.
+        std::vector<PipelineHandle> variants;
+        for (const auto& [key, variant] : mVariants)
+        {
+            variants.push_back(variant);
+        }
+
+        if (mCompiler)
+        {
+            mCompiler->cancel(variants);
+        }
+
+        for (const PipelineHandle& variant : variants)
+        {
+            variant.wait();
+        }
+    }
+
+    const Pipeline* PipelineVariants::get(const SpecializationConstants& specialization)
+    {
+        const SpecializationConstants key = getKey(specialization);
+
+        std::promise<std::unique_ptr<Pipeline>> promise;
+        PipelineHandle                          variant;
+        bool                                    build = false;
+        {
+            std::lock_guard lock(mMutex);
+            auto [it, inserted] = mVariants.try_emplace(key);
+            if (inserted)
+            {
+                it->second = PipelineHandle(promise.get_future().share());
+                build = true;
+            }
+            variant = it->second;
+        }
+
+        // Built outside the lock, other variants stay available meanwhile.
+        if (build)
+        {
+            try
+            {
+                const PipelineCreateInfo createInfo = getCreateInfo(key);
+                promise.set_value(mCompiler ? mCompiler->compileNow(createInfo) : Pipeline::createPipeline(createInfo));
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+            }
+        }
+        else if (mCompiler && !variant.isReady())
+        {
+            // Still queued behind prepared variants: compiled here rather than waiting for the workers to reach it.
+            mCompiler->compileQueued(variant);
+        }
+
+        return variant.get();
+    }
+
+    const Pipeline* PipelineVariants::tryGet(const SpecializationConstants& specialization, const Pipeline* fallback)
+    {
+        if (!mCompiler)
+        {
+            return get(specialization);
+        }
+
+        const SpecializationConstants key = getKey(specialization);
+
+        std::lock_guard lock(mMutex);
+        auto it = mVariants.find(key);
+        if (it == std::end(mVariants))
+        {
+            // Someone is waiting for it, ahead of prepared variants.
+            it = mVariants.emplace(key, mCompiler->compile(getCreateInfo(key), true)).first;
+        }
+
+        return it->second.getOr(fallback);
+    }
+
+    void PipelineVariants::prepare(const std::span<const SpecializationConstants> specializations)
+    {
+        if (!mCompiler) return;
+
+        std::lock_guard lock(mMutex);
+        for (const SpecializationConstants& specialization : specializations)
+        {
+            SpecializationConstants key = getKey(specialization);
+            if (mVariants.contains(key)) continue;
+
+            PipelineHandle variant = mCompiler->compile(getCreateInfo(key));
+            mVariants.emplace(std::move(key), std::move(variant));
+        }
+    }
+
+    size_t PipelineVariants::getVariantCount() const
+    {
+        std::lock_guard lock(mMutex);
+        return mVariants.size();
+    }
+
+    SpecializationConstants PipelineVariants::getKey(const SpecializationConstants& specialization) const
+    {
+        SpecializationConstants key = specialization;
+        for (const SpecializationConstant& constant : mBaseCreateInfo.specializationConstants)
+        {
+            if (std::ranges::none_of(key, [&](const auto& c) { return c.id == constant.id; }))
+            {
+                key.push_back(constant);
+            }
+        }
+
+        std::ranges::sort(key, {}, &SpecializationConstant::id);
+        return key;
+    }
+
+    PipelineCreateInfo PipelineVariants::getCreateInfo(const SpecializationConstants& key) const
+    {
+        PipelineCreateInfo createInfo = mBaseCreateInfo;
+        createInfo.specializationConstants = key;
+
+        std::vector<std::string> constants;
+        for (const auto& [id, value] : key)
+        {
+            constants.push_back(fmt::format("{}={}", id, value));
+        }
+        createInfo.debugName = fmt::format("{} [{}]", mBaseCreateInfo.debugName, fmt::join(constants, ", "));
+
+        return createInfo;
+    }
+}
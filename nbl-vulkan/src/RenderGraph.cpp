@@ -0,0 +1,781 @@
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+#include <future>
+#include <ranges>
+#include <fmt/format.h>
+#include "Barrier.hpp"
+#include "Buffer.hpp"
+#include "CommandAllocator.hpp"
+#include "CommandQueue.hpp"
+#include "Device.hpp"
+#include "Image.hpp"
+
+namespace nbl
+{
+    std::string toString(const RenderGraphUsage usage) noexcept
+    {
+        switch (usage)
+        {
+            case RenderGraphUsage::TransferRead:        return "TransferRead";
+            case RenderGraphUsage::TransferWrite:       return "TransferWrite";
+            case RenderGraphUsage::IndirectRead:        return "IndirectRead";
+            case RenderGraphUsage::ComputeStorageRead:  return "ComputeStorageRead";
+            case RenderGraphUsage::ComputeStorageWrite: return "ComputeStorageWrite";
+            case RenderGraphUsage::VertexStorageRead:   return "VertexStorageRead";
+            case RenderGraphUsage::MeshStorageRead:     return "MeshStorageRead";
+            case RenderGraphUsage::GraphicsStorageWrite: return "GraphicsStorageWrite";
+            case RenderGraphUsage::FragmentSampled:     return "FragmentSampled";
+            case RenderGraphUsage::ColorAttachment:     return "ColorAttachment";
+            case RenderGraphUsage::DepthAttachment:     return "DepthAttachment";
+            case RenderGraphUsage::Present:             return "Present";
+            default:                                    return "Unknown";
+        }
+    }
+
+    /**
+     * Forwards to the physical Image of a transient resource, which is recreated when the graph is recompiled.
+     */
+    class RenderGraph::TransientImageSource final : public IAttachmentSource
+    {
+    public:
+        TransientImageSource(const RenderGraph* pGraph, const RenderGraphResource resource)
+        : mGraph(pGraph), mResource(resource) {}
+
+        vk::ImageView getAttachmentSource() const override
+        {
+            const Image* pImage = mGraph->mResources[mResource].physicalImage.get();
+            return pImage ? pImage->getImageView() : vk::ImageView();
+        }
+
+        vk::Format getFormat() const override
+        {
+            return mGraph->mResources[mResource].imageInfo.format;
+        }
+
+    private:
+        const RenderGraph*        mGraph;
+        const RenderGraphResource mResource;
+    };
+
+    RenderGraph::RenderGraph(const RenderGraphCreateInfo& createInfo)
+    : mDevice(createInfo.pDevice)
+    , mDebugName(createInfo.debugName)
+    {
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+        releaseTransientImages();
+    }
+
+    RenderGraphResource RenderGraph::createImage(const RenderGraphImageInfo& imageInfo)
+    {
+        if (const auto it = mResourceLookup.find(imageInfo.debugName); it != mResourceLookup.end())
+        {
+            // Changing the description (e.g. after a resize) changes the topology hash and recompiles the graph.
+            mResources[it->second].imageInfo = imageInfo;
+            return it->second;
+        }
+
+        const auto resource = static_cast<RenderGraphResource>(mResources.size());
+        mResources.push_back({
+            .name      = imageInfo.debugName,
+            .isImage   = true,
+            .imageInfo = imageInfo,
+            .source    = std::make_unique<TransientImageSource>(this, resource),
+        });
+        mResourceLookup[imageInfo.debugName] = resource;
+        return resource;
+    }
+
+    RenderGraphResource RenderGraph::importImage(const std::string& name, Image* pImage, const std::optional<RenderGraphUsage> finalUsage)
+    {
+        if (const auto it = mResourceLookup.find(name); it != mResourceLookup.end())
+        {
+            mResources[it->second].pImage     = pImage;
+            mResources[it->second].finalUsage = finalUsage;
+            return it->second;
+        }
+
+        const auto resource = static_cast<RenderGraphResource>(mResources.size());
+        mResources.push_back({
+            .name       = name,
+            .isImage    = true,
+            .isImported = true,
+            .finalUsage = finalUsage,
+            .pImage     = pImage,
+        });
+        mResourceLookup[name] = resource;
+        return resource;
+    }
+
+    RenderGraphResource RenderGraph::importBuffer(const std::string& name, Buffer* pBuffer)
+    {
+        if (const auto it = mResourceLookup.find(name); it != mResourceLookup.end())
+        {
+            mResources[it->second].pBuffer = pBuffer;
+            return it->second;
+        }
+
+        const auto resource = static_cast<RenderGraphResource>(mResources.size());
+        mResources.push_back({
+            .name       = name,
+            .isImage    = false,
+            .isImported = true,
+            .pBuffer    = pBuffer,
+        });
+        mResourceLookup[name] = resource;
+        return resource;
+    }
+
+    void RenderGraph::addPass(RenderGraphPassInfo passInfo)
+    {
+        for (const auto& access : passInfo.accesses)
+        {
+            if (access.resource >= mResources.size())
+            {
+                throw RHIError(fmt::format("{}: Pass {} uses an unknown resource {}", mDebugName, passInfo.name, access.resource));
+            }
+            if (!isAvailable(mResources[access.resource]))
+            {
+                throw RHIError(fmt::format("{}: Pass {} uses {}, which was not imported this frame",
+                    mDebugName, passInfo.name, mResources[access.resource].name));
+            }
+        }
+        mPasses.push_back(std::move(passInfo));
+    }
+
+    void RenderGraph::execute(const vk::CommandBuffer& commandBuffer, CommandAllocator* pAllocator)
+    {
+        if (const size_t hash = hashTopology(); mCompiledHash != hash)
+        {
+            compile();
+            mCompiledHash = hash;
+        }
+
+        // Barriers do not depend on the recorded commands, parallel passes are recorded up front.
+        std::vector<vk::CommandBuffer> secondaryCommandBuffers(mLivePasses.size());
+        if (pAllocator)
+        {
+            recordParallelPasses(pAllocator, secondaryCommandBuffers);
+        }
+
+        // Imported resources start from the state tracked on the Image / Buffer.
+        const auto fromTrackedState = [](const vk::PipelineStageFlags2 stages, const vk::AccessFlags2 access, const vk::ImageLayout layout) {
+            ResourceState state = { .layout = layout };
+            if (Barrier::hasWriteAccess(access))
+            {
+                state.writeStages = stages;
+                state.writeAccess = access;
+            }
+            else
+            {
+                state.readStages = stages;
+                state.readAccess = access;
+            }
+            return state;
+        };
+
+        std::vector<ResourceState> states(mResources.size());
+        for (const auto& [i, entry] : std::views::enumerate(mResources))
+        {
+            if (entry.isImported && entry.isImage && entry.pImage)
+            {
+                const ImageState imageState = entry.pImage->getState();
+                states[i] = fromTrackedState(imageState.stageFlags, imageState.accessFlags, imageState.layout);
+            }
+            else if (entry.isImported && entry.pBuffer)
+            {
+                const BufferState bufferState = entry.pBuffer->getState();
+                states[i] = fromTrackedState(bufferState.stageFlags, bufferState.accessFlags, vk::ImageLayout::eUndefined);
+            }
+        }
+
+        std::vector<vk::ImageMemoryBarrier2>  imageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+
+        const auto flushBarriers = [&]() {
+            if (imageBarriers.empty() && bufferBarriers.empty())
+            {
+                return;
+            }
+
+            const auto dependencyInfo = vk::DependencyInfo()
+                .setImageMemoryBarriers(imageBarriers)
+                .setBufferMemoryBarriers(bufferBarriers);
+
+            commandBuffer.pipelineBarrier2(dependencyInfo);
+            mIssuedBarriers += static_cast<uint32_t>(imageBarriers.size() + bufferBarriers.size());
+            mBarrierBatches++;
+            imageBarriers.clear();
+            bufferBarriers.clear();
+        };
+
+        for (const auto& [livePass, passIndex] : std::views::enumerate(mLivePasses))
+        {
+            const auto& pass = mPasses[passIndex];
+
+            // Usages of the same resource within a pass are merged into one transition.
+            std::vector<std::pair<RenderGraphResource, ResourceState>> requirements;
+            std::vector<bool>                                          writes;
+            for (const auto& access : pass.accesses)
+            {
+                const ResourceState usageState = getUsageState(access.usage);
+                const auto it = std::ranges::find(requirements, access.resource, &std::pair<RenderGraphResource, ResourceState>::first);
+                if (it == requirements.end())
+                {
+                    requirements.emplace_back(access.resource, usageState);
+                    writes.push_back(isWriteUsage(access.usage));
+                    continue;
+                }
+
+                auto& merged = it->second;
+                if (mResources[access.resource].isImage && merged.layout != usageState.layout)
+                {
+                    throw RHIError(fmt::format("{}: Pass {} uses {} in conflicting layouts",
+                        mDebugName, pass.name, mResources[access.resource].name));
+                }
+                merged.writeStages |= usageState.writeStages;
+                merged.writeAccess |= usageState.writeAccess;
+                merged.readStages  |= usageState.readStages;
+                merged.readAccess  |= usageState.readAccess;
+                writes[it - requirements.begin()] = writes[it - requirements.begin()] || isWriteUsage(access.usage);
+            }
+
+            for (const auto& [i, requirement] : std::views::enumerate(requirements))
+            {
+                const auto& [resource, dstState] = requirement;
+                const auto& entry = mResources[resource];
+
+                // First use of aliased memory: wait for the previous occupant, its contents are discarded.
+                if (!entry.isImported && entry.firstPass == livePass)
+                {
+                    states[resource] = mAllocations[entry.allocationIndex].state;
+                    states[resource].layout = vk::ImageLayout::eUndefined;
+                }
+
+                transition(resource, dstState, writes[i], states[resource], imageBarriers, bufferBarriers);
+            }
+
+            flushBarriers();
+
+            if (const vk::CommandBuffer secondary = secondaryCommandBuffers[livePass])
+            {
+                commandBuffer.executeCommands(1, &secondary);
+            }
+            else
+            {
+                commandBuffer.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT().setPLabelName(pass.name.c_str()));
+                pass.execute(commandBuffer);
+                commandBuffer.endDebugUtilsLabelEXT();
+            }
+
+            for (const auto& resource : requirements | std::views::keys)
+            {
+                if (const auto& entry = mResources[resource]; !entry.isImported && entry.lastPass == livePass)
+                {
+                    mAllocations[entry.allocationIndex].state = states[resource];
+                }
+            }
+        }
+
+        for (const auto& [i, entry] : std::views::enumerate(mResources))
+        {
+            if (entry.isImported && entry.isImage && entry.pImage && entry.finalUsage.has_value())
+            {
+                transition(i, getUsageState(entry.finalUsage.value()), false, states[i], imageBarriers, bufferBarriers);
+            }
+        }
+        flushBarriers();
+
+        for (auto&& [i, entry] : std::views::enumerate(mResources))
+        {
+            if (!entry.isImported)
+            {
+                continue;
+            }
+
+            // The flat tracked state only keeps the last writer, or the readers when nothing is pending.
+            const auto& state  = states[i];
+            const bool  writes = static_cast<bool>(state.writeStages) && !state.readStages;
+            const auto  stages = writes ? state.writeStages : state.readStages;
+            const auto  access = writes ? state.writeAccess : state.readAccess;
+
+            if (entry.isImage && entry.pImage)
+            {
+                entry.pImage->updateState({ .accessFlags = access, .layout = state.layout, .stageFlags = stages });
+            }
+            else if (entry.pBuffer)
+            {
+                entry.pBuffer->updateState({ .accessFlags = access, .stageFlags = stages });
+            }
+        }
+
+        Barrier::recordStatistics(mRequestedBarriers, mIssuedBarriers, mBarrierBatches);
+        mRequestedBarriers = 0;
+        mIssuedBarriers    = 0;
+        mBarrierBatches    = 0;
+
+        // Imports only last for one frame, the Image / Buffer may be destroyed or replaced before the next one.
+        for (auto& entry : mResources)
+        {
+            if (entry.isImported)
+            {
+                entry.pImage     = nullptr;
+                entry.pBuffer    = nullptr;
+                entry.finalUsage = std::nullopt;
+            }
+        }
+
+        mPasses.clear();
+    }
+
+    void RenderGraph::recordParallelPasses(CommandAllocator* pAllocator, std::vector<vk::CommandBuffer>& secondaryCommandBuffers) const
+    {
+        std::vector<uint32_t> parallelPasses;
+        for (const auto& [livePass, passIndex] : std::views::enumerate(mLivePasses))
+        {
+            if (mPasses[passIndex].parallel)
+            {
+                parallelPasses.push_back(static_cast<uint32_t>(livePass));
+            }
+        }
+
+        // Thread 0 belongs to the caller recording the primary command buffer.
+        const uint32_t workerCount = std::min(pAllocator->getThreadCount() - 1, static_cast<uint32_t>(parallelPasses.size()));
+        if (workerCount == 0)
+        {
+            return;
+        }
+
+        std::vector<std::future<void>> workers;
+        for (uint32_t worker = 0; worker < workerCount; worker++)
+        {
+            workers.push_back(std::async(std::launch::async, [&, worker]() {
+                for (size_t i = worker; i < parallelPasses.size(); i += workerCount)
+                {
+                    const uint32_t livePass = parallelPasses[i];
+                    const auto&    pass     = mPasses[mLivePasses[livePass]];
+
+                    CommandList commandList(CommandListCreateInfo {
+                        .commandBuffer = pAllocator->allocate(worker + 1, vk::CommandBufferLevel::eSecondary),
+                    });
+
+                    commandList.beginSecondary();
+                    commandList.handle().beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT().setPLabelName(pass.name.c_str()));
+                    pass.execute(commandList.handle());
+                    commandList.handle().endDebugUtilsLabelEXT();
+                    commandList.end();
+
+                    secondaryCommandBuffers[livePass] = commandList.handle();
+                }
+            }));
+        }
+
+        // Rethrows recording errors from the workers.
+        for (auto& worker : workers)
+        {
+            worker.get();
+        }
+    }
+
+    IAttachmentSource* RenderGraph::getAttachmentSource(const RenderGraphResource resource) const
+    {
+        const auto& entry = mResources.at(resource);
+        if (entry.isImported)
+        {
+            return entry.pImage;
+        }
+        return entry.source.get();
+    }
+
+    Image* RenderGraph::getImage(const RenderGraphResource resource) const
+    {
+        const auto& entry = mResources.at(resource);
+        return entry.isImported ? entry.pImage : entry.physicalImage.get();
+    }
+
+    void RenderGraph::compile()
+    {
+        // Walk the passes backwards, a pass is live if it writes a resource needed by an imported resource or a later live pass.
+        std::vector needed(mResources.size(), false);
+        for (const auto& [i, entry] : std::views::enumerate(mResources))
+        {
+            needed[i] = entry.isImported && isAvailable(entry);
+        }
+
+        std::vector live(mPasses.size(), false);
+        for (int32_t i = static_cast<int32_t>(mPasses.size()) - 1; i >= 0; i--)
+        {
+            const auto& pass = mPasses[i];
+            live[i] = pass.sideEffects || std::ranges::any_of(pass.accesses, [&](const RenderGraphAccess& access) {
+                return isWriteUsage(access.usage) && needed[access.resource];
+            });
+
+            if (live[i])
+            {
+                for (const auto& access : pass.accesses)
+                {
+                    needed[access.resource] = true;
+                }
+            }
+        }
+
+        mLivePasses.clear();
+        for (const auto& [i, isLive] : std::views::enumerate(live))
+        {
+            if (isLive)
+            {
+                mLivePasses.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        // Transient lifetimes in live pass indices
+        for (auto& entry : mResources)
+        {
+            entry.firstPass  = gInvalidIndex;
+            entry.lastPass   = gInvalidIndex;
+            entry.usageFlags = {};
+        }
+
+        for (const auto& [livePass, passIndex] : std::views::enumerate(mLivePasses))
+        {
+            for (const auto& access : mPasses[passIndex].accesses)
+            {
+                auto& entry = mResources[access.resource];
+                if (entry.isImported)
+                {
+                    continue;
+                }
+                if (entry.firstPass == gInvalidIndex)
+                {
+                    entry.firstPass = static_cast<int32_t>(livePass);
+                }
+                entry.lastPass    = static_cast<int32_t>(livePass);
+                entry.usageFlags |= getImageUsageFlags(access.usage);
+            }
+        }
+
+        releaseTransientImages();
+        allocateTransientImages();
+
+        mStatistics.passCount       = static_cast<uint32_t>(mPasses.size());
+        mStatistics.culledPassCount = static_cast<uint32_t>(mPasses.size() - mLivePasses.size());
+        mStatistics.compileCount++;
+    }
+
+    void RenderGraph::allocateTransientImages()
+    {
+        const auto makeImageCreateInfo = [&](const ResourceEntry& entry, const VmaAllocation allocation) -> ImageCreateInfo {
+            return {
+                .extent          = entry.imageInfo.extent,
+                .format          = entry.imageInfo.format,
+                .usageFlags      = entry.usageFlags,
+                .debugName       = entry.name,
+                .aliasAllocation = allocation,
+                .pDevice         = mDevice,
+            };
+        };
+
+        std::vector<std::pair<RenderGraphResource, vk::MemoryRequirements>> transientImages;
+        for (const auto& [i, entry] : std::views::enumerate(mResources))
+        {
+            if (!entry.isImported && entry.firstPass != gInvalidIndex)
+            {
+                transientImages.emplace_back(i, Image::getMemoryRequirements(makeImageCreateInfo(entry, nullptr)));
+            }
+        }
+
+        // Largest first, each image goes into the first allocation it does not overlap with in time.
+        std::ranges::sort(transientImages, std::ranges::greater(), [](const auto& image) { return image.second.size; });
+
+        mStatistics.transientImageCount = static_cast<uint32_t>(transientImages.size());
+        mStatistics.unaliasedBytes      = 0;
+
+        for (const auto& [resource, requirements] : transientImages)
+        {
+            auto& entry = mResources[resource];
+            mStatistics.unaliasedBytes += requirements.size;
+
+            const auto overlaps = [&](const RenderGraphResource other) {
+                const auto& otherEntry = mResources[other];
+                return entry.firstPass <= otherEntry.lastPass && otherEntry.firstPass <= entry.lastPass;
+            };
+
+            const auto it = std::ranges::find_if(mAllocations, [&](const TransientAllocation& allocation) {
+                return (allocation.requirements.memoryTypeBits & requirements.memoryTypeBits) != 0
+                    && std::ranges::none_of(allocation.images, overlaps);
+            });
+
+            if (it == mAllocations.end())
+            {
+                entry.allocationIndex = static_cast<int32_t>(mAllocations.size());
+                mAllocations.push_back({ .requirements = requirements, .images = { resource } });
+                continue;
+            }
+
+            entry.allocationIndex = static_cast<int32_t>(it - mAllocations.begin());
+            it->requirements.size            = std::max(it->requirements.size, requirements.size);
+            it->requirements.alignment       = std::max(it->requirements.alignment, requirements.alignment);
+            it->requirements.memoryTypeBits &= requirements.memoryTypeBits;
+            it->images.push_back(resource);
+        }
+
+        mStatistics.allocationCount = static_cast<uint32_t>(mAllocations.size());
+        mStatistics.transientBytes  = 0;
+
+        for (auto&& [i, allocation] : std::views::enumerate(mAllocations))
+        {
+            VmaAllocationCreateInfo allocationCreateInfo {};
+            allocationCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+            const VkMemoryRequirements requirements = allocation.requirements;
+            nbl_VK_C_RESULT(vmaAllocateMemory(mDevice->getAllocator(), &requirements, &allocationCreateInfo, &allocation.allocation, nullptr));
+
+            mDevice->getMemoryTracker()->onAllocate(allocation.allocation, "RenderGraph", fmt::format("{} Transient Memory {}", mDebugName, i));
+            mStatistics.transientBytes += allocation.requirements.size;
+
+            std::ranges::sort(allocation.images, std::ranges::less(), [&](const RenderGraphResource r) { return mResources[r].firstPass; });
+            for (const auto resource : allocation.images)
+            {
+                auto& entry = mResources[resource];
+                entry.physicalImage = Image::createImage(makeImageCreateInfo(entry, allocation.allocation));
+            }
+        }
+    }
+
+    void RenderGraph::releaseTransientImages()
+    {
+        if (mAllocations.empty())
+        {
+            return;
+        }
+
+        // In-flight frames may still use the images, the aliased images are queued before their memory.
+        for (auto& entry : mResources)
+        {
+            entry.physicalImage.reset();
+            entry.allocationIndex = gInvalidIndex;
+        }
+
+        for (const auto& allocation : mAllocations)
+        {
+            mDevice->getDeletionQueue()->push([pDevice = mDevice, allocation = allocation.allocation]() {
+                pDevice->getMemoryTracker()->onFree(allocation);
+                vmaFreeMemory(pDevice->getAllocator(), allocation);
+            });
+        }
+        mAllocations.clear();
+    }
+
+    bool RenderGraph::isAvailable(const ResourceEntry& entry)
+    {
+        return !entry.isImported || entry.pImage || entry.pBuffer;
+    }
+
+    size_t RenderGraph::hashTopology() const
+    {
+        size_t seed = 0;
+        const auto combine = [&seed]<class T>(const T& value) {
+            seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        };
+
+        for (const auto& pass : mPasses)
+        {
+            combine(pass.name);
+            combine(pass.sideEffects);
+            combine(pass.parallel);
+            for (const auto& access : pass.accesses)
+            {
+                combine(access.resource);
+                combine(static_cast<uint32_t>(access.usage));
+            }
+        }
+
+        for (const auto& entry : mResources)
+        {
+            if (entry.isImported)
+            {
+                combine(isAvailable(entry));
+            }
+            else
+            {
+                combine(entry.imageInfo.extent.width);
+                combine(entry.imageInfo.extent.height);
+                combine(static_cast<uint32_t>(entry.imageInfo.format));
+            }
+        }
+
+        return seed;
+    }
+
+    void RenderGraph::transition(
+        const RenderGraphResource              resource,
+        const ResourceState&                   dstState,
+        const bool                             write,
+        ResourceState&                         state,
+        std::vector<vk::ImageMemoryBarrier2>&  imageBarriers,
+        std::vector<vk::BufferMemoryBarrier2>& bufferBarriers)
+    {
+        mRequestedBarriers++;
+
+        const auto& entry        = mResources[resource];
+        const auto  oldLayout    = state.layout;
+        const bool  layoutChange = entry.isImage && oldLayout != dstState.layout;
+        const auto  dstStages    = dstState.writeStages | dstState.readStages;
+        const auto  dstAccess    = dstState.writeAccess | dstState.readAccess;
+
+        vk::PipelineStageFlags2 srcStages;
+        vk::AccessFlags2        srcAccess;
+
+        if (!write && !layoutChange)
+        {
+            // Read after read: only wait for the last write if it is not yet visible to these stages.
+            const bool visible = (state.readStages & dstStages) == dstStages && (state.readAccess & dstAccess) == dstAccess;
+            if (visible || !state.writeStages)
+            {
+                state.readStages |= dstStages;
+                state.readAccess |= dstAccess;
+                return;
+            }
+
+            srcStages = state.writeStages;
+            srcAccess = state.writeAccess;
+            state.readStages |= dstStages;
+            state.readAccess |= dstAccess;
+        }
+        else
+        {
+            // Write after read only needs an execution dependency, write after write also flushes the previous writes.
+            srcStages = state.writeStages | state.readStages;
+            srcAccess = state.writeAccess;
+
+            if (write)
+            {
+                state = {
+                    .writeStages = dstStages,
+                    .writeAccess = dstAccess,
+                    .layout      = dstState.layout,
+                };
+            }
+            else
+            {
+                // The layout transition is visible to the destination stages, later readers chain on them.
+                state = {
+                    .writeStages = dstStages,
+                    .readStages  = dstStages,
+                    .readAccess  = dstAccess,
+                    .layout      = dstState.layout,
+                };
+            }
+        }
+
+        if (entry.isImage)
+        {
+            const Image* pImage = getImage(resource);
+            imageBarriers.push_back(vk::ImageMemoryBarrier2()
+                .setSrcStageMask(srcStages)
+                .setSrcAccessMask(srcAccess)
+                .setDstStageMask(dstStages)
+                .setDstAccessMask(dstAccess)
+                .setOldLayout(oldLayout)
+                .setNewLayout(dstState.layout)
+                .setSubresourceRange(pImage->getProperties().subresourceRange)
+                .setImage(pImage->getImage()));
+        }
+        else
+        {
+            bufferBarriers.push_back(vk::BufferMemoryBarrier2()
+                .setSrcStageMask(srcStages)
+                .setSrcAccessMask(srcAccess)
+                .setDstStageMask(dstStages)
+                .setDstAccessMask(dstAccess)
+                .setBuffer(entry.pBuffer->getHandle())
+                .setOffset(0)
+                .setSize(vk::WholeSize));
+        }
+    }
+
+    RenderGraph::ResourceState RenderGraph::getUsageState(const RenderGraphUsage usage)
+    {
+        using Stage  = vk::PipelineStageFlagBits2;
+        using Access = vk::AccessFlagBits2;
+        using Layout = vk::ImageLayout;
+
+        switch (usage)
+        {
+            case RenderGraphUsage::TransferRead:
+                return { .readStages = Stage::eTransfer, .readAccess = Access::eTransferRead, .layout = Layout::eTransferSrcOptimal };
+            case RenderGraphUsage::TransferWrite:
+                return { .writeStages = Stage::eTransfer, .writeAccess = Access::eTransferWrite, .layout = Layout::eTransferDstOptimal };
+            case RenderGraphUsage::IndirectRead:
+                return { .readStages = Stage::eDrawIndirect, .readAccess = Access::eIndirectCommandRead, .layout = Layout::eGeneral };
+            case RenderGraphUsage::ComputeStorageRead:
+                return { .readStages = Stage::eComputeShader, .readAccess = Access::eShaderStorageRead, .layout = Layout::eGeneral };
+            case RenderGraphUsage::ComputeStorageWrite:
+                return { .writeStages = Stage::eComputeShader, .writeAccess = Access::eShaderStorageRead | Access::eShaderStorageWrite, .layout = Layout::eGeneral };
+            case RenderGraphUsage::VertexStorageRead:
+                return { .readStages = Stage::eVertexShader, .readAccess = Access::eShaderStorageRead, .layout = Layout::eGeneral };
+            case RenderGraphUsage::MeshStorageRead:
+                return { .readStages = Stage::eTaskShaderEXT | Stage::eMeshShaderEXT, .readAccess = Access::eShaderStorageRead, .layout = Layout::eGeneral };
+            case RenderGraphUsage::GraphicsStorageWrite:
+                return {
+                    .writeStages = Stage::eTaskShaderEXT | Stage::eMeshShaderEXT | Stage::eFragmentShader,
+                    .writeAccess = Access::eShaderStorageRead | Access::eShaderStorageWrite,
+                    .layout      = Layout::eGeneral,
+                };
+            case RenderGraphUsage::FragmentSampled:
+                return { .readStages = Stage::eFragmentShader, .readAccess = Access::eShaderSampledRead, .layout = Layout::eShaderReadOnlyOptimal };
+            case RenderGraphUsage::ColorAttachment:
+                return {
+                    .writeStages = Stage::eColorAttachmentOutput,
+                    .writeAccess = Access::eColorAttachmentRead | Access::eColorAttachmentWrite,
+                    .layout      = Layout::eColorAttachmentOptimal,
+                };
+            case RenderGraphUsage::DepthAttachment:
+                return {
+                    .writeStages = Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+                    .writeAccess = Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite,
+                    .layout      = Layout::eDepthStencilAttachmentOptimal,
+                };
+            case RenderGraphUsage::Present:
+                // Color attachment output is the stage the next frame's image acquire semaphore waits on.
+                return { .readStages = Stage::eColorAttachmentOutput, .readAccess = Access::eNone, .layout = Layout::ePresentSrcKHR };
+            default:
+                throw RHIError(fmt::format("Unknown RenderGraphUsage {}", static_cast<int32_t>(usage)));
+        }
+    }
+
+    bool RenderGraph::isWriteUsage(const RenderGraphUsage usage)
+    {
+        switch (usage)
+        {
+            case RenderGraphUsage::TransferWrite:
+            case RenderGraphUsage::ComputeStorageWrite:
+            case RenderGraphUsage::GraphicsStorageWrite:
+            case RenderGraphUsage::ColorAttachment:
+            case RenderGraphUsage::DepthAttachment:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    vk::ImageUsageFlags RenderGraph::getImageUsageFlags(const RenderGraphUsage usage)
+    {
+        using enum vk::ImageUsageFlagBits;
+        switch (usage)
+        {
+            case RenderGraphUsage::TransferRead:        return eTransferSrc;
+            case RenderGraphUsage::TransferWrite:       return eTransferDst;
+            case RenderGraphUsage::ComputeStorageRead:
+            case RenderGraphUsage::ComputeStorageWrite:
+            case RenderGraphUsage::GraphicsStorageWrite: return eStorage;
+            case RenderGraphUsage::FragmentSampled:     return eSampled;
+            case RenderGraphUsage::ColorAttachment:     return eColorAttachment;
+            case RenderGraphUsage::DepthAttachment:     return eDepthStencilAttachment;
+            default:                                    return {};
+        }
+    }
+}
@@ -54,9 +54,50 @@ namespace nbl
             .setColorAttachmentCount(mColorAttachments.size())
             .setPDepthAttachment(&mDepthAttachmentInfo)
             .setPStencilAttachment(&mStencilAttachmentInfo);
+
+        for (const auto& colorAttachment : mColorAttachments)
+        {
+            mColorFormats.push_back(colorAttachment.pSource ? colorAttachment.pSource->getFormat() : vk::Format::eUndefined);
+        }
+
+        mInheritanceInfo = vk::CommandBufferInheritanceRenderingInfo()
+            .setColorAttachmentFormats(mColorFormats)
+            .setDepthAttachmentFormat(mDepthAttachment.pSource ? mDepthAttachment.pSource->getFormat() : vk::Format::eUndefined)
+            .setStencilAttachmentFormat(mStencilAttachment.pSource ? mStencilAttachment.pSource->getFormat() : vk::Format::eUndefined)
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1);
     }
 
     void RenderPass::execute(const vk::CommandBuffer& commandBuffer, const std::function<void(const vk::CommandBuffer&)>& lambda)
+    {
+        updateAttachmentViews();
+
+        commandBuffer.beginRendering(&mRenderingInfo);
+        lambda(commandBuffer);
+        commandBuffer.endRendering();
+    }
+
+    void RenderPass::execute(const vk::CommandBuffer& commandBuffer, const std::span<const vk::CommandBuffer> secondaryCommandBuffers)
+    {
+        updateAttachmentViews();
+
+        auto renderingInfo = mRenderingInfo;
+        renderingInfo.setFlags(vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+
+        commandBuffer.beginRendering(&renderingInfo);
+        if (!secondaryCommandBuffers.empty())
+        {
+            commandBuffer.executeCommands(secondaryCommandBuffers.size(), secondaryCommandBuffers.data());
+        }
+        commandBuffer.endRendering();
+    }
+
+    void RenderPass::setRenderArea(const vk::Rect2D& renderArea)
+    {
+        mRenderArea = renderArea;
+        mRenderingInfo.setRenderArea(mRenderArea);
+    }
+
+    void RenderPass::updateAttachmentViews()
     {
         if (mDepthAttachment.pSource)
         {
@@ -74,9 +115,5 @@ namespace nbl
                 info.setImageView(attachment.pSource->getAttachmentSource());
             }
         }
-
-        commandBuffer.beginRendering(&mRenderingInfo);
-        lambda(commandBuffer);
-        commandBuffer.endRendering();
     }
 }
@@ -0,0 +1,126 @@
+#include "RingBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fmt/format.h>
+#include "Device.hpp"
+
+namespace nbl
+{
+    static uint64_t alignUp(const uint64_t value, const uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    RingBuffer::RingBuffer(const RingBufferCreateInfo& createInfo)
+    : mFrameCount(std::max(createInfo.frameCount, 1u))
+    , mName(createInfo.debugName)
+    , mDevice(createInfo.pDevice)
+    {
+        const auto& limits = mDevice->getProperties().limits;
+        mMinAlignment = std::max({
+            mMinAlignment,
+            limits.minUniformBufferOffsetAlignment,
+            limits.minStorageBufferOffsetAlignment,
+            limits.nonCoherentAtomSize,
+        });
+        mFrameSize = alignUp(createInfo.frameSize, mMinAlignment);
+
+        using enum vk::BufferUsageFlagBits;
+        const auto bufferInfo = vk::BufferCreateInfo()
+            .setSize(mFrameSize * mFrameCount)
+            .setUsage(eUniformBuffer | eStorageBuffer | eIndirectBuffer | eTransferSrc | eShaderDeviceAddress);
+
+        // Prefer device-local host-visible memory (ReBAR / UMA), falls back to system memory.
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                        | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        const auto* pBufferInfo = reinterpret_cast<const VkBufferCreateInfo*>(&bufferInfo);
+        auto* pBuffer = reinterpret_cast<VkBuffer*>(&mBuffer);
+        nbl_VK_C_RESULT(
+            vmaCreateBuffer(mDevice->getAllocator(), pBufferInfo, &allocInfo,
+                pBuffer, &mAllocation, &mAllocationInfo)
+        );
+
+        mMapped = static_cast<std::byte*>(mAllocationInfo.pMappedData);
+
+        mDevice->getMemoryTracker()->onAllocate(mAllocation, "RingBuffer", mName);
+
+        VkMemoryPropertyFlags memoryFlags = 0;
+        vmaGetAllocationMemoryProperties(mDevice->getAllocator(), mAllocation, &memoryFlags);
+        mCoherent = (memoryFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+        mDevice->nameObject<vk::Buffer>({
+            .debugName = mName,
+            .handle = mBuffer,
+        });
+
+        const auto addressInfo = vk::BufferDeviceAddressInfo()
+            .setBuffer(mBuffer);
+        nbl_VK_TRY(mDeviceAddress = mDevice->getHandle().getBufferAddress(&addressInfo);)
+
+        beginFrame(0);
+    }
+
+    RingBuffer::~RingBuffer()
+    {
+        mDevice->getMemoryTracker()->onFree(mAllocation);
+        vmaDestroyBuffer(mDevice->getAllocator(), mBuffer, mAllocation);
+    }
+
+    RingAllocation RingBuffer::allocate(const uint64_t size, const uint64_t alignment)
+    {
+        const uint64_t align = std::max(alignment, mMinAlignment);
+
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        uint64_t offset;
+        do
+        {
+            offset = alignUp(head, align);
+            if (offset + size > mFrameEnd)
+            {
+                mFailedAllocations.fetch_add(1, std::memory_order_relaxed);
+                return {};
+            }
+        }
+        while (!mHead.compare_exchange_weak(head, offset + size, std::memory_order_relaxed));
+
+        return {
+            .pData   = mMapped + offset,
+            .address = mDeviceAddress + offset,
+            .offset  = offset,
+            .size    = size,
+        };
+    }
+
+    void RingBuffer::beginFrame(const uint32_t frameIndex)
+    {
+        if (const uint32_t failed = mFailedAllocations.exchange(0); failed > 0)
+        {
+            fmt::println("RingBuffer {}: {} allocations did not fit into {} bytes per frame.", mName, failed, mFrameSize);
+        }
+
+        mPeakUsedSize = std::max(mPeakUsedSize, getUsedSize());
+
+        mFrameBegin = mFrameSize * (frameIndex % mFrameCount);
+        mFrameEnd   = mFrameBegin + mFrameSize;
+        mHead.store(mFrameBegin, std::memory_order_relaxed);
+    }
+
+    void RingBuffer::flush() const
+    {
+        if (mCoherent)
+        {
+            return;
+        }
+
+        const uint64_t used = getUsedSize();
+        if (used > 0)
+        {
+            nbl_VK_C_RESULT(
+                vmaFlushAllocation(mDevice->getAllocator(), mAllocation, mFrameBegin, used));
+        }
+    }
+}
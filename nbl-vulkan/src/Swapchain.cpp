@@ -1,5 +1,6 @@
 #include "Swapchain.hpp"
 
+#include <algorithm>
 #include <fmt/format.h>
 #include "Device.hpp"
 #include "Image.hpp"
@@ -9,7 +10,8 @@ namespace nbl
 {
     Swapchain::Swapchain(const SwapchainCreateInfo& createInfo)
     : IAttachmentSource()
-    , mImageCount(createInfo.imageCount)
+    , mMinImageCount(createInfo.imageCount)
+    , mRequestedPresentMode(createInfo.presentMode)
     , mWindow(createInfo.pWindow)
     , mDevice(createInfo.pDevice)
     , mInstance(createInfo.instance)
@@ -22,37 +24,85 @@ namespace nbl
         createSwapchain();
         acquireImages();
         makeDynamicState();
+        wrapImages();
 
-        mAspectRatio = static_cast<float>(width) / static_cast<float>(height);
+        fmt::println("[Swapchain] {}x{}, {} images, present mode {}",
+            mExtent.width, mExtent.height, getImageCount(), vk::to_string(mPresentMode));
+    }
+
+    Swapchain::~Swapchain()
+    {
+        destroyImageViews();
+
+        mDevice->getHandle().destroySwapchainKHR(mSwapchain);
+
+        mInstance.destroySurfaceKHR(mSurface);
+    }
 
-        for (uint32_t i = 0; i < mImageCount; i++)
+    void Swapchain::recreate(const std::optional<vk::PresentModeKHR> presentMode)
+    {
+        if (presentMode.has_value())
         {
-            mWrappedImages.push_back(Image::createSwapchainImageWrapper({
-                .image = mImages[i],
-                .imageView = mImageViews[i],
-                .imageIndex = i,
-                .pDevice = mDevice,
-                .pSwapchain = this,
-            }));
+            mRequestedPresentMode = presentMode.value();
         }
+
+        const vk::SwapchainKHR oldSwapchain = mSwapchain;
+
+        checkSwapchainSupport();
+        createSwapchain(oldSwapchain);
+
+        // The old Swapchain is retired by the new one, its images are no longer acquired.
+        mWrappedImages.clear();
+        destroyImageViews();
+        mDevice->getHandle().destroySwapchainKHR(oldSwapchain);
+
+        acquireImages();
+        makeDynamicState();
+        wrapImages();
+        mLastAcquiredIndex = 0;
+
+        fmt::println("[Swapchain] Recreated {}x{}, {} images, present mode {}",
+            mExtent.width, mExtent.height, getImageCount(), vk::to_string(mPresentMode));
     }
 
-    Swapchain::~Swapchain()
+    vk::PresentModeKHR Swapchain::selectPresentMode(const vk::PresentModeKHR requested, const std::vector<vk::PresentModeKHR>& supported)
     {
-        for (const auto& imageView : mImageViews)
+        using enum vk::PresentModeKHR;
+
+        std::vector candidates = { requested };
+        if (requested == eMailbox)
         {
-            mDevice->getHandle().destroyImageView(imageView);
+            candidates.push_back(eImmediate);
+        }
+        if (requested == eImmediate)
+        {
+            candidates.push_back(eMailbox);
+        }
+        if (requested == eFifoRelaxed)
+        {
+            candidates.push_back(eFifo);
         }
-        mImageViews.clear();
 
-        mDevice->getHandle().destroySwapchainKHR(mSwapchain);
+        for (const auto candidate : candidates)
+        {
+            if (std::ranges::contains(supported, candidate))
+            {
+                return candidate;
+            }
+        }
 
-        mInstance.destroySurfaceKHR(mSurface);
+        // FIFO support is required by the specification.
+        return eFifo;
     }
 
-    void Swapchain::present(const vk::Semaphore waitSemaphore, const uint32_t imageIndex) const
+    bool Swapchain::present(const vk::Semaphore waitSemaphore, const uint32_t imageIndex, const uint64_t presentId) const
     {
+        const auto presentIdInfo = vk::PresentIdKHR()
+            .setSwapchainCount(1)
+            .setPPresentIds(&presentId);
+
         const auto presentInfo = vk::PresentInfoKHR()
+            .setPNext(presentId != 0 ? &presentIdInfo : nullptr)
             .setPWaitSemaphores(&waitSemaphore)
             .setWaitSemaphoreCount(1)
             .setPSwapchains(&mSwapchain)
@@ -60,11 +110,18 @@ namespace nbl
             .setImageIndices(imageIndex)
             .setPResults(nullptr);
 
-        if (const auto result = mDevice->getGraphicsQueue()->queue.presentKHR(&presentInfo);
-            result != vk::Result::eSuccess)
+        // Pointer overload: returns eErrorOutOfDateKHR instead of throwing.
+        const auto result = mDevice->getGraphicsQueue()->queue.presentKHR(&presentInfo);
+
+        if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR)
+        {
+            return false;
+        }
+        if (result != vk::Result::eSuccess)
         {
-            throw std::runtime_error("Failed to present to swapchain");
+            throw RHIError(result);
         }
+        return true;
     }
 
     void Swapchain::setScissorViewport(const vk::CommandBuffer& commandList) const
@@ -102,7 +159,7 @@ namespace nbl
 
     vk::ImageView Swapchain::getAttachmentSource() const
     {
-        return mImageViews[mLastAcquiredIndex];
+        return getImageView(mLastAcquiredIndex);
     }
 
     void Swapchain::createSurface()
@@ -121,9 +178,10 @@ namespace nbl
         mCurrentTransform = surfaceCaps.currentTransform;
 
         // Capability Checks
-        if (surfaceCaps.minImageCount > mImageCount || surfaceCaps.maxImageCount < mImageCount)
+        // maxImageCount of 0 means no limit.
+        if (surfaceCaps.minImageCount > mMinImageCount || (surfaceCaps.maxImageCount != 0 && surfaceCaps.maxImageCount < mMinImageCount))
         {
-            throw std::runtime_error(fmt::format("Swapchain image count {} out of supported range", mImageCount));
+            throw std::runtime_error(fmt::format("Swapchain image count {} out of supported range", mMinImageCount));
         }
 
         if (surfaceCaps.currentExtent.width != std::numeric_limits<uint32_t>::max())
@@ -167,18 +225,20 @@ namespace nbl
         {
             throw std::runtime_error("No present modes found");
         }
-        if (const auto it = std::ranges::find(presentModes, mPresentMode);
-            it == std::end(presentModes))
+        mSupportedPresentModes = presentModes;
+        mPresentMode = selectPresentMode(mRequestedPresentMode, presentModes);
+        if (mPresentMode != mRequestedPresentMode)
         {
-            throw std::runtime_error("PresentMode error");
+            fmt::println("[Swapchain] Present mode {} is not supported, using {}",
+                vk::to_string(mRequestedPresentMode), vk::to_string(mPresentMode));
         }
     }
 
-    void Swapchain::createSwapchain()
+    void Swapchain::createSwapchain(const vk::SwapchainKHR oldSwapchain)
     {
         const auto createInfo = vk::SwapchainCreateInfoKHR()
             .setSurface(mSurface)
-            .setMinImageCount(mImageCount)
+            .setMinImageCount(mMinImageCount)
             .setImageFormat(mFormat)
             .setImageColorSpace(mColorSpace)
             .setImageExtent(mExtent)
@@ -186,7 +246,7 @@ namespace nbl
             .setImageUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst)
             .setPreTransform(mCurrentTransform)
             .setClipped(true)
-            .setOldSwapchain(nullptr)
+            .setOldSwapchain(oldSwapchain)
             .setImageSharingMode(vk::SharingMode::eExclusive)
             .setPresentMode(mPresentMode)
             .setQueueFamilyIndexCount(0)
@@ -197,7 +257,7 @@ namespace nbl
 
     void Swapchain::acquireImages()
     {
-        mImages.resize(mImageCount);
+        // minImageCount is a lower bound, per-image resources are sized from the images actually created.
         mImages = mDevice->getHandle().getSwapchainImagesKHR(mSwapchain);
 
         constexpr vk::ComponentMapping componentMapping = {
@@ -211,8 +271,8 @@ namespace nbl
             .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 })
             .setViewType(vk::ImageViewType::e2D);
 
-        mImageViews.resize(mImageCount);
-        for (uint32_t i = 0; i < mImageCount; i++)
+        mImageViews.resize(mImages.size());
+        for (uint32_t i = 0; i < mImages.size(); i++)
         {
             create_info.setImage(mImages[i]);
             if (const vk::Result result = mDevice->getHandle().createImageView(&create_info, nullptr, &mImageViews[i]);
@@ -249,5 +309,30 @@ namespace nbl
             .setHeight(-1.0f * static_cast<float>(mExtent.height))
             .setMaxDepth(1.0f)
             .setMinDepth(0.0f);
+
+        mAspectRatio = static_cast<float>(mExtent.width) / static_cast<float>(mExtent.height);
+    }
+
+    void Swapchain::wrapImages()
+    {
+        for (uint32_t i = 0; i < mImages.size(); i++)
+        {
+            mWrappedImages.push_back(Image::createSwapchainImageWrapper({
+                .image = mImages[i],
+                .imageView = mImageViews[i],
+                .imageIndex = i,
+                .pDevice = mDevice,
+                .pSwapchain = this,
+            }));
+        }
+    }
+
+    void Swapchain::destroyImageViews()
+    {
+        for (const auto& imageView : mImageViews)
+        {
+            mDevice->getHandle().destroyImageView(imageView);
+        }
+        mImageViews.clear();
     }
 }
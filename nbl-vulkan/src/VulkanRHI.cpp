@@ -1,5 +1,11 @@
 #include "VulkanRHI.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <ranges>
+#include <fmt/format.h>
+
+#include "Barrier.hpp"
 #include "Device.hpp"
 #include "IWindow.hpp"
 
@@ -12,6 +18,7 @@ namespace nbl
     VulkanRHI::VulkanRHI(const VulkanRHICreateInfo& createInfo)
     : mWindow(createInfo.pWindow)
     , mConfig(createInfo.configuration)
+    , mFramesInFlight(std::max(1u, createInfo.configuration.framesInFlight))
     {
         if (sExists)
         {
@@ -38,45 +45,144 @@ namespace nbl
             .pQueue                     = mDevice->getGraphicsQueue(),
         });
 
-        mComputeQueue = CommandQueue::createCommandQueue({
-            .commandListCount           = 2,
-            .enableSingleTimeSubmission = false,
-            .pDevice                    = mDevice.get(),
-            .pQueue                     = mDevice->getAsyncComputeQueue(),
-        });
+        // Without a separate compute family, compute work shares the graphics CommandQueue and its timeline.
+        if (mDevice->hasAsyncComputeQueue())
+        {
+            mComputeQueue = CommandQueue::createCommandQueue({
+                .commandListCount           = 2,
+                .enableSingleTimeSubmission = false,
+                .pDevice                    = mDevice.get(),
+                .pQueue                     = mDevice->getAsyncComputeQueue(),
+            });
+        }
 
         mSwapchain = Swapchain::createSwapchain({
             .pWindow = mWindow,
             .pDevice = mDevice.get(),
             .instance = mInstance,
             .imageCount = createInfo.configuration.backBufferCount,
+            .presentMode = createInfo.configuration.presentMode,
         });
 
-        mImageReady.resize(mBackBufferCount);
-        mRenderingFinished.resize(mBackBufferCount);
-        mFrameInFlight.resize(mBackBufferCount);
+        mTransientBuffer = RingBuffer::createRingBuffer({
+            .frameSize  = mConfig.transientBufferFrameSize,
+            .frameCount = mFramesInFlight,
+            .pDevice    = mDevice.get(),
+            .debugName  = "Transient RingBuffer",
+        });
 
-        for (uint32_t i = 0; i < mBackBufferCount; i++)
+        mBindlessTable = BindlessTable::createBindlessTable({
+            .pDevice   = mDevice.get(),
+            .debugName = "Bindless Table",
+        });
+
+        mCommandAllocator = CommandAllocator::createCommandAllocator({
+            .frameCount = mFramesInFlight,
+            .pDevice    = mDevice.get(),
+            .pQueue     = mDevice->getGraphicsQueue(),
+            .debugName  = "Frame Command Allocator",
+        });
+
+        mFrameProfiler = FrameProfiler::createFrameProfiler({
+            .frameCount  = mFramesInFlight,
+            .historySize = mConfig.frameHistorySize,
+            .pDevice     = mDevice.get(),
+        });
+
+        mPipelineStatistics = PipelineStatistics::createPipelineStatistics({
+            .frameCount = mFramesInFlight,
+            .pDevice    = mDevice.get(),
+        });
+
+        mPipelineCompiler = PipelineCompiler::createPipelineCompiler({
+            .threadCount   = mConfig.pipelineCompilerThreads,
+            .cacheFilePath = mConfig.pipelineCacheFile,
+            .pDevice       = mDevice.get(),
+        });
+
+        // Binary semaphores remain only where presentation requires them.
+        mFrames.resize(mFramesInFlight);
+        for (auto&& [i, frameSync] : std::views::enumerate(mFrames))
         {
-            auto semaphoreCreateInfo = vk::SemaphoreCreateInfo();
-            auto fenceCreateInfo = vk::FenceCreateInfo().setFlags(vk::FenceCreateFlagBits::eSignaled);
+            nbl_VK_TRY(frameSync.imageAcquired = mDevice->getHandle().createSemaphore(vk::SemaphoreCreateInfo());)
+            mDevice->nameObject<vk::Semaphore>({
+                .debugName = fmt::format("Image Acquired {}", i),
+                .handle    = frameSync.imageAcquired,
+            });
+        }
 
-            mImageReady[i]        = mDevice->getHandle().createSemaphore(semaphoreCreateInfo);
-            mRenderingFinished[i] = mDevice->getHandle().createSemaphore(semaphoreCreateInfo);
-            mFrameInFlight[i]     = mDevice->getHandle().createFence(fenceCreateInfo);
+        createRenderingFinishedSemaphores();
+    }
+
+    VulkanRHI::~VulkanRHI()
+    {
+        // Frame resources (command pools, ring buffer partitions) may still be in use by frames in flight.
+        mGraphicsQueue->wait(mGraphicsQueue->getSubmittedValue());
+        getComputeQueue()->wait(getComputeQueue()->getSubmittedValue());
+
+        // The device is idle, deferred releases run while the objects they return to (BindlessTable) still exist.
+        mDevice->getDeletionQueue()->flush();
+
+        for (const auto& frameSync : mFrames)
+        {
+            mDevice->getHandle().destroy(frameSync.imageAcquired);
         }
+        destroyRenderingFinishedSemaphores();
     }
 
-    Frame VulkanRHI::beginFrame() const
+    Frame VulkanRHI::beginFrame()
     {
-        const vk::Fence fence = mFrameInFlight[mCurrentFrame];
+        const FrameSync& frameSync = mFrames[mCurrentFrame];
+
+        // Wait for frame N - framesInFlight, the last one that used this slot.
+        // Frames complete in submission order, everything submitted before it is done as well.
+        mFrameProfiler->mark(FramePhase::WaitBegin);
+        mGraphicsQueue->wait(frameSync.timelineValue);
+        mFrameProfiler->mark(FramePhase::WaitEnd);
+        mFrameProfiler->resolve(mCurrentFrame);
+        mPipelineStatistics->resolve(mCurrentFrame, mFrameProfiler->getFrameNumber());
+        mDevice->getDeletionQueue()->collect(frameSync.deletionValue);
+
+        const auto [width, height] = mWindow->getFramebufferSize();
+        const vk::Extent2D extent  = mSwapchain->getExtent();
+        if (mSwapchainOutOfDate || mRequestedPresentMode.has_value() || width != extent.width || height != extent.height)
+        {
+            recreateSwapchain();
+        }
+
+        mTransientBuffer->beginFrame(mCurrentFrame);
+        mDevice->getMemoryTracker()->update(mCurrentFrame);
+        mCommandAllocator->beginFrame(mCurrentFrame);
+        Barrier::nextFrame();
+
+        mFrameProfiler->mark(FramePhase::AcquireBegin);
 
-        vk::Result result = mDevice->getHandle().waitForFences(1, &fence, true, std::numeric_limits<uint64_t>::max());
-        result = mDevice->getHandle().resetFences(1, &fence);
+        // Pointer overload: returns eErrorOutOfDateKHR instead of throwing.
+        uint32_t   nextImage = 0;
+        vk::Result result    = vk::Result::eErrorOutOfDateKHR;
+        while (result == vk::Result::eErrorOutOfDateKHR)
+        {
+            result = mDevice->getHandle().acquireNextImageKHR(
+                mSwapchain->getHandle(), std::numeric_limits<uint64_t>::max(),
+                frameSync.imageAcquired, nullptr, &nextImage);
+
+            if (result == vk::Result::eErrorOutOfDateKHR)
+            {
+                recreateSwapchain();
+            }
+        }
 
-        const auto nextImage = mDevice->getHandle().acquireNextImageKHR(
-            mSwapchain->getHandle(),std::numeric_limits<uint64_t>::max(),
-            mImageReady[mCurrentFrame], nullptr).value;
+        // A suboptimal image can still be presented, recreate on the next frame.
+        if (result == vk::Result::eSuboptimalKHR)
+        {
+            mSwapchainOutOfDate = true;
+        }
+        else if (result != vk::Result::eSuccess)
+        {
+            throw RHIError(result);
+        }
+
+        mFrameProfiler->mark(FramePhase::AcquireEnd);
 
         // Store the last acquired index in the Swapchain (used by RenderPass).
         mSwapchain->mLastAcquiredIndex = nextImage;
@@ -89,44 +195,122 @@ namespace nbl
 
     void VulkanRHI::submitFrame(const Frame& frame)
     {
-        const auto frameIndex = frame.currentFrame;
+        FrameSync& frameSync = mFrames[frame.currentFrame];
+
+        // Indexed by image: the semaphore is only reused once presentation of the image finished and it was acquired again.
+        const vk::Semaphore renderingFinished = mRenderingFinished[frame.acquiredImageIndex];
+
+        mFrameProfiler->mark(FramePhase::SubmitBegin);
+        mTransientBuffer->flush();
+
+        // GPU time of the frame: timestamps in separate command buffers around the application's ones.
+        const vk::CommandBuffer timestampBegin = mCommandAllocator->allocate(0);
+        const vk::CommandBuffer timestampEnd   = mCommandAllocator->allocate(0);
+        constexpr auto beginInfo = vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+        timestampBegin.begin(beginInfo);
+        mFrameProfiler->writeBeginTimestamp(timestampBegin, frame.currentFrame);
+        timestampBegin.end();
+
+        timestampEnd.begin(beginInfo);
+        mFrameProfiler->writeEndTimestamp(timestampEnd, frame.currentFrame);
+        timestampEnd.end();
+
+        std::vector<vk::CommandBuffer> commandBuffers;
+        commandBuffers.reserve(frame.commandBuffers.size() + 2);
+        commandBuffers.push_back(timestampBegin);
+        commandBuffers.append_range(frame.commandBuffers);
+        commandBuffers.push_back(timestampEnd);
+
+        frameSync.timelineValue = mGraphicsQueue->submit({
+            .commandBuffers = commandBuffers,
+            .queueWaits     = frame.queueWaits,
+            .binaryWaits    = {
+                vk::SemaphoreSubmitInfo()
+                    .setSemaphore(frameSync.imageAcquired)
+                    .setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput),
+            },
+            .binarySignals  = {
+                vk::SemaphoreSubmitInfo()
+                    .setSemaphore(renderingFinished)
+                    .setStageMask(vk::PipelineStageFlagBits2::eAllCommands),
+            },
+        });
+        frameSync.deletionValue = mDevice->getDeletionQueue()->nextSubmission();
+        mFrameProfiler->mark(FramePhase::SubmitEnd);
 
-        std::vector<vk::CommandBufferSubmitInfo> commandBufferSubmitInfos;
-        for (const auto commandBuffer : frame.commandBuffers)
+        mFrameProfiler->mark(FramePhase::PresentBegin);
+        if (!mSwapchain->present(renderingFinished, frame.acquiredImageIndex, mFrameProfiler->getPresentId()))
         {
-            const auto info = vk::CommandBufferSubmitInfo()
-                .setCommandBuffer(commandBuffer);
-            commandBufferSubmitInfos.push_back(info);
+            mSwapchainOutOfDate = true;
         }
+        mFrameProfiler->mark(FramePhase::PresentEnd);
+        mFrameProfiler->endFrame(frame.currentFrame, mSwapchain->getHandle());
 
-        const auto waitSemaphoreInfo = vk::SemaphoreSubmitInfo()
-            .setSemaphore(mImageReady[frameIndex])
-            .setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
-        std::vector waitSemaphoreInfos = { waitSemaphoreInfo };
+        mCurrentFrame = (mCurrentFrame + 1) % mFramesInFlight;
+    }
 
-        const auto signalSemaphoreInfo = vk::SemaphoreSubmitInfo()
-            .setSemaphore(mRenderingFinished[frameIndex])
-            .setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
-        std::vector signalSemaphoreInfos = { signalSemaphoreInfo };
+    void VulkanRHI::setPresentMode(const vk::PresentModeKHR presentMode)
+    {
+        mRequestedPresentMode = presentMode;
+    }
+
+    uint32_t VulkanRHI::addSwapchainCallback(std::function<void(const Swapchain&)> callback)
+    {
+        const uint32_t id = mNextSwapchainCallbackId++;
+        mSwapchainCallbacks.emplace_back(id, std::move(callback));
+        return id;
+    }
+
+    void VulkanRHI::removeSwapchainCallback(const uint32_t id)
+    {
+        std::erase_if(mSwapchainCallbacks, [id](const auto& entry) { return entry.first == id; });
+    }
+
+    void VulkanRHI::recreateSwapchain()
+    {
+        // Images of the old Swapchain may still be used by frames in flight, on either queue.
+        mGraphicsQueue->wait(mGraphicsQueue->getSubmittedValue());
+        getComputeQueue()->wait(getComputeQueue()->getSubmittedValue());
+
+        // Presentation has no timeline value, idling the present queue completes its semaphore waits.
+        nbl_VK_TRY(mDevice->getGraphicsQueue()->queue.waitIdle();)
+        mFrameProfiler->retireSwapchain();
+
+        mSwapchain->recreate(mRequestedPresentMode);
+        mRequestedPresentMode.reset();
+        mSwapchainOutOfDate = false;
 
-        const auto submitInfo = vk::SubmitInfo2()
-            .setCommandBufferInfos(commandBufferSubmitInfos)
-            .setCommandBufferInfoCount(commandBufferSubmitInfos.size())
-            .setWaitSemaphoreInfos(waitSemaphoreInfos)
-            .setWaitSemaphoreInfoCount(waitSemaphoreInfos.size())
-            .setSignalSemaphoreInfos(signalSemaphoreInfos)
-            .setSignalSemaphoreInfoCount(signalSemaphoreInfos.size());
+        // The new Swapchain may have a different number of images.
+        destroyRenderingFinishedSemaphores();
+        createRenderingFinishedSemaphores();
 
-        if (const auto result = mDevice->getGraphicsQueue()->queue.submit2(1, &submitInfo, mFrameInFlight[frameIndex]);
-            result != vk::Result::eSuccess)
+        for (const auto& callback : mSwapchainCallbacks | std::views::values)
         {
-            throw std::runtime_error("Failed to submit CommandList");
+            callback(*mSwapchain);
         }
+    }
 
-        mSwapchain->present(mRenderingFinished[frameIndex], frame.acquiredImageIndex);
+    void VulkanRHI::createRenderingFinishedSemaphores()
+    {
+        mRenderingFinished.resize(mSwapchain->getImageCount());
+        for (auto&& [i, semaphore] : std::views::enumerate(mRenderingFinished))
+        {
+            nbl_VK_TRY(semaphore = mDevice->getHandle().createSemaphore(vk::SemaphoreCreateInfo());)
+            mDevice->nameObject<vk::Semaphore>({
+                .debugName = fmt::format("Rendering Finished {}", i),
+                .handle    = semaphore,
+            });
+        }
+    }
 
-        mDevice->waitIdle();
-        mCurrentFrame = (mCurrentFrame + 1) % mBackBufferCount;
+    void VulkanRHI::destroyRenderingFinishedSemaphores()
+    {
+        for (const auto& semaphore : mRenderingFinished)
+        {
+            mDevice->getHandle().destroy(semaphore);
+        }
+        mRenderingFinished.clear();
     }
 
     std::unique_ptr<Buffer> VulkanRHI::createBuffer(const BufferCreateInfo& createInfo) const
@@ -136,6 +320,83 @@ namespace nbl
         return Buffer::createBuffer(bufferCreateInfo);
     }
 
+    std::vector<UploadPath> VulkanRHI::uploadBuffers(const std::span<const BufferUploadInfo> uploadInfos) const
+    {
+        std::vector<UploadPath>              result;
+        std::vector<std::unique_ptr<Buffer>> stagingBuffers;
+        std::vector<BufferCopyInfo>          copies;
+
+        for (const auto& uploadInfo : uploadInfos)
+        {
+            if (const auto mapped = uploadInfo.pDstBuffer->map(); !mapped.empty())
+            {
+                std::memcpy(mapped.data() + uploadInfo.dstOffset, uploadInfo.pData, uploadInfo.size);
+                uploadInfo.pDstBuffer->flush(uploadInfo.dstOffset, uploadInfo.size);
+                result.push_back(UploadPath::Direct);
+                continue;
+            }
+
+            auto staging = createBuffer({
+                .size      = uploadInfo.size,
+                .type      = BufferType::Staging,
+                .debugName = "Upload Staging Buffer",
+            });
+            staging->setData(uploadInfo.pData, uploadInfo.size);
+
+            copies.push_back({
+                .pDstBuffer = uploadInfo.pDstBuffer,
+                .size       = uploadInfo.size,
+                .srcOffset  = 0,
+                .dstOffset  = uploadInfo.dstOffset,
+            });
+            stagingBuffers.push_back(std::move(staging));
+            result.push_back(UploadPath::Staging);
+        }
+
+        if (!copies.empty())
+        {
+            mGraphicsQueue->executeSingleTimeCommand([&](const vk::CommandBuffer& commandBuffer) {
+                // Earlier device reads of the destinations finish before the copies overwrite them.
+                BarrierBatch barriers(commandBuffer);
+                for (const auto& copy : copies)
+                {
+                    barriers.transition(BufferTransitionInfo {
+                        .pBuffer       = copy.pDstBuffer,
+                        .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+                        .dstStageMask  = vk::PipelineStageFlagBits2::eTransfer,
+                    });
+                }
+                barriers.flush();
+
+                for (size_t i = 0; i < copies.size(); i++)
+                {
+                    BufferCopyInfo copyInfo = copies[i];
+                    copyInfo.commandBuffer = commandBuffer;
+                    stagingBuffers[i]->copy(copyInfo);
+                }
+
+                // The first consumer of the uploaded data is unknown, make the copies visible to every later read.
+                for (const auto& copy : copies)
+                {
+                    barriers.transition(BufferTransitionInfo {
+                        .pBuffer       = copy.pDstBuffer,
+                        .dstAccessMask = vk::AccessFlagBits2::eMemoryRead,
+                        .dstStageMask  = vk::PipelineStageFlagBits2::eAllCommands,
+                    });
+                }
+            });
+        }
+
+        return result;
+    }
+
+    std::unique_ptr<BufferArena> VulkanRHI::createBufferArena(const BufferArenaCreateInfo& createInfo) const
+    {
+        BufferArenaCreateInfo arenaCreateInfo = createInfo;
+        arenaCreateInfo.pDevice = mDevice.get();
+        return BufferArena::createBufferArena(arenaCreateInfo);
+    }
+
     std::unique_ptr<Descriptor> VulkanRHI::createDescriptor(const DescriptorCreateInfo& createInfo) const
     {
         DescriptorCreateInfo descriptorCreateInfo = createInfo;
@@ -150,6 +411,13 @@ namespace nbl
         return Image::createImage(imageCreateInfo);
     }
 
+    std::unique_ptr<RenderGraph> VulkanRHI::createRenderGraph(const RenderGraphCreateInfo& createInfo) const
+    {
+        RenderGraphCreateInfo renderGraphCreateInfo = createInfo;
+        renderGraphCreateInfo.pDevice = mDevice.get();
+        return RenderGraph::createRenderGraph(renderGraphCreateInfo);
+    }
+
     void VulkanRHI::createInstance()
     {
         const auto applicationInfo = vk::ApplicationInfo()
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 #include <nbl/VulkanRHI.hpp>
 #include <wsi/Window.hpp>
 
@@ -16,6 +18,9 @@ namespace nbl
         wsi::WindowCreateInfo   windowInfo    = {};
         VulkanRHIConfiguration  rhiInfo       = {};
         bool                    enableUI      = true;
+        StrandOrder             strandOrder   = StrandOrder::Morton;
+        DescriptorBackend       descriptorBackend = DescriptorBackend::Pool;
+        std::vector<std::string> hairModels   = { "wWavy.hair" };   // "wCurly.hair", "wStraight.hair", "wWavy.hair", "wWavyThin.hair", "synthetic:<strands>"
     };
 
     class App
@@ -27,9 +32,37 @@ namespace nbl
 
         virtual void run();
 
+        /**
+         * Render the active HairModel with every supported HairRenderPath,
+         * report frame time percentiles, FrameProfiler GPU timestamps and geometry memory per path.
+         */
+        void benchmarkRenderPaths(uint32_t frameCount, uint32_t warmupFrameCount = 60);
+
+        /**
+         * Write a JSON snapshot of the tracked GPU allocations and heap budgets.
+         */
+        void writeMemoryReport(const std::string& filePath) const;
+
+        /**
+         * Write the recorded frame lifecycle timings as CSV, one row per frame.
+         */
+        void writeFrameReport(const std::string& filePath) const;
+
+        /**
+         * Render one frame of the active HairModel as seen from the given camera.
+         */
+        void renderFrame(const ICamera& camera);
+
+        void setActiveHairModel(HairModel* pHairModel) { mActiveHairModel = pHairModel; }
+
+        const std::vector<std::unique_ptr<HairModel>>& getHairModels() const { return mHairModels; }
+
+        VulkanRHI*   getRHI()    const { return mRHI.get();    }
+        wsi::Window* getWindow() const { return mWindow.get(); }
+
     private:
         void createCameraResources();
-        void loadHairModels();
+        void loadHairModels(const std::vector<std::string>& hairModels);
 
         std::unique_ptr<wsi::Window>            mWindow;
         std::unique_ptr<VulkanRHI>              mRHI;
@@ -37,12 +70,16 @@ namespace nbl
 
         std::unique_ptr<FirstPersonCamera>      mCamera;
 
-        std::array<std::unique_ptr<Buffer>, 2>  mUniformBuffer;
         std::unique_ptr<Descriptor>             mSceneDescriptor;
 
+        std::unique_ptr<BufferArena>            mGeometryArena;     // Static hair geometry of every model
         std::vector<std::unique_ptr<HairModel>> mHairModels;
         HairModel*                              mActiveHairModel;
 
+        std::unique_ptr<RenderGraph>            mRenderGraph;
         std::unique_ptr<HairPipeline>           mHairPipeline;
+
+        StrandOrder                             mStrandOrder;
+        DescriptorBackend                       mDescriptorBackend;
     };
 }
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include <nbl/FrameProfiler.hpp>
+#include <nbl/PipelineStatistics.hpp>
+#include <wsi/Window.hpp>
+
+#include "hair/HairCommon.h"
+#include "Util.hpp"
+
+namespace nbl
+{
+    struct BenchmarkCreateInfo
+    {
+        std::vector<std::string>    hairModels       = { "wWavy.hair" };
+
+        // Configuration axes, every combination is measured
+        std::vector<HairRenderPath> renderPaths      = { gHairRenderPaths.begin(), gHairRenderPaths.end() };
+        std::vector<uint32_t>       framesInFlight   = { 2 };
+        std::vector<float>          minClusterSizes  = { 0.0f };    // LOD, MeshShader render path only
+        std::vector<bool>           clusterCulling   = { true };    // MeshShader render path only
+        std::vector<HairRenderingMode> renderingModes = { HairRenderingMode::Normal };  // MeshShader render path only
+
+        uint32_t                    warmupFrameCount = 120;
+        uint32_t                    frameCount       = 600;
+        float                       frameTime        = 1.0f / 60.0f;    // Fixed camera path step per frame, seconds
+        std::string                 cameraPath;                         // Keyframe file, an orbit around the model if empty
+
+        std::string                 outputPath       = "benchmark";     // Writes <outputPath>.csv and <outputPath>.json
+        wsi::WindowCreateInfo       windowInfo       = {};
+        vk::PresentModeKHR          presentMode      = vk::PresentModeKHR::eImmediate;
+        bool                        validation       = false;
+    };
+
+    /**
+     * One measured combination of the configuration axes.
+     */
+    struct BenchmarkScenario
+    {
+        std::string                 hairModel;
+        HairRenderPath              renderPath       = HairRenderPath::MeshShader;
+        uint32_t                    framesInFlight   = 2;
+        float                       minClusterSize   = 0.0f;
+        bool                        clusterCulling   = true;
+        HairRenderingMode           renderingMode    = HairRenderingMode::Normal;
+
+        std::vector<FrameRecord>    frames;
+        FramePacingSummary          summary;
+        uint64_t                    geometryBytes    = 0;
+        std::optional<HairDebugStatistics> debugStatistics;         // Performance rendering modes, last completed frame
+        std::map<std::string, PipelineStatisticsResult> pipelineStatistics;    // Scope -> counters of the last resolved measured frame
+    };
+
+    /**
+     * Deterministic scripted benchmark: every scenario replays the same camera path with a fixed time step,
+     * after a warm-up on the same path. Per-frame timings come from the FrameProfiler of the VulkanRHI.
+     */
+    class Benchmark
+    {
+    public:
+        nbl_DISABLE_COPY(Benchmark);
+        nbl_CI_CTOR(Benchmark, BenchmarkCreateInfo);
+
+        void run();
+
+        const std::vector<BenchmarkScenario>& getScenarios() const { return mScenarios; }
+
+        void writeCsv(const std::string& filePath) const;
+
+        void writeJson(const std::string& filePath) const;
+
+    private:
+        BenchmarkCreateInfo             mInfo;
+        std::vector<BenchmarkScenario>  mScenarios;
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ICamera.hpp"
+#include "Util.hpp"
+
+namespace nbl
+{
+    struct CameraKeyframe
+    {
+        float     time   = 0.0f;    // Seconds
+        glm::vec3 eye    = {};
+        glm::vec3 target = {};
+    };
+
+    struct CameraPathCreateInfo
+    {
+        std::vector<CameraKeyframe> keyframes;
+        glm::ivec2                  size = { 1920, 1080 };
+        float                       fov  = 75.0f;
+        float                       near = 0.1f;
+        float                       far  = 10000.0f;
+        bool                        loop = true;    // Wrap around after the last keyframe instead of holding it
+    };
+
+    /**
+     * Camera played back from keyframes with Catmull-Rom interpolation of eye and target.
+     * Driven by setTime only, independent of input and wall-clock time for reproducible runs.
+     */
+    class CameraPath final : public ICamera
+    {
+    public:
+        nbl_CI_CTOR(CameraPath, CameraPathCreateInfo);
+
+        ~CameraPath() override = default;
+
+        /**
+         * Load keyframes from a text file, one "time eye.x eye.y eye.z target.x target.y target.z" per line.
+         * Empty lines and lines starting with '#' are skipped.
+         */
+        static std::vector<CameraKeyframe> loadKeyframes(const std::string& filePath);
+
+        /**
+         * Keyframes of one orbit around center, looking at it.
+         */
+        static std::vector<CameraKeyframe> createOrbit(const glm::vec3& center, float radius, float height, float duration, uint32_t keyframeCount = 16);
+
+        void setTime(float time);
+
+        float getDuration() const { return mKeyframes.back().time; }
+
+        const glm::vec3& eye() const override { return mEye; }
+
+        glm::mat4 view() const override;
+
+        glm::mat4 projection() const override;
+
+        CameraData getCameraData() const override;
+
+        void setSize(const glm::ivec2& size) { mSize = size; }
+
+    private:
+        std::vector<CameraKeyframe> mKeyframes;     // Sorted by time
+        glm::ivec2                  mSize;
+        glm::vec3                   mEye;
+        glm::vec3                   mTarget;
+        glm::vec3                   mUp = { 0, 1, 0 };
+
+        float                       mFov;
+        float                       mNear;
+        float                       mFar;
+        bool                        mLoop;
+    };
+}
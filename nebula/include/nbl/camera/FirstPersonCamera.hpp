@@ -25,6 +25,8 @@ namespace nbl
 
         void registerMouse(GLFWwindow* pWindow) override;
 
+        void setSize(const glm::ivec2& size) { mSize = size; }
+
     private:
         glm::ivec2 mSize;
         glm::vec3  mEye;
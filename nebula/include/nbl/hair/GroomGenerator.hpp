@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <cyHairFile.h>
+#include <glm/glm.hpp>
+
+namespace nbl
+{
+    /**
+     * Sphere: Roots uniformly distributed on a sphere around the origin.
+     * Mesh:   Roots distributed by area on the triangles of a Wavefront OBJ scalp mesh.
+     */
+    enum class GroomRootShape : int32_t
+    {
+        Sphere = 0,
+        Mesh   = 1,
+    };
+
+    std::string toString(GroomRootShape rootShape);
+
+    /**
+     * Procedural groom parameters, the same parameters and seed always produce the same groom.
+     */
+    struct GroomGenerateInfo
+    {
+        uint32_t        strandCount     = 10000;
+        uint32_t        pointsPerStrand = 32;
+        uint32_t        seed            = 1;
+
+        GroomRootShape  rootShape       = GroomRootShape::Sphere;
+        float           sphereRadius    = 10.0f;
+        std::string     scalpMeshPath;                  // GroomRootShape::Mesh
+
+        float           lengthMean      = 20.0f;
+        float           lengthStdDev    = 0.0f;         // Normal distribution, lengths are clamped to 10% of the mean
+        float           gravity         = 0.0f;         // Downward bend of the tip in units of strand length
+
+        float           curlRadius      = 0.0f;         // Helix around the growth direction, 0 for straight strands
+        float           curlTurns       = 4.0f;         // Helix turns along a strand
+
+        uint32_t        clumpCount      = 0;            // Approximate, spatial cells of the root positions
+        float           clumpStrength   = 0.0f;         // [0, 1], pull of the tips towards the clump guide strand
+    };
+
+    struct ScalpMesh
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t>  indices;     // Triangle list
+    };
+
+    /**
+     * Load the positions and faces of an OBJ file, polygons are triangulated as fans.
+     */
+    ScalpMesh loadScalpMesh(const std::string& filePath);
+
+    /**
+     * Fill hairFile with a procedural groom, strands are generated in parallel.
+     */
+    void generateGroom(const GroomGenerateInfo& generateInfo, cyHairFile& hairFile);
+}
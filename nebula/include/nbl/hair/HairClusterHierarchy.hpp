@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.hpp>
+
+#include "HairCommon.h"
+
+namespace nbl
+{
+    static constexpr int32_t gHAIR_CLUSTER_SIZE        = gHAIR_WORKGROUP_SIZE;   // Strands per cluster, one task workgroup
+    static constexpr int32_t gHAIR_CLUSTER_BVH_FANOUT  = 8;
+    static constexpr int32_t gHAIR_CLUSTER_MAX_LEVELS  = 16;
+
+    // Node of the cluster BVH, leaves are clusters [GPU and CPU]
+    struct HairClusterNode
+    {
+        glm::vec4 sphere     = glm::vec4(0.0f);     // xyz: Center, w: Radius [Model Space]
+        glm::vec4 cone       = glm::vec4(0.0f);     // xyz: Average tangent, w: cos(Spread angle)
+        float     lodMetric  = 0.0f;                // Average segment length, the maximum of the children for inner nodes
+        int32_t   firstChild = 0;                   // Node index of the first child, Cluster ID for leaves
+        int32_t   childCount = 0;                   // 0 for leaves
+        int32_t   level      = 0;
+    };
+
+    // Cluster hierarchy culling state, reset every frame [GPU Only]
+    struct HairClusterCullState
+    {
+        vk::DispatchIndirectCommand              dispatch[gHAIR_CLUSTER_MAX_LEVELS];
+        uint32_t                                 queueCounts[gHAIR_CLUSTER_MAX_LEVELS];
+        vk::DrawMeshTasksIndirectCommandEXT      draw;
+    };
+
+    /**
+     * Two-level strand hierarchy: consecutive groups of gHAIR_CLUSTER_SIZE strands form clusters,
+     * clusters are grouped into a BVH with a fixed fan-out. Nodes are stored level by level,
+     * root first, clusters last. Strands should be spatially ordered (StrandOrder::Morton).
+     */
+    class HairClusterHierarchy
+    {
+    public:
+        HairClusterHierarchy() = default;
+
+        void build(std::span<const StrandDescription> strandDescriptions, std::span<const HairVertex> vertices);
+
+        const std::vector<HairClusterNode>& getNodes()        const { return mNodes;        }
+        const std::vector<int32_t>&         getLevelOffsets() const { return mLevelOffsets; }
+
+        int32_t getLevelCount()   const { return static_cast<int32_t>(mLevelOffsets.size()) - 1; }
+        int32_t getClusterCount() const { return mClusterCount; }
+
+        int32_t getLevelSize(const int32_t level) const { return mLevelOffsets[level + 1] - mLevelOffsets[level]; }
+
+    private:
+        static HairClusterNode makeCluster(
+            int32_t                            clusterId,
+            std::span<const StrandDescription> strandDescriptions,
+            std::span<const HairVertex>        vertices);
+
+        static HairClusterNode mergeNodes(std::span<const HairClusterNode> children);
+
+        std::vector<HairClusterNode> mNodes;
+        std::vector<int32_t>         mLevelOffsets;     // Level sizes + sentinel, mLevelOffsets[levelCount] == mNodes.size()
+        int32_t                      mClusterCount = 0;
+    };
+}
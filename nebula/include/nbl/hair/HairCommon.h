@@ -1,8 +1,10 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <span>
 #include <stdexcept>
+#include <string>
 #include <glm/glm.hpp>
 
 namespace nbl
@@ -10,14 +12,35 @@ namespace nbl
     static constexpr int32_t gHAIR_WORKGROUP_SIZE     = 32;
     static constexpr int32_t gHAIR_MAX_STRANDLET_SIZE = gHAIR_WORKGROUP_SIZE;
 
+    /**
+     * Debug modes color the mesh shader output, performance modes also collect HairDebugStatistics.
+     * Overdraw:        Fragments per pixel, counted with atomics and resolved into a color ramp overlay.
+     * LaneUtilization: Strandlets colored by active mesh shader lanes / WORKGROUP_SIZE.
+     * MeshGroups:      Strandlets colored by the mesh workgroups their task workgroup emitted.
+     */
     enum class HairRenderingMode : int32_t
     {
         Normal          = 0,
         DebugQuads      = 1,
         DebugStrands    = 2,
         DebugStrandlets = 3,
+        Overdraw        = 4,
+        LaneUtilization = 5,
+        MeshGroups      = 6,
     };
 
+    static constexpr std::array gHairRenderingModes = {
+        HairRenderingMode::Normal,          HairRenderingMode::DebugQuads,
+        HairRenderingMode::DebugStrands,    HairRenderingMode::DebugStrandlets,
+        HairRenderingMode::Overdraw,        HairRenderingMode::LaneUtilization,
+        HairRenderingMode::MeshGroups,
+    };
+
+    inline bool isPerformanceRenderingMode(const HairRenderingMode renderingMode)
+    {
+        return renderingMode >= HairRenderingMode::Overdraw;
+    }
+
     inline std::string toString(const HairRenderingMode renderingMode)
     {
         using enum HairRenderingMode;
@@ -28,11 +51,52 @@ namespace nbl
         case DebugQuads:        return "Debug (Quads)";
         case DebugStrands:      return "Debug (Strands)";
         case DebugStrandlets:   return "Debug (Strandlets)";
+        case Overdraw:          return "Overdraw";
+        case LaneUtilization:   return "Lane Utilization";
+        case MeshGroups:        return "Mesh Groups";
         }
 
         throw std::invalid_argument("Unknown HairRenderingMode");
     }
 
+    /**
+     * MeshShader:       Task + Mesh shaders expand strands into quads on the fly.
+     * ComputeExpansion: A compute pass expands strands into a triangle ribbon buffer every frame,
+     *                   drawn with a regular indexed draw. [No VK_EXT_mesh_shader required]
+     * CachedRibbons:    Same ribbon geometry expanded once in model space (at load or when the groom changes),
+     *                   later frames only transform it in the vertex shader. [Static grooms]
+     */
+    enum class HairRenderPath : int32_t
+    {
+        MeshShader       = 0,
+        ComputeExpansion = 1,
+        CachedRibbons    = 2,
+    };
+
+    static constexpr std::array gHairRenderPaths = {
+        HairRenderPath::MeshShader, HairRenderPath::ComputeExpansion, HairRenderPath::CachedRibbons,
+    };
+
+    // Both ribbon paths share the expansion pass and ribbon buffers.
+    inline bool isRibbonRenderPath(const HairRenderPath renderPath)
+    {
+        return renderPath != HairRenderPath::MeshShader;
+    }
+
+    inline std::string toString(const HairRenderPath renderPath)
+    {
+        using enum HairRenderPath;
+
+        switch (renderPath)
+        {
+        case MeshShader:        return "Mesh Shader";
+        case ComputeExpansion:  return "Compute Expansion";
+        case CachedRibbons:     return "Cached Ribbons";
+        }
+
+        throw std::invalid_argument("Unknown HairRenderPath");
+    }
+
     // Basic Hair vertex data
     struct HairVertex
     {
@@ -64,6 +128,44 @@ namespace nbl
         int32_t vertexOffset    = 0;
     };
 
+    // Expanded ribbon vertex, two per HairVertex [GPU Only]
+    struct HairRibbonVertex
+    {
+        glm::vec4 position;
+        glm::vec4 tangent;
+    };
+
+    static constexpr int32_t gHAIR_OVERDRAW_BUCKETS = 8;
+
+    /**
+     * Header of the hair debug buffer, followed by one fragment counter per pixel. [GPU and CPU]
+     * Written with atomics by the debug task, mesh and fragment shaders and the overdraw resolve pass.
+     */
+    struct HairDebugStatistics
+    {
+        uint32_t fragmentCount      = 0;
+        uint32_t coveredPixelCount  = 0;    // Pixels with at least one fragment
+        uint32_t maxOverdraw        = 0;
+        uint32_t taskGroupCount     = 0;
+        uint32_t meshGroupCount     = 0;    // Emitted by the task workgroups
+        uint32_t maxMeshGroups      = 0;    // Per task workgroup
+        uint32_t activeLaneCount    = 0;    // Sum over mesh workgroups
+        uint32_t _pad0              = 0;
+
+        std::array<uint32_t, gHAIR_WORKGROUP_SIZE + 1> laneHistogram     {};   // Mesh workgroups by active lanes
+        std::array<uint32_t, gHAIR_OVERDRAW_BUCKETS>   overdrawHistogram {};   // Covered pixels by floor(log2(fragments))
+
+        float getLaneUtilization() const
+        {
+            return meshGroupCount > 0 ? static_cast<float>(activeLaneCount) / static_cast<float>(meshGroupCount * gHAIR_WORKGROUP_SIZE) : 0.0f;
+        }
+
+        float getAverageOverdraw() const
+        {
+            return coveredPixelCount > 0 ? static_cast<float>(fragmentCount) / static_cast<float>(coveredPixelCount) : 0.0f;
+        }
+    };
+
     // [GPU and CPU]
     struct HairBufferAddresses
     {
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cyHairFile.h>
+
+#include "HairClusterHierarchy.hpp"
+#include "HairCommon.h"
+#include "StrandReorder.hpp"
+#include "Util.hpp"
+
+namespace nbl
+{
+    struct HairGeometryCreateInfo
+    {
+        std::string filePath    = {};       // Empty: the hair file is filled through getHairFile
+        std::string name        = {};       // Defaults to filePath
+        StrandOrder strandOrder = StrandOrder::Morton;     // Clusters are consecutive strands, spatial order keeps their bounds tight
+    };
+
+    /**
+     * CPU side of a HairModel: the .hair file and the strand, strandlet and cluster data built from it.
+     * Needs no device, a HairModel creates its GPU buffers from a processed HairGeometry.
+     * Stages run in order: loadFile, processVertices, reorderStrands, processStrands, buildClusterHierarchy.
+     */
+    class HairGeometry
+    {
+    public:
+        nbl_DISABLE_COPY(HairGeometry);
+        nbl_CI_CTOR(HairGeometry, HairGeometryCreateInfo);
+
+        ~HairGeometry() = default;
+
+        /**
+         * Run every stage.
+         */
+        void process();
+
+        void loadFile();
+
+        void processVertices();
+
+        void reorderStrands();
+
+        void processStrands();
+
+        void buildClusterHierarchy();
+
+        cyHairFile&       getHairFile()       { return mHairFile; }
+        const cyHairFile& getHairFile() const { return mHairFile; }
+
+        const std::string&                    getName()               const { return mName;               }
+        StrandOrder                           getStrandOrder()        const { return mStrandOrder;        }
+        const std::vector<HairVertex>&        getVertices()           const { return mVertices;           }
+        const std::vector<Strand>&            getStrands()            const { return mStrands;            }
+        const std::vector<Strandlet>&         getStrandlets()         const { return mStrandlets;         }
+        const std::vector<StrandDescription>& getStrandDescriptions() const { return mStrandDescriptions; }
+        const std::vector<int32_t>&           getStrandPermutation()  const { return mStrandPermutation;  }
+        const HairClusterHierarchy&           getClusterHierarchy()   const { return mClusterHierarchy;   }
+
+        /**
+         * @return Bytes of the processed CPU data, excluding the hair file.
+         */
+        uint64_t getMemoryUsage() const;
+
+    private:
+        std::string                     mFilePath;
+        std::string                     mName;
+        cyHairFile                      mHairFile;
+
+        std::vector<HairVertex>         mVertices;
+        std::vector<int32_t>            mStrandVertexCounts;
+        std::vector<Strand>             mStrands;
+        std::vector<Strandlet>          mStrandlets;
+        std::vector<StrandDescription>  mStrandDescriptions;
+
+        StrandOrder                     mStrandOrder;
+        std::vector<int32_t>            mStrandPermutation;     // [Strand Index] -> Source Strand ID
+
+        HairClusterHierarchy            mClusterHierarchy;
+    };
+}
@@ -1,14 +1,18 @@
 #pragma once
 
+#include <initializer_list>
 #include <memory>
+#include <optional>
 #include <string>
 
-#include <cyHairFile.h>
-
 #include <nbl/Buffer.hpp>
+#include <nbl/BufferArena.hpp>
 #include <nbl/VulkanRHI.hpp>
 
+#include "HairClusterHierarchy.hpp"
 #include "HairCommon.h"
+#include "HairGeometry.hpp"
+#include "StrandReorder.hpp"
 #include "Util.hpp"
 #include "math/Transform.hpp"
 
@@ -22,8 +26,11 @@ namespace nbl
 
     struct HairModelCreateInfo
     {
-        std::string filePath = {};
-        VulkanRHI*  pRHI     = nullptr;
+        std::string filePath    = {};
+        StrandOrder strandOrder = StrandOrder::Morton;
+        VulkanRHI*  pRHI        = nullptr;
+        std::shared_ptr<const HairGeometry> geometry;   // Processed geometry, filePath and strandOrder are ignored if set
+        BufferArena* pGeometryArena = nullptr;          // Static geometry is sub-allocated from it, nullptr: the model gets an arena of its own
     };
 
     class HairModel
@@ -37,24 +44,89 @@ namespace nbl
 
         void render(const vk::CommandBuffer& commandBuffer) const;
 
+        /**
+         * Draw the visible clusters written by the cluster culling pass, one task workgroup per cluster.
+         */
+        void renderCulled(const vk::CommandBuffer& commandBuffer) const;
+
+        void renderRibbons(const vk::CommandBuffer& commandBuffer) const;
+
+        /**
+         * Switch the render path, ribbon buffers are created on first use of a ribbon render path.
+         */
+        void setRenderPath(HairRenderPath renderPath);
+
+        HairRenderPath getRenderPath() const { return mRenderPath; }
+
+        /**
+         * Request a re-expansion of the cached ribbon geometry, call when the groom changes.
+         */
+        void invalidateRibbonCache() { mRibbonCacheValid = false; }
+
+        bool isRibbonCacheValid() const { return mRibbonCacheValid; }
+
+        /**
+         * @return Bytes of GPU memory used by the geometry of the given render path.
+         */
+        uint64_t getMemoryUsage(HairRenderPath renderPath) const;
+
         const HairBufferAddresses& getBufferAddresses() const { return mBufferAddresses; }
 
-        int32_t getVertexCount() const { return static_cast<int32_t>(mVertices.size()); }
+        const std::string& getName() const { return mName; }
+
+        int32_t getVertexCount() const { return static_cast<int32_t>(mGeometry->getVertices().size()); }
+
+        int32_t getStrandCount() const { return static_cast<int32_t>(mGeometry->getStrands().size()); }
+
+        StrandOrder getStrandOrder() const { return mGeometry->getStrandOrder(); }
+
+        /**
+         * Map a strand index of the GPU buffers back to its strand ID in the source file.
+         */
+        int32_t getSourceStrandId(const int32_t strandIndex) const { return mGeometry->getStrandPermutation()[strandIndex]; }
 
-        int32_t getStrandCount() const { return static_cast<int32_t>(mStrands.size()); }
+        const HairGeometry& getGeometry() const { return *mGeometry; }
 
-        Buffer* getVertexBuffer() const { return mVertexBuffer.get(); }
+        BufferSlice* getVertexBuffer() const { return mVertexBuffer.get(); }
 
-        Buffer* getStrandDescriptionsBuffer() const { return mStrandDescriptionsBuffer.get(); }
+        BufferSlice* getStrandDescriptionsBuffer() const { return mStrandDescriptionsBuffer.get(); }
+
+        Buffer* getRibbonVertexBuffer() const { return mRibbonVertexBuffer.get(); }
+
+        const HairClusterHierarchy& getClusterHierarchy() const { return mGeometry->getClusterHierarchy(); }
+
+        bool isClusterCullingEnabled() const { return mEnableClusterCulling; }
+
+        void setClusterCulling(const bool enable) { mEnableClusterCulling = enable; }
+
+        /**
+         * Clusters whose strand segments (HairClusterNode::lodMetric) project to fewer pixels are culled,
+         * the level of detail knob of the MeshShader path.
+         */
+        void setMinClusterScreenSize(const float pixels) { mMinClusterScreenSize = pixels; }
+
+        float getMinClusterScreenSize() const { return mMinClusterScreenSize; }
+
+        HairRenderingMode getRenderingMode() const { return mRenderingMode; }
+
+        void setRenderingMode(const HairRenderingMode renderingMode) { mRenderingMode = renderingMode; }
+
+        /**
+         * Statistics of the latest completed frame drawn with a performance HairRenderingMode, read back asynchronously.
+         */
+        const std::optional<HairDebugStatistics>& getDebugStatistics() const { return mDebugStatistics; }
 
     private:
-        void loadFile();
+        void createBuffers(BufferArena* pArena);
 
-        void processVertices();
+        void createRibbonBuffers();
 
-        void processStrands();
+        void createClusterBuffers();
 
-        void createBuffers();
+        /**
+         * Upload through VulkanRHI::uploadBuffers and report the path taken for each buffer.
+         */
+        void uploadBuffers(std::initializer_list<BufferUploadInfo> uploadInfos) const;
 
         friend class HairPipeline;
         friend class HairUIComponent;
@@ -63,21 +135,26 @@ namespace nbl
         // Hair Meta- and Geometry Data
         // ================================
         std::string                     mName;
-        cyHairFile                      mHairFile;
-
-        std::vector<Vertex_t>           mVertices;
-        std::vector<int32_t>            mStrandVertexCounts;
-        std::vector<Strand>             mStrands;
-        std::vector<Strandlet>          mStrandlets;
-        std::vector<StrandDescription>  mStrandDescriptions;
+        std::shared_ptr<const HairGeometry> mGeometry;
 
         // ================================
         // GPU Hair Data
         // ================================
-        std::unique_ptr<Buffer>         mVertexBuffer;
-        std::unique_ptr<Buffer>         mStrandDescriptionsBuffer;
+        std::unique_ptr<BufferArena>    mOwnedGeometryArena;            // Only without HairModelCreateInfo::pGeometryArena
+        std::unique_ptr<BufferSlice>    mVertexBuffer;
+        std::unique_ptr<BufferSlice>    mStrandDescriptionsBuffer;
         HairBufferAddresses             mBufferAddresses;
 
+        std::unique_ptr<Buffer>         mRibbonVertexBuffer;
+        std::unique_ptr<Buffer>         mRibbonIndexBuffer;
+        uint32_t                        mRibbonIndexCount   = 0;
+        bool                            mRibbonCacheValid   = false;    // Set by HairPipeline when it declares the cached expansion
+
+        std::unique_ptr<Buffer>         mClusterNodeBuffer;
+        std::unique_ptr<Buffer>         mClusterQueueBuffer;            // Per-level node queues, same layout as the nodes
+        std::unique_ptr<Buffer>         mVisibleClusterBuffer;
+        std::unique_ptr<Buffer>         mClusterCullStateBuffer;        // Indirect dispatch and draw arguments
+
         // ================================
         // Rendering Options
         // ================================
@@ -89,6 +166,10 @@ namespace nbl
         int32_t                         mGroupSizeOverride  = 0;
         bool                            mEnableOverride     = false;
         HairRenderingMode               mRenderingMode      = HairRenderingMode::Normal;
+        HairRenderPath                  mRenderPath         = HairRenderPath::MeshShader;
+        bool                            mEnableClusterCulling = true;   // MeshShader render path only
+        float                           mMinClusterScreenSize = 0.0f;   // Pixels, 0 disables screen-size culling
+        mutable std::optional<HairDebugStatistics> mDebugStatistics;    // Set by HairPipeline from the debug readback
 
         VulkanRHI*                      mRHI = nullptr;
     };
@@ -2,12 +2,18 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.hpp>
 
 #include <nbl/Pipeline.hpp>
+#include <nbl/PipelineVariants.hpp>
+#include <nbl/RenderGraph.hpp>
 #include <nbl/RenderPass.hpp>
 #include <nbl/VulkanRHI.hpp>
+#include "HairCommon.h"
 
 namespace nbl
 {
@@ -15,6 +21,17 @@ namespace nbl
 
     struct Frame;
 
+    /**
+     * Specialization constant IDs of the hair shaders, see inc/hairCommon.glsl.
+     * Every combination is a separate pipeline, branches on them cost nothing at runtime.
+     */
+    enum class HairSpecialization : uint32_t
+    {
+        RenderingMode       = 0,    // HairRenderingMode, selects the debug coloring and statistics
+        ClusterCulling      = 1,    // Task workgroups read their cluster from the visible cluster list
+        ExpandWorkgroupSize = 2,    // nblHairExpand lanes per strand
+    };
+
     struct PushConstant
     {
         glm::mat4 model;
@@ -22,45 +39,199 @@ namespace nbl
         glm::vec4 hairDiffuse;
         glm::vec4 hairSpecular;
 
-        int32_t   vertexCount;
         int32_t   strandCount;
-        int32_t   renderMode {0};
         int32_t   _pad0 {-1};
 
+        uint64_t  visibleClusterBuffer {0};     // Task workgroup -> Cluster ID, 0 when cluster culling is disabled
         uint64_t  vertexBuffer;
         uint64_t  strandDescBuffer;
 
-        static vk::PushConstantRange getPushConstantRange()
+        static vk::PushConstantRange getPushConstantRange(const vk::ShaderStageFlags stages = sShaderStages)
         {
             return vk::PushConstantRange()
                 .setSize(sizeof(PushConstant))
                 .setOffset(0)
-                .setStageFlags(sShaderStages);
+                .setStageFlags(stages);
         }
 
         constexpr static vk::ShaderStageFlags sShaderStages =
             vk::ShaderStageFlagBits::eTaskEXT |
             vk::ShaderStageFlagBits::eMeshEXT |
             vk::ShaderStageFlagBits::eFragment;
+
+        // Ribbon paths: vertexBuffer holds the address of the ribbon vertex buffer,
+        // model is identity for ComputeExpansion as the ribbons are already in world space.
+        constexpr static vk::ShaderStageFlags sRibbonShaderStages =
+            vk::ShaderStageFlagBits::eVertex |
+            vk::ShaderStageFlagBits::eFragment;
+    };
+
+    /**
+     * Debug and performance HairRenderingModes, the shading colors are dropped to stay within 128 bytes.
+     */
+    struct DebugPushConstant
+    {
+        glm::mat4 model;
+
+        int32_t   strandCount;
+        int32_t   _pad0 {-1};
+        int32_t   viewportWidth;
+        int32_t   viewportHeight;
+
+        uint64_t  visibleClusterBuffer {0};
+        uint64_t  vertexBuffer;
+        uint64_t  strandDescBuffer;
+        uint64_t  debugBuffer {0};          // HairDebugStatistics + per-pixel fragment counters, 0 for debug color modes
+
+        static vk::PushConstantRange getPushConstantRange()
+        {
+            return vk::PushConstantRange()
+                .setSize(sizeof(DebugPushConstant))
+                .setOffset(0)
+                .setStageFlags(PushConstant::sShaderStages);
+        }
+    };
+
+    struct OverdrawPushConstant
+    {
+        uint64_t  debugBuffer;
+        int32_t   viewportWidth;
+        int32_t   viewportHeight;
+        float     maxOverdraw;              // Fragments per pixel at the top of the color ramp
+        float     opacity;
+
+        static vk::PushConstantRange getPushConstantRange()
+        {
+            return vk::PushConstantRange()
+                .setSize(sizeof(OverdrawPushConstant))
+                .setOffset(0)
+                .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+        }
+    };
+
+    struct ExpandPushConstant
+    {
+        glm::mat4 model;
+
+        int32_t   vertexCount;
+        int32_t   strandCount;
+        int32_t   _pad0 {-1};
+        int32_t   _pad1 {-1};
+
+        uint64_t  vertexBuffer;
+        uint64_t  strandDescBuffer;
+        uint64_t  ribbonBuffer;
+
+        static vk::PushConstantRange getPushConstantRange()
+        {
+            return vk::PushConstantRange()
+                .setSize(sizeof(ExpandPushConstant))
+                .setOffset(0)
+                .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+        }
+    };
+
+    struct ClusterCullPushConstant
+    {
+        glm::mat4 model;
+
+        int32_t   level;
+        int32_t   levelOffset;
+        int32_t   nextLevelOffset;
+        float     minScreenSize;        // Pixels, clusters whose lod metric projects smaller than this are culled
+
+        float     viewportHeight;
+        int32_t   _pad0 {-1};
+
+        uint64_t  nodeBuffer;
+        uint64_t  queueBuffer;
+        uint64_t  visibleClusterBuffer;
+        uint64_t  cullStateBuffer;
+
+        static vk::PushConstantRange getPushConstantRange()
+        {
+            return vk::PushConstantRange()
+                .setSize(sizeof(ClusterCullPushConstant))
+                .setOffset(0)
+                .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+        }
     };
 
     class HairPipeline
     {
     public:
-        explicit HairPipeline(VulkanRHI* pRHI, Descriptor* pSceneDescriptor);
+        explicit HairPipeline(VulkanRHI* pRHI, RenderGraph* pRenderGraph, Descriptor* pSceneDescriptor);
 
-        void renderHairModel(
-            const HairModel* pHairModel,
-            const CommandList*     pCommandList,
-            const Frame&     frameInfo) const;
+        ~HairPipeline();
+
+        /**
+         * Declare the passes rendering a HairModel into colorTarget on the RenderGraph.
+         */
+        void addPasses(
+            HairModel*          pHairModel,
+            RenderGraphResource colorTarget,
+            const Frame&        frameInfo) const;
+
+        /**
+         * PipelineStatistics scope of a pass: "<HairModel> | <Render Path>[ + Culling] | <Pass>".
+         */
+        static std::string getStatisticsScope(const HairModel* pHairModel, std::string_view pass);
 
     private:
-        std::unique_ptr<Image>      mDepthBuffer;
+        static SpecializationConstants getDrawSpecialization(HairRenderingMode renderingMode, bool clusterCulling);
+
+        /**
+         * Smallest power of two workgroup covering the average strand, one iteration per lane for typical grooms.
+         */
+        static SpecializationConstants getExpandSpecialization(const HairModel* pHairModel);
+
+        void expandHairModel(const HairModel* pHairModel, const Pipeline* pipeline, const vk::CommandBuffer& commandBuffer, const glm::mat4& model) const;
+
+        /**
+         * Traverse the cluster BVH level by level with indirect dispatches,
+         * producing the visible cluster list and the indirect mesh task draw.
+         */
+        void cullHairModel(const HairModel* pHairModel, const vk::CommandBuffer& commandBuffer, const Frame& frameInfo) const;
+
+        /**
+         * After a performance mode draw: resolve the overdraw heatmap and copy the statistics to the frame's readback buffer.
+         */
+        void addDebugResolvePasses(
+            const HairModel*    pHairModel,
+            RenderGraphResource colorTarget,
+            RenderGraphResource debugBuffer,
+            const Frame&        frameInfo) const;
+
+        void createDebugBuffer(const vk::Extent2D& extent);
+
+        static RenderGraphImageInfo getDepthBufferInfo(const vk::Extent2D& extent);
+
+        RenderGraphResource         mDepthBuffer;       // Transient, redeclared with the new extent on Swapchain recreation
+        uint32_t                    mSwapchainCallback;
         std::unique_ptr<RenderPass> mRenderPass;
-        std::unique_ptr<Pipeline>   mPipeline;
+        std::unique_ptr<PipelineVariants> mPipelines;       // HairRenderPath::MeshShader
+
+        std::unique_ptr<PipelineVariants> mExpandPipelines; // HairRenderPath::ComputeExpansion, CachedRibbons
+        std::unique_ptr<Pipeline>   mRibbonPipeline;
+
+        std::unique_ptr<Pipeline>   mClusterCullPipeline;
+
+        // Debug and performance HairRenderingModes, HairRenderPath::MeshShader only
+        struct DebugReadback
+        {
+            std::unique_ptr<Buffer>     buffer;
+            const HairModel*            pHairModel = nullptr;   // Copied in the frame that last used the slot
+        };
+
+        std::unique_ptr<PipelineVariants> mDebugPipelines;
+        std::unique_ptr<Pipeline>   mOverdrawPipeline;
+        std::unique_ptr<RenderPass> mOverlayRenderPass;         // Loads the color target, no depth
+        std::unique_ptr<Buffer>     mDebugBuffer;               // HairDebugStatistics + per-pixel fragment counters
+        mutable std::vector<DebugReadback> mDebugReadbacks;     // [Frame Index]
 
         Descriptor*                 mDescriptor;
 
+        RenderGraph*                mRenderGraph;
         VulkanRHI*                  mRHI;
     };
 }
@@ -20,6 +20,12 @@ namespace nbl
         void draw() override;
 
     private:
+        void drawDebugStatistics() const;
+
+        void drawPipelineStatistics() const;
+
+        void drawPipelineCompilation() const;
+
         HairModel*  mHairModel;
         std::string mComponentName;
     };
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace nbl
+{
+    /**
+     * Strand order policies applied by the hair builder before strandlets are generated.
+     * Source:               Order of the .hair file.
+     * Morton:               Morton (Z-order) code of the strand root positions.
+     * LengthBucketed:       Coarse spatial buckets in Morton order, strands sorted by length within a bucket.
+     * MortonLengthBucketed: LengthBucketed with equal length strands kept in Morton order.
+     */
+    enum class StrandOrder : int32_t
+    {
+        Source               = 0,
+        Morton               = 1,
+        LengthBucketed       = 2,
+        MortonLengthBucketed = 3,
+    };
+
+    std::string toString(StrandOrder strandOrder);
+
+    struct StrandReorderInfo
+    {
+        StrandOrder                policy        = StrandOrder::Source;
+        std::span<const glm::vec3> rootPositions = {};
+        std::span<const int32_t>   pointCounts   = {};
+        uint32_t                   bucketBits    = 4;   // Bits per axis of the coarse spatial buckets
+    };
+
+    /**
+     * Compute a strand permutation for the given policy.
+     * @return Source strand IDs in their new order, result[newIndex] = sourceIndex.
+     */
+    std::vector<int32_t> computeStrandOrder(const StrandReorderInfo& reorderInfo);
+
+    /**
+     * Interleave the lower 10 bits of each component into a 30-bit Morton code.
+     */
+    uint32_t mortonEncode3D(glm::uvec3 cell);
+}
@@ -31,6 +31,7 @@ namespace nbl::wsi
         uint32_t               height           = 720;
         std::string            title            = "Unknown Nebula Window";
         bool                   autoResolution   = false;
+        bool                   resizable        = true;
         WindowResolutionPreset resolutionPreset = WindowResolutionPreset::None;
     };
 
@@ -60,6 +61,8 @@ namespace nbl::wsi
     private:
         static void defaultKeyHandler(GLFWwindow* window, int key, int scancode, int action, int mods);
 
+        static void framebufferSizeHandler(GLFWwindow* window, int width, int height);
+
         GLFWwindow* mWindow = nullptr;
 
         Size2D      mFramebufferSize;
@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
 
 #include <app/App.hpp>
 #include <nbl/VulkanRHI.hpp>
@@ -16,6 +21,65 @@ int main(int argc, char** argv)
 
     const std::string name = "nbl::Engine";
 
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    // --descriptor-buffer: Scene descriptors via VK_EXT_descriptor_buffer
+    const bool descriptorBuffer = std::ranges::contains(args, "--descriptor-buffer");
+
+    // --frames-in-flight <count>: Frames the CPU may record ahead of the GPU
+    uint32_t framesInFlight = 2;
+    if (const auto it = std::ranges::find(args, "--frames-in-flight");
+        it != std::end(args) && std::next(it) != std::end(args))
+    {
+        framesInFlight = std::stoul(*std::next(it));
+    }
+
+    // --present-mode <fifo|mailbox|immediate>: Falls back if unsupported, immediate / mailbox trade tearing for latency
+    vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;
+    if (const auto it = std::ranges::find(args, "--present-mode");
+        it != std::end(args) && std::next(it) != std::end(args))
+    {
+        const std::map<std::string, vk::PresentModeKHR> presentModes = {
+            { "fifo",      vk::PresentModeKHR::eFifo      },
+            { "mailbox",   vk::PresentModeKHR::eMailbox   },
+            { "immediate", vk::PresentModeKHR::eImmediate },
+        };
+
+        if (const auto mode = presentModes.find(*std::next(it)); mode != presentModes.end())
+        {
+            presentMode = mode->second;
+        }
+        else
+        {
+            fmt::println("Unknown present mode {}, using mailbox", *std::next(it));
+        }
+    }
+
+    // --rendering-mode <normal|quads|strands|strandlets|overdraw|lanes|mesh-groups>: Modes other than normal need the MeshShader render path
+    HairRenderingMode renderingMode = HairRenderingMode::Normal;
+    if (const auto it = std::ranges::find(args, "--rendering-mode");
+        it != std::end(args) && std::next(it) != std::end(args))
+    {
+        const std::map<std::string, HairRenderingMode> renderingModes = {
+            { "normal",      HairRenderingMode::Normal          },
+            { "quads",       HairRenderingMode::DebugQuads      },
+            { "strands",     HairRenderingMode::DebugStrands    },
+            { "strandlets",  HairRenderingMode::DebugStrandlets },
+            { "overdraw",    HairRenderingMode::Overdraw        },
+            { "lanes",       HairRenderingMode::LaneUtilization },
+            { "mesh-groups", HairRenderingMode::MeshGroups      },
+        };
+
+        if (const auto mode = renderingModes.find(*std::next(it)); mode != renderingModes.end())
+        {
+            renderingMode = mode->second;
+        }
+        else
+        {
+            fmt::println("Unknown rendering mode {}, using normal", *std::next(it));
+        }
+    }
+
     gApp = App::createApp({
         .windowInfo = {
             .title            = name,
@@ -23,13 +87,70 @@ int main(int argc, char** argv)
         },
         .rhiInfo    = {
             .validation      = true,
-            .backBufferCount = 2,
+            .backBufferCount = std::max(2u, framesInFlight),
+            .framesInFlight  = framesInFlight,
+            .presentMode     = presentMode,
             .applicationName = name,
             .engineName      = name,
         },
+        .descriptorBackend = descriptorBuffer ? DescriptorBackend::Buffer : DescriptorBackend::Pool,
     });
 
-    gApp->run();
+    for (const auto& hairModel : gApp->getHairModels())
+    {
+        hairModel->setRenderingMode(renderingMode);
+    }
+
+    // --memory-report <file>: JSON snapshot of GPU allocations on exit
+    std::string memoryReportPath;
+    if (const auto it = std::ranges::find(args, "--memory-report");
+        it != std::end(args) && std::next(it) != std::end(args))
+    {
+        memoryReportPath = *std::next(it);
+    }
+
+    // --frame-report <file>: CSV of per-frame lifecycle timings on exit
+    std::string frameReportPath;
+    if (const auto it = std::ranges::find(args, "--frame-report");
+        it != std::end(args) && std::next(it) != std::end(args))
+    {
+        frameReportPath = *std::next(it);
+    }
+
+    // --bench-render-paths [frameCount]
+    if (const auto it = std::ranges::find(args, "--bench-render-paths");
+        it != std::end(args))
+    {
+        const auto next = std::next(it);
+        const uint32_t frameCount = (next != std::end(args) && !next->starts_with("--")) ? std::stoul(*next) : 1000;
+        gApp->benchmarkRenderPaths(frameCount);
+    }
+    else
+    {
+        gApp->run();
+    }
+
+    // Performance rendering modes read back HairDebugStatistics, report those of the last completed frame.
+    for (const auto& hairModel : gApp->getHairModels())
+    {
+        if (const auto& statistics = hairModel->getDebugStatistics(); statistics.has_value())
+        {
+            fmt::println("[Hair Debug] {} | {}: overdraw avg {:.2f} max {} on {} pixels, {} task / {} mesh workgroups (max {} per task), lane utilization {:.1f}%",
+                hairModel->getName(), toString(hairModel->getRenderingMode()), statistics->getAverageOverdraw(),
+                statistics->maxOverdraw, statistics->coveredPixelCount, statistics->taskGroupCount, statistics->meshGroupCount,
+                statistics->maxMeshGroups, statistics->getLaneUtilization() * 100.0f);
+        }
+    }
+
+    if (!memoryReportPath.empty())
+    {
+        gApp->writeMemoryReport(memoryReportPath);
+    }
+
+    if (!frameReportPath.empty())
+    {
+        gApp->writeFrameReport(frameReportPath);
+    }
 
     return 0;
 }
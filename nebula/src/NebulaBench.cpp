@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <map>
+#include <ranges>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+
+#include <bench/Benchmark.hpp>
+
+namespace
+{
+    /**
+     * Value of "--option <value>", fallback if the option is not given.
+     */
+    std::string getOption(const std::vector<std::string>& args, const std::string& option, const std::string& fallback = {})
+    {
+        if (const auto it = std::ranges::find(args, option);
+            it != std::end(args) && std::next(it) != std::end(args))
+        {
+            return *std::next(it);
+        }
+        return fallback;
+    }
+
+    /**
+     * Comma separated values of "--option a,b,c" converted with parse, fallback if the option is not given.
+     */
+    template <class T, class F>
+    std::vector<T> getListOption(const std::vector<std::string>& args, const std::string& option, const std::vector<T>& fallback, F&& parse)
+    {
+        const std::string value = getOption(args, option);
+        if (value.empty())
+        {
+            return fallback;
+        }
+
+        std::vector<T> result;
+        for (const auto& item : value | std::views::split(','))
+        {
+            result.push_back(parse(std::string(std::string_view(item))));
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace nbl;
+
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    const std::map<std::string, HairRenderPath> renderPaths = {
+        { "mesh",    HairRenderPath::MeshShader       },
+        { "compute", HairRenderPath::ComputeExpansion },
+        { "cached",  HairRenderPath::CachedRibbons    },
+    };
+
+    const std::map<std::string, HairRenderingMode> renderingModes = {
+        { "normal",      HairRenderingMode::Normal          },
+        { "quads",       HairRenderingMode::DebugQuads      },
+        { "strands",     HairRenderingMode::DebugStrands    },
+        { "strandlets",  HairRenderingMode::DebugStrandlets },
+        { "overdraw",    HairRenderingMode::Overdraw        },
+        { "lanes",       HairRenderingMode::LaneUtilization },
+        { "mesh-groups", HairRenderingMode::MeshGroups      },
+    };
+
+    const std::map<std::string, vk::PresentModeKHR> presentModes = {
+        { "fifo",      vk::PresentModeKHR::eFifo      },
+        { "mailbox",   vk::PresentModeKHR::eMailbox   },
+        { "immediate", vk::PresentModeKHR::eImmediate },
+    };
+
+    BenchmarkCreateInfo createInfo;
+
+    // --models <a.hair,b.hair>: Hair assets, each one is measured with every configuration
+    createInfo.hairModels = getListOption<std::string>(args, "--models", createInfo.hairModels, [](const std::string& s) { return s; });
+
+    // --render-paths <mesh,compute,cached>
+    createInfo.renderPaths = getListOption<HairRenderPath>(args, "--render-paths", createInfo.renderPaths, [&](const std::string& s) {
+        return renderPaths.at(s);
+    });
+
+    // --frames-in-flight <1,2,3>
+    createInfo.framesInFlight = getListOption<uint32_t>(args, "--frames-in-flight", createInfo.framesInFlight, [](const std::string& s) {
+        return static_cast<uint32_t>(std::stoul(s));
+    });
+
+    // --lod <0,2,4>: Minimum cluster screen size in pixels
+    createInfo.minClusterSizes = getListOption<float>(args, "--lod", createInfo.minClusterSizes, [](const std::string& s) {
+        return std::stof(s);
+    });
+
+    // --culling <on,off>
+    createInfo.clusterCulling = getListOption<bool>(args, "--culling", createInfo.clusterCulling, [](const std::string& s) {
+        return s == "on";
+    });
+
+    // --rendering-modes <normal,overdraw,lanes,mesh-groups,...>: Performance modes also report HairDebugStatistics
+    createInfo.renderingModes = getListOption<HairRenderingMode>(args, "--rendering-modes", createInfo.renderingModes, [&](const std::string& s) {
+        return renderingModes.at(s);
+    });
+
+    // --warmup <frames>, --frames <frames>, --frame-time <seconds>: Fixed time step of the camera path
+    createInfo.warmupFrameCount = std::stoul(getOption(args, "--warmup", std::to_string(createInfo.warmupFrameCount)));
+    createInfo.frameCount       = std::stoul(getOption(args, "--frames", std::to_string(createInfo.frameCount)));
+    createInfo.frameTime        = std::stof(getOption(args, "--frame-time", std::to_string(createInfo.frameTime)));
+
+    // --camera-path <file>: Keyframes, see CameraPath::loadKeyframes
+    createInfo.cameraPath = getOption(args, "--camera-path");
+
+    // --output <prefix>: Writes <prefix>.csv and <prefix>.json
+    createInfo.outputPath = getOption(args, "--output", createInfo.outputPath);
+
+    // --present-mode <fifo|mailbox|immediate>: Immediate by default, FIFO caps frame times at the refresh rate
+    if (const std::string presentMode = getOption(args, "--present-mode"); !presentMode.empty())
+    {
+        createInfo.presentMode = presentModes.at(presentMode);
+    }
+
+    createInfo.validation = std::ranges::contains(args, "--validation");
+    createInfo.windowInfo = {
+        .title            = "nbl::Benchmark",
+        .resizable        = false,
+        .resolutionPreset = wsi::WindowResolutionPreset::w1920_h1080,
+    };
+
+    Benchmark::createBenchmark(createInfo)->run();
+
+    return 0;
+}
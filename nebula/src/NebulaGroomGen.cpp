@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+
+#include <hair/GroomGenerator.hpp>
+
+namespace
+{
+    std::string getOption(const std::vector<std::string>& args, const std::string& option, const std::string& fallback = {})
+    {
+        if (const auto it = std::ranges::find(args, option);
+            it != std::end(args) && std::next(it) != std::end(args))
+        {
+            return *std::next(it);
+        }
+        return fallback;
+    }
+}
+
+/**
+ * Procedural groom generator, writes a .hair file.
+ * --output <file.hair>           Required
+ * --strands <n>, --points <n>    Strand count and points per strand
+ * --seed <n>
+ * --scalp <file.obj>             Roots on a scalp mesh instead of a sphere, --radius <r> of the sphere
+ * --length <mean>, --length-stddev <sigma>, --gravity <g>
+ * --curl-radius <r>, --curl-turns <n>
+ * --clumps <n>, --clump-strength <[0, 1]>
+ */
+int main(int argc, char** argv)
+{
+    using namespace nbl;
+
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    const std::string outputPath = getOption(args, "--output");
+    if (outputPath.empty())
+    {
+        fmt::println(stderr, "[Error] Missing --output <file.hair>");
+        return 1;
+    }
+
+    const GroomGenerateInfo defaults;
+    const std::string       scalpMesh = getOption(args, "--scalp");
+
+    const GroomGenerateInfo generateInfo = {
+        .strandCount     = static_cast<uint32_t>(std::stoul(getOption(args, "--strands", std::to_string(defaults.strandCount)))),
+        .pointsPerStrand = static_cast<uint32_t>(std::stoul(getOption(args, "--points", std::to_string(defaults.pointsPerStrand)))),
+        .seed            = static_cast<uint32_t>(std::stoul(getOption(args, "--seed", std::to_string(defaults.seed)))),
+        .rootShape       = scalpMesh.empty() ? GroomRootShape::Sphere : GroomRootShape::Mesh,
+        .sphereRadius    = std::stof(getOption(args, "--radius", std::to_string(defaults.sphereRadius))),
+        .scalpMeshPath   = scalpMesh,
+        .lengthMean      = std::stof(getOption(args, "--length", std::to_string(defaults.lengthMean))),
+        .lengthStdDev    = std::stof(getOption(args, "--length-stddev", std::to_string(defaults.lengthStdDev))),
+        .gravity         = std::stof(getOption(args, "--gravity", std::to_string(defaults.gravity))),
+        .curlRadius      = std::stof(getOption(args, "--curl-radius", std::to_string(defaults.curlRadius))),
+        .curlTurns       = std::stof(getOption(args, "--curl-turns", std::to_string(defaults.curlTurns))),
+        .clumpCount      = static_cast<uint32_t>(std::stoul(getOption(args, "--clumps", std::to_string(defaults.clumpCount)))),
+        .clumpStrength   = std::clamp(std::stof(getOption(args, "--clump-strength", std::to_string(defaults.clumpStrength))), 0.0f, 1.0f),
+    };
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    cyHairFile hairFile;
+    generateGroom(generateInfo, hairFile);
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    if (hairFile.SaveToFile(outputPath.c_str()) < 0)
+    {
+        fmt::println(stderr, "[Error] Failed to write {}", outputPath);
+        return 1;
+    }
+
+    fmt::println("[Notice] Generated {} strands ({} points, {} roots) in {:.2f} ms: {}",
+        generateInfo.strandCount,
+        generateInfo.strandCount * std::max(2u, generateInfo.pointsPerStrand),
+        toString(generateInfo.rootShape),
+        elapsed,
+        outputPath);
+
+    return 0;
+}
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+
+#include <hair/GroomGenerator.hpp>
+#include <hair/HairGeometry.hpp>
+#include <hair/HairModel.hpp>
+#include <nbl/VulkanRHI.hpp>
+#include <wsi/Window.hpp>
+
+#pragma region "Allocation Tracking"
+
+namespace
+{
+    std::atomic<uint64_t> gAllocationCount {0};
+    std::atomic<uint64_t> gAllocatedBytes  {0};
+    std::atomic<int64_t>  gCurrentBytes    {0};
+    std::atomic<int64_t>  gPeakBytes       {0};
+
+    // Allocations carry their size in front of the returned pointer, unsized delete needs it.
+    constexpr size_t gHeaderSize = alignof(std::max_align_t);
+
+    void* trackedAllocate(const size_t size)
+    {
+        auto* block = static_cast<std::byte*>(std::malloc(size + gHeaderSize));
+        if (!block)
+        {
+            throw std::bad_alloc();
+        }
+        *reinterpret_cast<size_t*>(block) = size;
+
+        gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        const int64_t current = gCurrentBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+        int64_t peak = gPeakBytes.load(std::memory_order_relaxed);
+        while (current > peak && !gPeakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+
+        return block + gHeaderSize;
+    }
+
+    void trackedFree(void* ptr) noexcept
+    {
+        if (!ptr) return;
+        auto* block = static_cast<std::byte*>(ptr) - gHeaderSize;
+        gCurrentBytes.fetch_sub(static_cast<int64_t>(*reinterpret_cast<size_t*>(block)), std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+void* operator new(const size_t size)                  { return trackedAllocate(size); }
+void* operator new[](const size_t size)                { return trackedAllocate(size); }
+void  operator delete(void* ptr) noexcept              { trackedFree(ptr); }
+void  operator delete[](void* ptr) noexcept            { trackedFree(ptr); }
+void  operator delete(void* ptr, size_t) noexcept      { trackedFree(ptr); }
+void  operator delete[](void* ptr, size_t) noexcept    { trackedFree(ptr); }
+
+#pragma endregion
+
+namespace
+{
+    using namespace nbl;
+
+    struct StageResult
+    {
+        std::string stage;
+        double      ms          = 0.0;      // Median of the iterations
+        uint64_t    allocations = 0;
+        uint64_t    bytes       = 0;        // Allocated during the stage
+        int64_t     peakBytes   = 0;        // Peak heap growth above the stage start
+    };
+
+    struct AssetResult
+    {
+        std::string              asset;
+        StrandOrder              strandOrder;
+        uint32_t                 strandCount = 0;
+        uint64_t                 inputBytes  = 0;   // Points and segments of the hair file
+        std::vector<StageResult> stages;
+    };
+
+    /**
+     * Run stage once per iteration on a fresh setup, report the median time and the allocations of the last run.
+     */
+    StageResult measure(
+        const std::string&                                    stage,
+        const uint32_t                                        iterations,
+        const std::function<std::shared_ptr<HairGeometry>()>& setup,
+        const std::function<void(HairGeometry&)>&             run)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        StageResult         result { .stage = stage };
+        std::vector<double> times;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            const auto geometry = setup();
+
+            const uint64_t allocations = gAllocationCount.load();
+            const uint64_t bytes       = gAllocatedBytes.load();
+            const int64_t  current     = gCurrentBytes.load();
+            gPeakBytes.store(current);
+
+            const auto begin = Clock::now();
+            run(*geometry);
+            times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+
+            result.allocations = gAllocationCount.load() - allocations;
+            result.bytes       = gAllocatedBytes.load() - bytes;
+            result.peakBytes   = gPeakBytes.load() - current;
+        }
+
+        std::ranges::nth_element(times, times.begin() + static_cast<ptrdiff_t>(times.size() / 2));
+        result.ms = times[times.size() / 2];
+        return result;
+    }
+
+    std::vector<std::string> split(const std::string& value)
+    {
+        std::vector<std::string> result;
+        for (const auto& item : value | std::views::split(','))
+        {
+            result.emplace_back(std::string_view(item));
+        }
+        return result;
+    }
+
+    std::string getOption(const std::vector<std::string>& args, const std::string& option, const std::string& fallback = {})
+    {
+        if (const auto it = std::ranges::find(args, option);
+            it != std::end(args) && std::next(it) != std::end(args))
+        {
+            return *std::next(it);
+        }
+        return fallback;
+    }
+}
+
+/**
+ * CPU microbenchmark of the HairModel construction stages.
+ * --models <a.hair,b.hair>       Real assets
+ * --synthetic <1000,100000>      Synthetic assets by strand count, --points <n> points per strand
+ * --orders <source,morton,...>   Strand order variants of the builder (default: morton)
+ * --iterations <n>               Median of n runs per stage
+ * --gpu                          Also measure buffer creation and upload on a VulkanRHI device
+ * --output <file.csv>
+ */
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    const std::vector<std::string> models     = split(getOption(args, "--models", "wWavy.hair"));
+    const std::vector<std::string> synthetic  = split(getOption(args, "--synthetic", "1000,10000,100000"));
+    const uint32_t                 points     = std::stoul(getOption(args, "--points", "32"));
+    const uint32_t                 iterations = std::max(1ul, std::stoul(getOption(args, "--iterations", "5")));
+    const std::string              outputPath = getOption(args, "--output");
+
+    const std::map<std::string, StrandOrder> strandOrders = {
+        { "source",        StrandOrder::Source               },
+        { "morton",        StrandOrder::Morton               },
+        { "length",        StrandOrder::LengthBucketed       },
+        { "morton-length", StrandOrder::MortonLengthBucketed },
+    };
+
+    std::vector<StrandOrder> orders;
+    for (const auto& order : split(getOption(args, "--orders", "morton")))
+    {
+        orders.push_back(strandOrders.at(order));
+    }
+
+    // Buffer creation needs a device, CPU stages run without one.
+    std::unique_ptr<wsi::Window> window;
+    std::unique_ptr<VulkanRHI>   rhi;
+    if (std::ranges::contains(args, "--gpu"))
+    {
+        window = wsi::Window::createWindow({ .title = "nbl::HairBench", .resizable = false });
+        rhi    = VulkanRHI::createVulkanRHI({
+            .pWindow       = window.get(),
+            .configuration = { .applicationName = "nbl::HairBench", .engineName = "nbl::HairBench" },
+        });
+    }
+
+    // Asset name, setup of a geometry with a filled hair file
+    std::vector<std::pair<std::string, std::function<std::shared_ptr<HairGeometry>(StrandOrder)>>> assets;
+    for (const auto& model : models)
+    {
+        assets.emplace_back(model, [model](const StrandOrder order) -> std::shared_ptr<HairGeometry> {
+            auto geometry = HairGeometry::createHairGeometry({ .filePath = model, .strandOrder = order });
+            geometry->loadFile();
+            return geometry;
+        });
+    }
+    for (const auto& count : synthetic | std::views::filter([](const auto& s) { return !s.empty(); }))
+    {
+        const auto strandCount = static_cast<uint32_t>(std::stoul(count));
+        assets.emplace_back(fmt::format("synthetic-{}", strandCount), [strandCount, points](const StrandOrder order) -> std::shared_ptr<HairGeometry> {
+            auto geometry = HairGeometry::createHairGeometry({ .name = fmt::format("synthetic-{}", strandCount), .strandOrder = order });
+            generateGroom({ .strandCount = strandCount, .pointsPerStrand = points, .seed = strandCount }, geometry->getHairFile());
+            return geometry;
+        });
+    }
+
+    std::vector<AssetResult> results;
+    for (const auto& [asset, load] : assets)
+    for (const StrandOrder order : orders)
+    {
+        // Every stage starts from the output of the stages before it.
+        const auto upTo = [&load, order](const uint32_t stageCount) {
+            return [&load, order, stageCount]() -> std::shared_ptr<HairGeometry> {
+                auto geometry = load(order);
+                if (stageCount > 0) geometry->processVertices();
+                if (stageCount > 1) geometry->reorderStrands();
+                if (stageCount > 2) geometry->processStrands();
+                if (stageCount > 3) geometry->buildClusterHierarchy();
+                return geometry;
+            };
+        };
+
+        const auto probe = upTo(0)();
+        const auto& header = probe->getHairFile().GetHeader();
+
+        AssetResult result {
+            .asset       = asset,
+            .strandOrder = order,
+            .strandCount = header.hair_count,
+            .inputBytes  = uint64_t(header.point_count) * 3 * sizeof(float)
+                         + (probe->getHairFile().GetSegmentsArray() ? uint64_t(header.hair_count) * sizeof(uint16_t) : 0),
+        };
+
+        if (asset.ends_with(".hair"))
+        {
+            result.stages.push_back(measure("loadFile", iterations,
+                [&asset, order] { return HairGeometry::createHairGeometry({ .filePath = asset, .strandOrder = order }); },
+                [](HairGeometry& geometry) { geometry.loadFile(); }));
+        }
+        result.stages.push_back(measure("processVertices",       iterations, upTo(0), [](HairGeometry& g) { g.processVertices();       }));
+        result.stages.push_back(measure("reorderStrands",        iterations, upTo(1), [](HairGeometry& g) { g.reorderStrands();        }));
+        result.stages.push_back(measure("processStrands",        iterations, upTo(2), [](HairGeometry& g) { g.processStrands();        }));
+        result.stages.push_back(measure("buildClusterHierarchy", iterations, upTo(3), [](HairGeometry& g) { g.buildClusterHierarchy(); }));
+
+        if (rhi)
+        {
+            const std::shared_ptr<const HairGeometry> geometry = upTo(4)();
+            const auto empty = [] -> std::shared_ptr<HairGeometry> { return HairGeometry::createHairGeometry({}); };
+            result.stages.push_back(measure("createBuffers", iterations, empty, [&](HairGeometry&) {
+                const auto model = HairModel::createHairModel({ .pRHI = rhi.get(), .geometry = geometry });
+            }));
+        }
+
+        results.push_back(std::move(result));
+    }
+
+    fmt::println("{:<22} {:<24} {:<22} {:>10} {:>12} {:>10} {:>8} {:>12} {:>12}",
+        "Asset", "Strand Order", "Stage", "ms", "Strands/s", "MB/s", "Allocs", "Alloc [KiB]", "Peak [KiB]");
+
+    std::ofstream csv;
+    if (!outputPath.empty())
+    {
+        csv.open(outputPath);
+        if (!csv)
+        {
+            throw std::runtime_error(fmt::format("Failed to open {} for writing", outputPath));
+        }
+        csv << "asset,strand_order,strands,input_bytes,stage,ms,strands_per_s,mb_per_s,allocations,allocated_bytes,peak_bytes\n";
+    }
+
+    for (const auto& result : results)
+    {
+        for (const auto& stage : result.stages)
+        {
+            const double seconds       = std::max(stage.ms, 1e-6) / 1000.0;
+            const double strandsPerSec = result.strandCount / seconds;
+            const double mbPerSec      = static_cast<double>(result.inputBytes) / (1024.0 * 1024.0) / seconds;
+
+            fmt::println("{:<22} {:<24} {:<22} {:>10.3f} {:>12.0f} {:>10.1f} {:>8} {:>12} {:>12}",
+                result.asset, toString(result.strandOrder), stage.stage, stage.ms, strandsPerSec, mbPerSec,
+                stage.allocations, stage.bytes / 1024, stage.peakBytes / 1024);
+
+            if (csv.is_open())
+            {
+                csv << fmt::format("{},{},{},{},{},{:.4f},{:.0f},{:.2f},{},{},{}\n",
+                    result.asset, toString(result.strandOrder), result.strandCount, result.inputBytes, stage.stage,
+                    stage.ms, strandsPerSec, mbPerSec, stage.allocations, stage.bytes, stage.peakBytes);
+            }
+        }
+    }
+
+    return 0;
+}
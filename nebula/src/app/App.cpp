@@ -1,12 +1,25 @@
 #include "app/App.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include <fmt/format.h>
 
-#include "Barrier.hpp"
+#include "hair/GroomGenerator.hpp"
 
 namespace nbl
 {
+    // Packed layout of the Scene Descriptor update template
+    struct SceneBindings
+    {
+        vk::DescriptorBufferInfo camera;
+    };
+
     App::App(const AppCreateInfo& createInfo)
+    : mStrandOrder(createInfo.strandOrder)
+    , mDescriptorBackend(createInfo.descriptorBackend)
     {
         mWindow = wsi::Window::createWindow(createInfo.windowInfo);
 
@@ -22,17 +35,34 @@ namespace nbl
 
         createCameraResources();
 
-        loadHairModels();
+        loadHairModels(createInfo.hairModels);
+
+        mRenderGraph = mRHI->createRenderGraph({
+            .debugName = "Frame Graph",
+        });
+
+        mHairPipeline = std::make_unique<HairPipeline>(mRHI.get(), mRenderGraph.get(), mSceneDescriptor.get());
 
-        mHairPipeline = std::make_unique<HairPipeline>(mRHI.get(), mSceneDescriptor.get());
+        mRHI->addSwapchainCallback([this](const Swapchain& swapchain) {
+            const auto [width, height] = swapchain.getExtent();
+            mCamera->setSize(glm::ivec2(width, height));
+        });
     }
 
     void App::run()
     {
         while (!mWindow->willClose())
         {
+            mRHI->getFrameProfiler()->mark(FramePhase::InputPoll);
             glfwPollEvents();
 
+            // Minimized, there is no Swapchain extent to render to.
+            if (const auto [width, height] = mWindow->getFramebufferSize(); width == 0 || height == 0)
+            {
+                glfwWaitEvents();
+                continue;
+            }
+
             // if (!mUI->wantCaptureKeyboard())
             // {
                 mCamera->registerKeys(mWindow->getHandle());
@@ -42,35 +72,153 @@ namespace nbl
                 mCamera->registerMouse(mWindow->getHandle());
             // }
 
-            Frame frameInfo = mRHI->beginFrame();
-            const uint32_t currentFrame = frameInfo.currentFrame;
-            auto* commandList = mRHI->getGraphicsQueue()->getCommandList(currentFrame);
+            renderFrame(*mCamera);
+        }
+    }
 
-            // mUI->update();
+    void App::writeMemoryReport(const std::string& filePath) const
+    {
+        mRHI->getDevice()->getMemoryTracker()->writeJson(filePath);
+        fmt::println("Memory report written to {}", filePath);
+    }
 
-            const auto cameraData = mCamera->getCameraData();
-            mUniformBuffer[currentFrame]->setData(&cameraData, sizeof(CameraData), 0);
+    void App::writeFrameReport(const std::string& filePath) const
+    {
+        const FramePacingSummary summary = mRHI->getFrameProfiler()->getSummary();
+        fmt::println("Frame pacing over {} frames: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+            summary.frameCount, summary.p50Ms, summary.p95Ms, summary.p99Ms, summary.maxMs);
+
+        mRHI->getFrameProfiler()->writeCsv(filePath);
+        fmt::println("Frame report written to {}", filePath);
+    }
+
+    void App::benchmarkRenderPaths(const uint32_t frameCount, const uint32_t warmupFrameCount)
+    {
+        FrameProfiler* profiler = mRHI->getFrameProfiler();
 
-            commandList->begin();
+        const HairRenderPath initialPath = mActiveHairModel->getRenderPath();
+
+        fmt::println("[Benchmark] {} ({} strands, {} vertices), {} frames after {} warm-up frames",
+            mActiveHairModel->getName(), mActiveHairModel->getStrandCount(), mActiveHairModel->getVertexCount(),
+            frameCount, warmupFrameCount);
+        if (!profiler->hasGpuTimestamps())
+        {
+            fmt::println("[Notice] Timestamp queries are unsupported, GPU times are not reported.");
+        }
+        fmt::println("{:<20} {:>12} {:>12} {:>12} {:>12} {:>12} {:>14}",
+            "Render Path", "p50 [ms]", "p99 [ms]", "GPU Avg [ms]", "GPU Min [ms]", "GPU Max [ms]", "Memory [MiB]");
+
+        const auto renderFrames = [this, profiler](const uint32_t count) {
+            for (uint32_t i = 0; i < count && !mWindow->willClose(); i++)
             {
-                mRHI->getSwapchain()->setScissorViewport(commandList->handle());
+                profiler->mark(FramePhase::InputPoll);
+                glfwPollEvents();
+                renderFrame(*mCamera);
+            }
+        };
 
-                mHairPipeline->renderHairModel(mActiveHairModel, commandList, frameInfo);
+        for (const HairRenderPath path : gHairRenderPaths)
+        {
+            if (path == HairRenderPath::MeshShader && !mRHI->getDevice()->getCapabilities().meshShader)
+            {
+                continue;
+            }
 
-                Barrier::transitionImageLayout({
-                    .commandBuffer = commandList->handle(),
-                    .imageTransitionInfo = {
-                        .pImage    = mRHI->getSwapchain()->getImage(frameInfo.acquiredImageIndex),
-                        .newLayout = vk::ImageLayout::ePresentSrcKHR,
-                    },
-                });
+            mActiveHairModel->setRenderPath(path);
+            renderFrames(warmupFrameCount);
+
+            const uint64_t firstFrame = profiler->getFrameNumber();
+            renderFrames(frameCount);
+
+            // Every measured frame has to reach the history before it is read.
+            mRHI->getGraphicsQueue()->wait(mRHI->getGraphicsQueue()->getSubmittedValue());
+            profiler->drain();
+
+            // Frame times follow the slower of CPU and GPU, the timestamps isolate the GPU cost of the path.
+            std::vector<FrameRecord> frames;
+            double gpuTotal = 0.0;
+            double gpuMin   = std::numeric_limits<double>::max();
+            double gpuMax   = 0.0;
+            uint32_t gpuCount = 0;
+            for (const FrameRecord& record : profiler->getHistory())
+            {
+                if (record.frameNumber < firstFrame) continue;
+
+                frames.push_back(record);
+                if (record.gpuMs >= 0.0)
+                {
+                    gpuTotal += record.gpuMs;
+                    gpuMin    = std::min(gpuMin, record.gpuMs);
+                    gpuMax    = std::max(gpuMax, record.gpuMs);
+                    gpuCount++;
+                }
             }
-            commandList->end();
 
-            frameInfo.addCommandLists({ commandList->handle() });
+            const FramePacingSummary summary = FrameProfiler::summarize(frames);
+            const auto gpu = [gpuCount](const double value) {
+                return gpuCount > 0 ? fmt::format("{:.3f}", value) : std::string("-");
+            };
+
+            const double memory = static_cast<double>(mActiveHairModel->getMemoryUsage(path)) / (1024.0 * 1024.0);
+            fmt::println("{:<20} {:>12.3f} {:>12.3f} {:>12} {:>12} {:>12} {:>14.2f}",
+                toString(path), summary.p50Ms, summary.p99Ms,
+                gpu(gpuTotal / std::max(gpuCount, 1u)), gpu(gpuMin), gpu(gpuMax), memory);
+
+            // Counters of the path's scopes from the last resolved measured frame.
+            for (const auto& [scope, result] : mRHI->getPipelineStatistics()->getResults())
+            {
+                if (result.frameNumber < firstFrame) continue;
 
-            mRHI->submitFrame(frameInfo);
+                fmt::println("    {:<52} VS {:>10} CS {:>10} TS {:>8} MS {:>8} Mesh Prims {:>10} Clipped Prims {:>10} FS {:>10}",
+                    scope, result.vertexShaderInvocations, result.computeShaderInvocations, result.taskShaderInvocations,
+                    result.meshShaderInvocations, result.meshPrimitivesGenerated, result.clippingPrimitives,
+                    result.fragmentShaderInvocations);
+            }
+        }
+
+        mActiveHairModel->setRenderPath(initialPath);
+    }
+
+    void App::renderFrame(const ICamera& camera)
+    {
+        Frame frameInfo = mRHI->beginFrame();
+        const uint32_t currentFrame = frameInfo.currentFrame;
+        // Frame slots are reused once their timeline value was reached, the pool was reset in beginFrame.
+        const auto commandList = CommandList::createCommandList({
+            .commandBuffer = mRHI->getCommandAllocator()->allocate(0),
+        });
+
+        // mUI->update();
+
+        // Camera constants live in the transient RingBuffer, the frame's set was last read by the frame just waited on.
+        RingBuffer* transientBuffer = mRHI->getTransientBuffer();
+        const RingAllocation cameraData = transientBuffer->push(camera.getCameraData());
+        if (!cameraData.isValid())
+        {
+            throw std::runtime_error("Transient RingBuffer exhausted, raise VulkanRHIConfiguration::transientBufferFrameSize");
+        }
+        mSceneDescriptor->update(currentFrame, SceneBindings {
+            .camera = cameraData.getDescriptorInfo(transientBuffer->getHandle()),
+        });
+
+        commandList->begin();
+        {
+            mRHI->getSwapchain()->setScissorViewport(commandList->handle());
+
+            const auto swapchainImage = mRenderGraph->importImage(
+                "Swapchain",
+                mRHI->getSwapchain()->getImage(frameInfo.acquiredImageIndex),
+                RenderGraphUsage::Present);
+
+            mHairPipeline->addPasses(mActiveHairModel, swapchainImage, frameInfo);
+
+            mRenderGraph->execute(commandList->handle(), mRHI->getCommandAllocator());
         }
+        commandList->end();
+
+        frameInfo.addCommandLists({ commandList->handle() });
+
+        mRHI->submitFrame(frameInfo);
     }
 
     void App::createCameraResources()
@@ -80,60 +228,62 @@ namespace nbl
             glm::ivec2{ extent.width, extent.height },
             glm::vec3(-17.0f, 16.0f, 144.0f));
 
-        const auto cameraData = mCamera->getCameraData();
-        for (uint32_t i = 0; i < mRHI->getSwapchain()->getImageCount(); i++)
-        {
-            mUniformBuffer[i] = mRHI->createBuffer({
-                .size      = sizeof(CameraData),
-                .type      = BufferType::Uniform,
-                .debugName = fmt::format("Camera UB {}", i),
-            });
-            mUniformBuffer[i]->setData(&cameraData, sizeof(CameraData), 0);
-        }
-
         vk::ShaderStageFlags stageFlags;
         {
             using enum vk::ShaderStageFlagBits;
-            stageFlags = eFragment | eVertex |  eTaskEXT |  eMeshEXT;
+            stageFlags = eFragment | eVertex;
+            if (mRHI->getDevice()->getCapabilities().meshShader)
+            {
+                stageFlags |= eTaskEXT | eMeshEXT | eCompute;  // Cluster culling reads the camera frustum
+            }
         }
 
         const std::vector sceneDescriptorBindings = {
             vk::DescriptorSetLayoutBinding().setBinding(0).setDescriptorType(vk::DescriptorType::eUniformBuffer).setStageFlags(stageFlags).setDescriptorCount(1),
         };
 
+        // One set per frame in flight, pointed at the frame's camera constants in renderFrame.
         mSceneDescriptor = mRHI->createDescriptor({
             .bindings = sceneDescriptorBindings,
-            .setCount = mRHI->getSwapchain()->getImageCount(),
+            .setCount = mRHI->getFramesInFlight(),
             .debugName = "Scene Descriptor",
+            .backend   = mDescriptorBackend,
         });
+    }
 
-        auto cameraInfo = vk::DescriptorBufferInfo()
-            .setOffset(0)
-            .setRange(sizeof(CameraData));
+    void App::loadHairModels(const std::vector<std::string>& hairModels)
+    {
+        mGeometryArena = mRHI->createBufferArena({
+            .type       = BufferType::Storage,
+            .debugName  = "Hair Geometry Arena",
+            .hostAccess = true,
+        });
 
-        for (uint32_t i = 0; i < mSceneDescriptor->getSetCount(); i++)
+        for (const std::string& model : hairModels)
         {
-            cameraInfo.setBuffer(mUniformBuffer[i]->getHandle());
-            const auto write = DescriptorWriteInfo()
-                .setSetIndex(i)
-                .writeUniformBuffers(0, 1, &cameraInfo);
+            // "synthetic:<strand count>": Procedural sphere groom, see hair/GroomGenerator.hpp
+            if (model.starts_with("synthetic:"))
+            {
+                const auto strandCount = static_cast<uint32_t>(std::stoul(model.substr(model.find(':') + 1)));
 
-            mSceneDescriptor->write(write);
-        }
-    }
+                auto geometry = HairGeometry::createHairGeometry({ .name = model, .strandOrder = mStrandOrder });
+                generateGroom({ .strandCount = strandCount, .curlRadius = 0.5f, .clumpCount = strandCount / 100, .clumpStrength = 0.5f },
+                              geometry->getHairFile());
+                geometry->process();
 
-    void App::loadHairModels()
-    {
-        static std::vector hairModels = {
-            /*"wCurly.hair", "wStraight.hair", "wWavy.hair", "wWavyThin.hair"*/
-            "wWavy.hair"
-        };
+                mHairModels.push_back(HairModel::createHairModel({
+                    .pRHI           = mRHI.get(),
+                    .geometry       = std::move(geometry),
+                    .pGeometryArena = mGeometryArena.get(),
+                }));
+                continue;
+            }
 
-        for (const char* model : hairModels)
-        {
             mHairModels.push_back(HairModel::createHairModel({
-                .filePath = model,
-                .pRHI     = mRHI.get(),
+                .filePath       = model,
+                .strandOrder    = mStrandOrder,
+                .pRHI           = mRHI.get(),
+                .pGeometryArena = mGeometryArena.get(),
             }));
         }
 
@@ -0,0 +1,245 @@
+#include "bench/Benchmark.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <ranges>
+#include <stdexcept>
+#include <fmt/format.h>
+
+#include "app/App.hpp"
+#include "camera/CameraPath.hpp"
+
+namespace nbl
+{
+    Benchmark::Benchmark(const BenchmarkCreateInfo& createInfo)
+    : mInfo(createInfo)
+    {
+        mInfo.windowInfo.resizable = false;   // Every scenario renders at the same extent
+    }
+
+    void Benchmark::run()
+    {
+        const float duration = static_cast<float>(mInfo.frameCount) * mInfo.frameTime;
+
+        // Matches the initial FirstPersonCamera of the App.
+        const std::vector<CameraKeyframe> keyframes = mInfo.cameraPath.empty()
+            ? CameraPath::createOrbit({ -17.0f, 16.0f, 0.0f }, 144.0f, 0.0f, duration)
+            : CameraPath::loadKeyframes(mInfo.cameraPath);
+
+        fmt::println("[Benchmark] {} warm-up + {} measured frames per scenario, {:.3f} ms camera step",
+            mInfo.warmupFrameCount, mInfo.frameCount, mInfo.frameTime * 1000.0f);
+        fmt::println("{:<16} {:<18} {:>4} {:>8} {:>6} {:<18} {:>10} {:>10} {:>10} {:>10}",
+            "Model", "Render Path", "FiF", "LOD [px]", "Cull", "Rendering Mode", "p50 [ms]", "p99 [ms]", "GPU [ms]", "Mem [MiB]");
+
+        // Frames in flight are fixed at VulkanRHI creation, only one instance may exist at a time.
+        for (const uint32_t framesInFlight : mInfo.framesInFlight)
+        {
+            const auto app = App::createApp({
+                .windowInfo = mInfo.windowInfo,
+                .rhiInfo    = {
+                    .validation       = mInfo.validation,
+                    .backBufferCount  = std::max(2u, framesInFlight),
+                    .framesInFlight   = framesInFlight,
+                    .presentMode      = mInfo.presentMode,
+                    .frameHistorySize = mInfo.warmupFrameCount + mInfo.frameCount + 64,
+                    .applicationName  = "nbl::Benchmark",
+                    .engineName       = "nbl::Benchmark",
+                },
+                .enableUI   = false,
+                .hairModels = mInfo.hairModels,
+            });
+
+            VulkanRHI*     rhi      = app->getRHI();
+            FrameProfiler* profiler = rhi->getFrameProfiler();
+
+            const auto [width, height] = rhi->getSwapchain()->getExtent();
+            const auto camera = CameraPath::createCameraPath({
+                .keyframes = keyframes,
+                .size      = glm::ivec2(width, height),
+            });
+
+            const auto renderFrames = [&](const uint32_t frameCount) {
+                for (uint32_t i = 0; i < frameCount && !app->getWindow()->willClose(); i++)
+                {
+                    profiler->mark(FramePhase::InputPoll);
+                    glfwPollEvents();
+                    camera->setTime(static_cast<float>(i) * mInfo.frameTime);
+                    app->renderFrame(*camera);
+                }
+            };
+
+            for (const auto& hairModel : app->getHairModels())
+            {
+                app->setActiveHairModel(hairModel.get());
+
+                for (const HairRenderPath renderPath : mInfo.renderPaths)
+                {
+                    const bool meshShader = renderPath == HairRenderPath::MeshShader;
+                    if (meshShader && !rhi->getDevice()->getCapabilities().meshShader)
+                    {
+                        fmt::println("[Notice] Skipping {}, VK_EXT_mesh_shader is unavailable.", toString(renderPath));
+                        continue;
+                    }
+
+                    // Culling, LOD and rendering modes only affect the MeshShader render path, other paths are measured once.
+                    const auto lodCount  = meshShader ? mInfo.minClusterSizes.size() : 1;
+                    const auto cullCount = meshShader ? mInfo.clusterCulling.size()  : 1;
+                    const auto modeCount = meshShader ? mInfo.renderingModes.size()  : 1;
+
+                    for (size_t lod = 0; lod < lodCount; lod++)
+                    for (size_t cull = 0; cull < cullCount; cull++)
+                    for (size_t mode = 0; mode < modeCount; mode++)
+                    {
+                        BenchmarkScenario scenario {
+                            .hairModel      = hairModel->getName(),
+                            .renderPath     = renderPath,
+                            .framesInFlight = framesInFlight,
+                            .minClusterSize = mInfo.minClusterSizes.empty() ? 0.0f : mInfo.minClusterSizes[lod],
+                            .clusterCulling = mInfo.clusterCulling.empty() || mInfo.clusterCulling[cull],
+                            .renderingMode  = meshShader && !mInfo.renderingModes.empty() ? mInfo.renderingModes[mode] : HairRenderingMode::Normal,
+                        };
+
+                        hairModel->setRenderPath(renderPath);
+                        hairModel->setMinClusterScreenSize(scenario.minClusterSize);
+                        hairModel->setClusterCulling(scenario.clusterCulling);
+                        hairModel->setRenderingMode(scenario.renderingMode);
+
+                        renderFrames(mInfo.warmupFrameCount);
+
+                        const uint64_t firstFrame = profiler->getFrameNumber();
+                        renderFrames(mInfo.frameCount);
+
+                        // Every measured frame has to reach the history before it is read.
+                        rhi->getGraphicsQueue()->wait(rhi->getGraphicsQueue()->getSubmittedValue());
+                        profiler->drain();
+
+                        for (const auto& record : profiler->getHistory())
+                        {
+                            if (record.frameNumber >= firstFrame)
+                            {
+                                scenario.frames.push_back(record);
+                            }
+                        }
+                        scenario.summary       = FrameProfiler::summarize(scenario.frames);
+                        scenario.geometryBytes = hairModel->getMemoryUsage(renderPath);
+                        // Scopes of earlier scenarios keep their last result, only those resolved while measuring belong here.
+                        for (const auto& [scope, result] : rhi->getPipelineStatistics()->getResults())
+                        {
+                            if (result.frameNumber >= firstFrame)
+                            {
+                                scenario.pipelineStatistics.emplace(scope, result);
+                            }
+                        }
+
+                        if (isPerformanceRenderingMode(scenario.renderingMode))
+                        {
+                            scenario.debugStatistics = hairModel->getDebugStatistics();
+                        }
+
+                        fmt::println("{:<16} {:<18} {:>4} {:>8.1f} {:>6} {:<18} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.2f}",
+                            scenario.hairModel, toString(renderPath), framesInFlight, scenario.minClusterSize,
+                            scenario.clusterCulling ? "on" : "off", toString(scenario.renderingMode),
+                            scenario.summary.p50Ms, scenario.summary.p99Ms,
+                            scenario.summary.gpuP50Ms, static_cast<double>(scenario.geometryBytes) / (1024.0 * 1024.0));
+
+                        if (const auto& statistics = scenario.debugStatistics; statistics.has_value())
+                        {
+                            fmt::println("{:>16} overdraw avg {:.2f} max {}, {} task / {} mesh workgroups, lane utilization {:.1f}%",
+                                "", statistics->getAverageOverdraw(), statistics->maxOverdraw, statistics->taskGroupCount,
+                                statistics->meshGroupCount, statistics->getLaneUtilization() * 100.0f);
+                        }
+
+                        mScenarios.push_back(std::move(scenario));
+                    }
+                }
+            }
+
+            if (app->getWindow()->willClose())
+            {
+                fmt::println("[Notice] Window closed, remaining scenarios are skipped.");
+                break;
+            }
+        }
+
+        writeCsv(mInfo.outputPath + ".csv");
+        writeJson(mInfo.outputPath + ".json");
+    }
+
+    void Benchmark::writeCsv(const std::string& filePath) const
+    {
+        std::ofstream file(filePath);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("Failed to open {} for writing", filePath));
+        }
+
+        file << "model,render_path,frames_in_flight,min_cluster_px,culling,rendering_mode,"
+                "frame,frame_ms,wait_ms,acquire_ms,record_ms,submit_ms,present_ms,gpu_ms,latency_ms,present_wait,bound\n";
+        for (const auto& scenario : mScenarios)
+        {
+            for (const auto& [i, record] : std::views::enumerate(scenario.frames))
+            {
+                file << fmt::format("{},{},{},{},{},{},{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{},{}\n",
+                    scenario.hairModel, toString(scenario.renderPath), scenario.framesInFlight, scenario.minClusterSize,
+                    scenario.clusterCulling ? 1 : 0, toString(scenario.renderingMode), i, record.frameMs, record.waitMs, record.acquireMs, record.recordMs,
+                    record.submitMs, record.presentMs, record.gpuMs, record.latencyMs, record.presentWait ? 1 : 0,
+                    toString(record.bound));
+            }
+        }
+        fmt::println("Benchmark frames written to {}", filePath);
+    }
+
+    void Benchmark::writeJson(const std::string& filePath) const
+    {
+        std::ofstream file(filePath);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("Failed to open {} for writing", filePath));
+        }
+
+        std::string result = fmt::format(
+            "{{\n  \"warmupFrameCount\": {},\n  \"frameCount\": {},\n  \"frameTime\": {},\n  \"scenarios\": [\n",
+            mInfo.warmupFrameCount, mInfo.frameCount, mInfo.frameTime);
+
+        for (size_t i = 0; i < mScenarios.size(); i++)
+        {
+            const auto& scenario = mScenarios[i];
+            const auto& summary  = scenario.summary;
+
+            std::string debugStatistics = "null";
+            if (const auto& statistics = scenario.debugStatistics; statistics.has_value())
+            {
+                debugStatistics = fmt::format(
+                    "{{ \"averageOverdraw\": {:.4f}, \"maxOverdraw\": {}, \"coveredPixels\": {}, \"taskGroups\": {}, "
+                    "\"meshGroups\": {}, \"maxMeshGroups\": {}, \"laneUtilization\": {:.4f} }}",
+                    statistics->getAverageOverdraw(), statistics->maxOverdraw, statistics->coveredPixelCount,
+                    statistics->taskGroupCount, statistics->meshGroupCount, statistics->maxMeshGroups, statistics->getLaneUtilization());
+            }
+
+            std::string pipelineStatistics;
+            for (const auto& [scope, counters] : scenario.pipelineStatistics)
+            {
+                pipelineStatistics += fmt::format(
+                    "{}{{ \"scope\": \"{}\", \"vertexInvocations\": {}, \"clippingPrimitives\": {}, \"fragmentInvocations\": {}, "
+                    "\"computeInvocations\": {}, \"taskInvocations\": {}, \"meshInvocations\": {}, \"meshPrimitives\": {} }}",
+                    pipelineStatistics.empty() ? "" : ", ", scope, counters.vertexShaderInvocations, counters.clippingPrimitives,
+                    counters.fragmentShaderInvocations, counters.computeShaderInvocations, counters.taskShaderInvocations,
+                    counters.meshShaderInvocations, counters.meshPrimitivesGenerated);
+            }
+
+            result += fmt::format(
+                "    {{ \"model\": \"{}\", \"renderPath\": \"{}\", \"framesInFlight\": {}, \"minClusterSize\": {}, \"clusterCulling\": {}, "
+                "\"renderingMode\": \"{}\", \"frames\": {}, \"p50Ms\": {:.4f}, \"p95Ms\": {:.4f}, \"p99Ms\": {:.4f}, \"maxMs\": {:.4f}, "
+                "\"gpuP50Ms\": {:.4f}, \"latencyP50Ms\": {:.4f}, \"cpuBound\": {}, \"gpuBound\": {}, \"presentBound\": {}, "
+                "\"geometryBytes\": {}, \"debugStatistics\": {}, \"pipelineStatistics\": [{}] }}{}\n",
+                scenario.hairModel, toString(scenario.renderPath), scenario.framesInFlight, scenario.minClusterSize,
+                scenario.clusterCulling, toString(scenario.renderingMode), summary.frameCount, summary.p50Ms, summary.p95Ms,
+                summary.p99Ms, summary.maxMs, summary.gpuP50Ms, summary.latencyP50Ms, summary.cpuBound, summary.gpuBound,
+                summary.presentBound, scenario.geometryBytes, debugStatistics, pipelineStatistics, i + 1 < mScenarios.size() ? "," : "");
+        }
+        result += "  ]\n}\n";
+
+        file << result;
+        fmt::println("Benchmark summary written to {}", filePath);
+    }
+}
@@ -0,0 +1,146 @@
+#include "camera/CameraPath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <fmt/format.h>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace nbl
+{
+    CameraPath::CameraPath(const CameraPathCreateInfo& createInfo)
+    : mKeyframes(createInfo.keyframes)
+    , mSize(createInfo.size)
+    , mFov(createInfo.fov)
+    , mNear(createInfo.near)
+    , mFar(createInfo.far)
+    , mLoop(createInfo.loop)
+    {
+        if (mKeyframes.empty())
+        {
+            throw std::invalid_argument("CameraPath requires at least one keyframe");
+        }
+
+        std::ranges::stable_sort(mKeyframes, {}, &CameraKeyframe::time);
+        setTime(0.0f);
+    }
+
+    std::vector<CameraKeyframe> CameraPath::loadKeyframes(const std::string& filePath)
+    {
+        std::ifstream file(filePath);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("Failed to open camera path {}", filePath));
+        }
+
+        std::vector<CameraKeyframe> keyframes;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line.starts_with('#'))
+            {
+                continue;
+            }
+
+            std::istringstream stream(line);
+            CameraKeyframe keyframe;
+            stream >> keyframe.time
+                   >> keyframe.eye.x    >> keyframe.eye.y    >> keyframe.eye.z
+                   >> keyframe.target.x >> keyframe.target.y >> keyframe.target.z;
+
+            if (stream.fail())
+            {
+                throw std::runtime_error(fmt::format("Invalid camera keyframe in {}: \"{}\"", filePath, line));
+            }
+            keyframes.push_back(keyframe);
+        }
+
+        return keyframes;
+    }
+
+    std::vector<CameraKeyframe> CameraPath::createOrbit(
+        const glm::vec3& center,
+        const float      radius,
+        const float      height,
+        const float      duration,
+        const uint32_t   keyframeCount)
+    {
+        // The last keyframe closes the loop at the starting position.
+        std::vector<CameraKeyframe> keyframes;
+        for (uint32_t i = 0; i <= keyframeCount; i++)
+        {
+            const float t     = static_cast<float>(i) / static_cast<float>(keyframeCount);
+            const float angle = t * glm::two_pi<float>();
+            keyframes.push_back({
+                .time   = t * duration,
+                .eye    = center + glm::vec3(radius * std::sin(angle), height, radius * std::cos(angle)),
+                .target = center,
+            });
+        }
+        return keyframes;
+    }
+
+    void CameraPath::setTime(float time)
+    {
+        const float duration = getDuration();
+        if (mLoop && duration > 0.0f)
+        {
+            time = std::fmod(time, duration);
+        }
+        time = std::clamp(time, mKeyframes.front().time, mKeyframes.back().time);
+
+        // Segment [k1, k2] containing time, k0 and k3 are its clamped neighbours.
+        const auto next = std::ranges::upper_bound(mKeyframes, time, {}, &CameraKeyframe::time);
+        const auto last = static_cast<int64_t>(mKeyframes.size()) - 1;
+        const int64_t i2 = std::clamp<int64_t>(std::distance(mKeyframes.begin(), next), 0, last);
+        const int64_t i1 = std::max<int64_t>(i2 - 1, 0);
+        const int64_t i0 = std::max<int64_t>(i1 - 1, 0);
+        const int64_t i3 = std::min<int64_t>(i2 + 1, last);
+
+        const CameraKeyframe& k1 = mKeyframes[i1];
+        const CameraKeyframe& k2 = mKeyframes[i2];
+        const float span = k2.time - k1.time;
+        const float t    = span > 0.0f ? (time - k1.time) / span : 0.0f;
+
+        const auto catmullRom = [t](const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3) {
+            const float t2 = t * t;
+            const float t3 = t2 * t;
+            return 0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 + (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+        };
+
+        mEye    = catmullRom(mKeyframes[i0].eye,    k1.eye,    k2.eye,    mKeyframes[i3].eye);
+        mTarget = catmullRom(mKeyframes[i0].target, k1.target, k2.target, mKeyframes[i3].target);
+    }
+
+    glm::mat4 CameraPath::view() const
+    {
+        return glm::lookAt(mEye, mTarget, mUp);
+    }
+
+    glm::mat4 CameraPath::projection() const
+    {
+        return glm::perspective(
+            glm::radians(mFov),
+            static_cast<float>(mSize.x) / static_cast<float>(mSize.y),
+            mNear, mFar);
+    }
+
+    CameraData CameraPath::getCameraData() const
+    {
+        const glm::mat4 v = view();
+        const glm::mat4 p = projection();
+
+        return {
+            .view        = v,
+            .proj        = p,
+            .viewInverse = glm::inverse(v),
+            .projInverse = glm::inverse(p),
+            .eye         = { mEye.x, mEye.y, mEye.z, 1.0f },
+            .nearPlane   = mNear,
+            .farPlane    = mFar,
+        };
+    }
+}
@@ -0,0 +1,339 @@
+#include "hair/GroomGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <fmt/format.h>
+#include <glm/gtc/constants.hpp>
+
+namespace nbl
+{
+    std::string toString(const GroomRootShape rootShape)
+    {
+        switch (rootShape)
+        {
+            case GroomRootShape::Sphere: return "Sphere";
+            case GroomRootShape::Mesh:   return "Mesh";
+        }
+
+        throw std::invalid_argument("Unknown GroomRootShape");
+    }
+
+    namespace
+    {
+        /**
+         * Counter based random numbers: every strand draws from its own stream, independent of the thread generating it.
+         */
+        struct StrandRandom
+        {
+            uint64_t state;
+
+            StrandRandom(const uint32_t seed, const uint64_t stream)
+            : state(static_cast<uint64_t>(seed) << 32 ^ stream * 0x9E3779B97F4A7C15ull) {}
+
+            // SplitMix64
+            uint64_t next()
+            {
+                uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            }
+
+            float uniform() { return static_cast<float>(next() >> 40) / static_cast<float>(1ull << 24); }
+
+            // Box-Muller
+            float normal()
+            {
+                const float u1 = std::max(uniform(), 1e-7f);
+                const float u2 = uniform();
+                return std::sqrt(-2.0f * std::log(u1)) * std::cos(glm::two_pi<float>() * u2);
+            }
+        };
+
+        struct Root
+        {
+            glm::vec3 position;
+            glm::vec3 normal;
+        };
+
+        /**
+         * Points of one strand grown from root, shared by regular strands and clump guides.
+         */
+        void growStrand(
+            const GroomGenerateInfo& info,
+            const Root&              root,
+            const float              length,
+            const float              curlPhase,
+            std::span<glm::vec3>     points)
+        {
+            // Orthonormal basis around the growth direction for the curl helix.
+            const glm::vec3 helper    = std::abs(root.normal.y) < 0.99f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+            const glm::vec3 tangent   = glm::normalize(glm::cross(helper, root.normal));
+            const glm::vec3 bitangent = glm::cross(root.normal, tangent);
+
+            const auto pointCount = static_cast<float>(points.size() - 1);
+            for (size_t j = 0; j < points.size(); j++)
+            {
+                const float t = static_cast<float>(j) / pointCount;
+                const float s = t * length;
+
+                glm::vec3 point = root.position + root.normal * s;
+                point.y        -= info.gravity * length * t * t;
+
+                if (info.curlRadius > 0.0f)
+                {
+                    // Fade in over the first quarter so the strand leaves the root along its normal.
+                    const float angle  = glm::two_pi<float>() * info.curlTurns * t + curlPhase;
+                    const float radius = info.curlRadius * std::min(1.0f, 4.0f * t);
+                    point += radius * (std::cos(angle) * tangent + std::sin(angle) * bitangent);
+                }
+
+                points[j] = point;
+            }
+        }
+
+        /**
+         * Run fn(begin, end) over [0, count) split across hardware threads.
+         */
+        template <class F>
+        void parallelFor(const uint32_t count, F&& fn)
+        {
+            const uint32_t threadCount = std::max(1u, std::min(std::thread::hardware_concurrency(), count / 1024 + 1));
+            const uint32_t chunkSize   = (count + threadCount - 1) / threadCount;
+
+            std::vector<std::future<void>> workers;
+            for (uint32_t begin = 0; begin < count; begin += chunkSize)
+            {
+                workers.push_back(std::async(std::launch::async, fn, begin, std::min(count, begin + chunkSize)));
+            }
+            for (auto& worker : workers)
+            {
+                worker.get();
+            }
+        }
+    }
+
+    ScalpMesh loadScalpMesh(const std::string& filePath)
+    {
+        std::ifstream file(filePath);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("Failed to open scalp mesh {}", filePath));
+        }
+
+        ScalpMesh   mesh;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream stream(line);
+            std::string        type;
+            stream >> type;
+
+            if (type == "v")
+            {
+                glm::vec3 position;
+                stream >> position.x >> position.y >> position.z;
+                mesh.positions.push_back(position);
+            }
+            else if (type == "f")
+            {
+                // "f v", "f v/vt" and "f v/vt/vn", negative indices are relative to the end.
+                std::vector<uint32_t> face;
+                std::string           vertex;
+                while (stream >> vertex)
+                {
+                    const int32_t index = std::stoi(vertex.substr(0, vertex.find('/')));
+                    face.push_back(index > 0 ? index - 1 : static_cast<uint32_t>(mesh.positions.size()) + index);
+                }
+                for (size_t i = 1; i + 1 < face.size(); i++)
+                {
+                    mesh.indices.insert(mesh.indices.end(), { face[0], face[i], face[i + 1] });
+                }
+            }
+        }
+
+        if (mesh.indices.empty())
+        {
+            throw std::runtime_error(fmt::format("Scalp mesh {} has no faces", filePath));
+        }
+
+        return mesh;
+    }
+
+    void generateGroom(const GroomGenerateInfo& generateInfo, cyHairFile& hairFile)
+    {
+        const GroomGenerateInfo& info = generateInfo;
+        const uint32_t strandCount = info.strandCount;
+        const uint32_t pointCount  = std::max(2u, info.pointsPerStrand);
+
+        #pragma region "Roots"
+
+        ScalpMesh          mesh;
+        std::vector<float> triangleCdf;     // Cumulative triangle areas, roots are distributed by area
+        if (info.rootShape == GroomRootShape::Mesh)
+        {
+            mesh = loadScalpMesh(info.scalpMeshPath);
+
+            float area = 0.0f;
+            for (size_t i = 0; i < mesh.indices.size(); i += 3)
+            {
+                const glm::vec3& a = mesh.positions[mesh.indices[i]];
+                const glm::vec3& b = mesh.positions[mesh.indices[i + 1]];
+                const glm::vec3& c = mesh.positions[mesh.indices[i + 2]];
+                area += 0.5f * glm::length(glm::cross(b - a, c - a));
+                triangleCdf.push_back(area);
+            }
+        }
+
+        std::vector<Root> roots(strandCount);
+        parallelFor(strandCount, [&](const uint32_t begin, const uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                StrandRandom random(info.seed, 2ull * i);
+
+                if (info.rootShape == GroomRootShape::Sphere)
+                {
+                    const float z   = 2.0f * random.uniform() - 1.0f;
+                    const float phi = glm::two_pi<float>() * random.uniform();
+                    const float r   = std::sqrt(std::max(0.0f, 1.0f - z * z));
+                    const glm::vec3 direction = { r * std::cos(phi), r * std::sin(phi), z };
+                    roots[i] = { .position = direction * info.sphereRadius, .normal = direction };
+                    continue;
+                }
+
+                const float   target   = random.uniform() * triangleCdf.back();
+                const auto    triangle = std::ranges::lower_bound(triangleCdf, target) - triangleCdf.begin();
+                const size_t  first    = 3 * std::min<size_t>(triangle, triangleCdf.size() - 1);
+                const glm::vec3& a = mesh.positions[mesh.indices[first]];
+                const glm::vec3& b = mesh.positions[mesh.indices[first + 1]];
+                const glm::vec3& c = mesh.positions[mesh.indices[first + 2]];
+
+                // Uniform barycentric coordinates
+                float u = random.uniform();
+                float v = random.uniform();
+                if (u + v > 1.0f)
+                {
+                    u = 1.0f - u;
+                    v = 1.0f - v;
+                }
+
+                const glm::vec3 normal = glm::cross(b - a, c - a);
+                roots[i] = {
+                    .position = a + u * (b - a) + v * (c - a),
+                    .normal   = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0, 1, 0),
+                };
+            }
+        });
+
+        #pragma endregion
+
+        #pragma region "Clumps"
+
+        // Clumps are cells of a uniform grid over the roots, the guide grows from the mean root of its cell.
+        struct Clump
+        {
+            glm::vec3 position {0.0f};
+            glm::vec3 normal   {0.0f};
+            uint32_t  count    = 0;
+        };
+
+        std::vector<Clump>    clumps;
+        std::vector<uint32_t> strandClumps;
+        glm::vec3             boundsMin {  std::numeric_limits<float>::max() };
+        glm::vec3             boundsMax { -std::numeric_limits<float>::max() };
+        uint32_t              gridSize = 0;
+
+        if (info.clumpCount > 0 && info.clumpStrength > 0.0f)
+        {
+            for (const Root& root : roots)
+            {
+                boundsMin = glm::min(boundsMin, root.position);
+                boundsMax = glm::max(boundsMax, root.position);
+            }
+
+            gridSize = std::max(1u, static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<float>(info.clumpCount)))));
+            clumps.resize(gridSize * gridSize * gridSize);
+            strandClumps.resize(strandCount);
+
+            const glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(1e-6f));
+            for (uint32_t i = 0; i < strandCount; i++)
+            {
+                const glm::uvec3 cell = glm::min(
+                    glm::uvec3((roots[i].position - boundsMin) / extent * static_cast<float>(gridSize)),
+                    glm::uvec3(gridSize - 1));
+                const uint32_t clump = (cell.z * gridSize + cell.y) * gridSize + cell.x;
+
+                strandClumps[i] = clump;
+                clumps[clump].position += roots[i].position;
+                clumps[clump].normal   += roots[i].normal;
+                clumps[clump].count++;
+            }
+
+            for (Clump& clump : clumps)
+            {
+                if (clump.count == 0) continue;
+                clump.position /= static_cast<float>(clump.count);
+                clump.normal    = glm::length(clump.normal) > 0.0f ? glm::normalize(clump.normal) : glm::vec3(0, 1, 0);
+            }
+        }
+
+        #pragma endregion
+
+        #pragma region "Strands"
+
+        hairFile.Initialize();
+        hairFile.SetHairCount(static_cast<int>(strandCount));
+        hairFile.SetPointCount(static_cast<int>(strandCount * pointCount));
+        hairFile.SetArrays(_CY_HAIR_FILE_POINTS_BIT);
+        hairFile.SetDefaultSegmentCount(static_cast<int>(pointCount - 1));
+        hairFile.SetDefaultThickness(0.1f);
+
+        auto* points = reinterpret_cast<glm::vec3*>(hairFile.GetPointsArray());
+        const float minLength = 0.1f * info.lengthMean;
+
+        parallelFor(strandCount, [&](const uint32_t begin, const uint32_t end) {
+            std::vector<glm::vec3> guide(pointCount);
+            for (uint32_t i = begin; i < end; i++)
+            {
+                StrandRandom random(info.seed, 2ull * i + 1);
+
+                const float length = std::max(minLength, info.lengthMean + info.lengthStdDev * random.normal());
+                const float phase  = glm::two_pi<float>() * random.uniform();
+
+                const std::span strand(points + static_cast<size_t>(i) * pointCount, pointCount);
+                growStrand(info, roots[i], length, phase, strand);
+
+                if (clumps.empty())
+                {
+                    continue;
+                }
+
+                // The guide shares its clump's random stream, every strand of the clump sees the same guide.
+                const uint32_t clumpIndex = strandClumps[i];
+                const Clump&   clump      = clumps[clumpIndex];
+                StrandRandom   clumpRandom(info.seed, (1ull << 63) | clumpIndex);
+
+                const float guideLength = std::max(minLength, info.lengthMean + info.lengthStdDev * clumpRandom.normal());
+                const float guidePhase  = glm::two_pi<float>() * clumpRandom.uniform();
+                growStrand(info, { .position = clump.position, .normal = clump.normal }, guideLength, guidePhase, guide);
+
+                // Pull towards the guide increases from root to tip, roots stay in place.
+                for (uint32_t j = 0; j < pointCount; j++)
+                {
+                    const float t      = static_cast<float>(j) / static_cast<float>(pointCount - 1);
+                    const glm::vec3 offset = guide[j] - guide[0] + roots[i].position;
+                    strand[j] = glm::mix(strand[j], offset, info.clumpStrength * t);
+                }
+            }
+        });
+
+        #pragma endregion
+    }
+}
@@ -0,0 +1,178 @@
+#include "hair/HairClusterHierarchy.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <glm/gtc/constants.hpp>
+
+namespace nbl
+{
+    // Ribbons are offset along the model space X axis, bounds are inflated accordingly.
+    static constexpr float gRibbonWidth = 0.15f;
+
+    void HairClusterHierarchy::build(const std::span<const StrandDescription> strandDescriptions, const std::span<const HairVertex> vertices)
+    {
+        mNodes.clear();
+        mLevelOffsets.clear();
+        mClusterCount = static_cast<int32_t>((strandDescriptions.size() + gHAIR_CLUSTER_SIZE - 1) / gHAIR_CLUSTER_SIZE);
+
+        if (mClusterCount == 0)
+        {
+            return;
+        }
+
+        // Build bottom-up, level 0 holds the clusters.
+        std::vector<std::vector<HairClusterNode>> levels(1);
+        for (int32_t i = 0; i < mClusterCount; i++)
+        {
+            levels[0].push_back(makeCluster(i, strandDescriptions, vertices));
+        }
+
+        while (levels.back().size() > 1)
+        {
+            const auto& children = levels.back();
+            std::vector<HairClusterNode> parents;
+            for (size_t i = 0; i < children.size(); i += gHAIR_CLUSTER_BVH_FANOUT)
+            {
+                const size_t count = std::min<size_t>(gHAIR_CLUSTER_BVH_FANOUT, children.size() - i);
+                HairClusterNode parent = mergeNodes(std::span(children).subspan(i, count));
+                parent.firstChild = static_cast<int32_t>(i);    // Relative to the child level, fixed up below
+                parent.childCount = static_cast<int32_t>(count);
+                parents.push_back(parent);
+            }
+            levels.push_back(std::move(parents));
+        }
+
+        if (levels.size() > gHAIR_CLUSTER_MAX_LEVELS)
+        {
+            throw std::runtime_error("HairClusterHierarchy exceeds the maximum level count");
+        }
+
+        // Lay out top-down: root first, clusters last.
+        std::ranges::reverse(levels);
+
+        int32_t offset = 0;
+        for (const auto& level : levels)
+        {
+            mLevelOffsets.push_back(offset);
+            offset += static_cast<int32_t>(level.size());
+        }
+        mLevelOffsets.push_back(offset);
+
+        mNodes.reserve(offset);
+        for (auto&& [level, nodes] : std::views::enumerate(levels))
+        {
+            for (auto node : nodes)
+            {
+                node.level = static_cast<int32_t>(level);
+                if (node.childCount > 0)
+                {
+                    node.firstChild += mLevelOffsets[level + 1];
+                }
+                mNodes.push_back(node);
+            }
+        }
+    }
+
+    HairClusterNode HairClusterHierarchy::makeCluster(
+        const int32_t                            clusterId,
+        const std::span<const StrandDescription> strandDescriptions,
+        const std::span<const HairVertex>        vertices)
+    {
+        const size_t first = static_cast<size_t>(clusterId) * gHAIR_CLUSTER_SIZE;
+        const auto   strands = strandDescriptions.subspan(first, std::min<size_t>(gHAIR_CLUSTER_SIZE, strandDescriptions.size() - first));
+
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(std::numeric_limits<float>::lowest());
+        glm::vec3 tangentSum(0.0f);
+        float     segmentLength = 0.0f;
+        int32_t   segmentCount  = 0;
+
+        for (const auto& strand : strands)
+        {
+            const auto points = vertices.subspan(strand.vertexOffset, strand.pointCount);
+            for (size_t i = 0; i < points.size(); i++)
+            {
+                const glm::vec3 p = points[i].position;
+                min = glm::min(min, p);
+                max = glm::max(max, p);
+
+                if (i + 1 < points.size())
+                {
+                    const glm::vec3 segment = glm::vec3(points[i + 1].position) - p;
+                    const float     length  = glm::length(segment);
+                    if (length > 0.0f)
+                    {
+                        tangentSum    += segment / length;
+                        segmentLength += length;
+                        segmentCount  += 1;
+                    }
+                }
+            }
+        }
+
+        const glm::vec3 center = 0.5f * (min + max);
+        const float     radius = glm::length(max - center) + gRibbonWidth;
+        const glm::vec3 axis   = (glm::length(tangentSum) > 0.0f) ? glm::normalize(tangentSum) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+        // Second pass for the tangent cone spread around the average tangent.
+        float minCos = 1.0f;
+        for (const auto& strand : strands)
+        {
+            const auto points = vertices.subspan(strand.vertexOffset, strand.pointCount);
+            for (size_t i = 0; i + 1 < points.size(); i++)
+            {
+                const glm::vec3 segment = glm::vec3(points[i + 1].position) - glm::vec3(points[i].position);
+                if (const float length = glm::length(segment); length > 0.0f)
+                {
+                    minCos = std::min(minCos, glm::dot(axis, segment / length));
+                }
+            }
+        }
+
+        return {
+            .sphere     = glm::vec4(center, radius),
+            .cone       = glm::vec4(axis, minCos),
+            .lodMetric  = (segmentCount > 0) ? segmentLength / static_cast<float>(segmentCount) : 0.0f,
+            .firstChild = clusterId,
+            .childCount = 0,
+        };
+    }
+
+    HairClusterNode HairClusterHierarchy::mergeNodes(const std::span<const HairClusterNode> children)
+    {
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(std::numeric_limits<float>::lowest());
+        glm::vec3 axisSum(0.0f);
+        float     lodMetric = 0.0f;
+
+        for (const auto& child : children)
+        {
+            min        = glm::min(min, glm::vec3(child.sphere) - child.sphere.w);
+            max        = glm::max(max, glm::vec3(child.sphere) + child.sphere.w);
+            axisSum   += glm::vec3(child.cone);
+            lodMetric  = std::max(lodMetric, child.lodMetric);
+        }
+
+        const glm::vec3 center = 0.5f * (min + max);
+        const glm::vec3 axis   = (glm::length(axisSum) > 0.0f) ? glm::normalize(axisSum) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+        float radius = 0.0f;
+        float spread = 0.0f;
+        for (const auto& child : children)
+        {
+            radius = std::max(radius, glm::length(glm::vec3(child.sphere) - center) + child.sphere.w);
+
+            const float axisAngle  = std::acos(std::clamp(glm::dot(axis, glm::vec3(child.cone)), -1.0f, 1.0f));
+            const float childAngle = std::acos(std::clamp(child.cone.w, -1.0f, 1.0f));
+            spread = std::max(spread, axisAngle + childAngle);
+        }
+
+        return {
+            .sphere    = glm::vec4(center, radius),
+            .cone      = glm::vec4(axis, std::cos(std::min(spread, glm::pi<float>()))),
+            .lodMetric = lodMetric,
+        };
+    }
+}
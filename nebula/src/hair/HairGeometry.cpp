@@ -0,0 +1,164 @@
+#include "hair/HairGeometry.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <span>
+#include <fmt/format.h>
+
+namespace nbl
+{
+    HairGeometry::HairGeometry(const HairGeometryCreateInfo& createInfo)
+    : mFilePath(createInfo.filePath)
+    , mName(createInfo.name.empty() ? createInfo.filePath : createInfo.name)
+    , mStrandOrder(createInfo.strandOrder)
+    {
+    }
+
+    void HairGeometry::process()
+    {
+        loadFile();
+        processVertices();
+        reorderStrands();
+        processStrands();
+
+        const auto buildStart = std::chrono::high_resolution_clock::now();
+        buildClusterHierarchy();
+        const std::chrono::duration<double, std::milli> buildTime = std::chrono::high_resolution_clock::now() - buildStart;
+
+        fmt::println("HairGeometry {}: Cluster hierarchy with {} clusters, {} levels, {} nodes built in {:.2f} ms",
+            mName, mClusterHierarchy.getClusterCount(), mClusterHierarchy.getLevelCount(),
+            mClusterHierarchy.getNodes().size(), buildTime.count());
+    }
+
+    void HairGeometry::loadFile()
+    {
+        if (mFilePath.empty()) return;
+        mHairFile.LoadFromFile(mFilePath.c_str());
+    }
+
+    void HairGeometry::processVertices()
+    {
+        const float* hairPoints = mHairFile.GetPointsArray();
+        for (int32_t i = 0; i < mHairFile.GetHeader().point_count * 3; i += 3) {
+            mVertices.emplace_back(glm::vec4(hairPoints[i], hairPoints[i + 1], hairPoints[i + 2], 1.0f));
+        }
+    }
+
+    void HairGeometry::reorderStrands()
+    {
+        const int32_t   strandCount = mHairFile.GetHeader().hair_count;
+        const uint16_t* segments    = mHairFile.GetSegmentsArray();
+
+        std::vector<int32_t>   pointCounts(strandCount);
+        std::vector<int32_t>   vertexOffsets(strandCount);
+        std::vector<glm::vec3> rootPositions(strandCount);
+
+        int32_t vertexOffset = 0;
+        for (int32_t i = 0; i < strandCount; i++)
+        {
+            pointCounts[i]   = (segments != nullptr) ? segments[i] + 1 : mHairFile.GetHeader().d_segments + 1;
+            vertexOffsets[i] = vertexOffset;
+            rootPositions[i] = glm::vec3(mVertices[vertexOffset].position);
+            vertexOffset    += pointCounts[i];
+        }
+
+        mStrandPermutation = computeStrandOrder({
+            .policy        = mStrandOrder,
+            .rootPositions = rootPositions,
+            .pointCounts   = pointCounts,
+        });
+
+        if (mStrandOrder == StrandOrder::Source)
+        {
+            return;
+        }
+
+        // Permute vertices and per-strand segment counts consistently, descriptions are built from these.
+        const std::span vertexSpan { mVertices };
+
+        std::vector<HairVertex> vertices;
+        vertices.reserve(mVertices.size());
+        for (const int32_t sourceId : mStrandPermutation)
+        {
+            vertices.append_range(vertexSpan.subspan(vertexOffsets[sourceId], pointCounts[sourceId]));
+            if (segments != nullptr)
+            {
+                mStrandVertexCounts.push_back(segments[sourceId]);
+            }
+        }
+        mVertices = std::move(vertices);
+    }
+
+    void HairGeometry::processStrands()
+    {
+        // Already filled in strand order when reordered.
+        if (mStrandVertexCounts.empty() && mHairFile.GetSegmentsArray() != nullptr)
+        {
+            const uint16_t* segments_array = mHairFile.GetSegmentsArray();
+            for (int32_t i = 0; i < mHairFile.GetHeader().hair_count; i++) {
+                mStrandVertexCounts.push_back(segments_array[i]);
+            }
+        }
+
+        const std::span vertexSpan { mVertices };
+
+        int32_t vertexOffset = 0;
+        for (int32_t i = 0; i < mHairFile.GetHeader().hair_count; i++)
+        {
+            const auto strandVertexCount = static_cast<int32_t>((mStrandVertexCounts.empty())
+                ? mHairFile.GetHeader().d_segments + 1
+                : mStrandVertexCounts[i] + 1);
+
+            // 1. Strand
+            Strand strand {
+                .id = i,
+                .pointCount = strandVertexCount,
+                .vertices = vertexSpan.subspan(vertexOffset, strandVertexCount),
+            };
+            mStrands.push_back(strand);
+
+            // 2. Process Strandlets
+            constexpr int32_t strandletSize = gHAIR_MAX_STRANDLET_SIZE;
+            const int32_t strandletCount = std::ceil(static_cast<double>(strandVertexCount) / static_cast<double>(strandletSize));
+            std::vector<Strandlet> strandlets;
+            for (int32_t j = 0; j < strandletCount; j++)
+            {
+                const int32_t pointCount = (j != strandletCount - 1) ? 32 : (strandVertexCount - (j * strandletSize));
+                Strandlet strandlet {
+                    .strandId = i,
+                    .pointCount = pointCount,
+                    .vertices = strand.vertices.subspan((j * strandletSize), pointCount),
+                };
+                strandlets.push_back(strandlet);
+                mStrandlets.push_back(strandlet);
+            }
+
+            // 3. Strand Description
+            StrandDescription strand_description {
+                .strandId       = i,
+                .pointCount     = strand.pointCount,
+                .strandletCount = strandletCount,
+                .vertexOffset   = vertexOffset,
+            };
+            mStrandDescriptions.push_back(strand_description);
+
+            vertexOffset += strandVertexCount;
+        }
+    }
+
+    void HairGeometry::buildClusterHierarchy()
+    {
+        mClusterHierarchy.build(mStrandDescriptions, mVertices);
+    }
+
+    uint64_t HairGeometry::getMemoryUsage() const
+    {
+        return sizeof(HairVertex)         * mVertices.capacity()
+             + sizeof(int32_t)            * mStrandVertexCounts.capacity()
+             + sizeof(Strand)             * mStrands.capacity()
+             + sizeof(Strandlet)          * mStrandlets.capacity()
+             + sizeof(StrandDescription)  * mStrandDescriptions.capacity()
+             + sizeof(int32_t)            * mStrandPermutation.capacity()
+             + sizeof(HairClusterNode)    * mClusterHierarchy.getNodes().capacity();
+    }
+}
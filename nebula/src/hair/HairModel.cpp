@@ -1,6 +1,10 @@
 #include "hair/HairModel.hpp"
 
-
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <ranges>
 #include <fmt/format.h>
 #include <nbl/Buffer.hpp>
 #include <nbl/CommandQueue.hpp>
@@ -8,145 +12,221 @@
 
 namespace nbl
 {
+    // Vulkan rejects zero-size buffers, grooms without strands still get a valid (unused) one.
+    static uint64_t getBufferSize(const uint64_t size)
+    {
+        return std::max<uint64_t>(size, sizeof(uint32_t));
+    }
+
     HairModel::HairModel(const HairModelCreateInfo& createInfo)
-    : mName(createInfo.filePath)
+    : mGeometry(createInfo.geometry)
     , mRHI(createInfo.pRHI)
     {
-        loadFile();
-        processVertices();
-        processStrands();
-        createBuffers();
+        if (!mGeometry)
+        {
+            auto geometry = HairGeometry::createHairGeometry({
+                .filePath    = createInfo.filePath,
+                .strandOrder = createInfo.strandOrder,
+            });
+            geometry->process();
+            mGeometry = std::move(geometry);
+        }
+        mName = mGeometry->getName();
+
+        createBuffers(createInfo.pGeometryArena);
+        createClusterBuffers();
+
+        setRenderPath(mRHI->getDevice()->getCapabilities().meshShader
+            ? HairRenderPath::MeshShader
+            : HairRenderPath::ComputeExpansion);
 
-        mGroupSize = static_cast<uint32_t>(std::floor(getStrandCount() / gHAIR_WORKGROUP_SIZE));
+        // One task workgroup per started cluster, the task shader skips the lanes past the last strand.
+        mGroupSize = static_cast<uint32_t>((getStrandCount() + gHAIR_WORKGROUP_SIZE - 1) / gHAIR_WORKGROUP_SIZE);
 
         mTransform.euler = glm::vec3(-90.0f, 0.0f, -45.0f);
     }
 
-    void HairModel::loadFile()
+    void HairModel::createBuffers(BufferArena* pArena)
     {
-        mHairFile.LoadFromFile(mName.c_str());
-    }
+        const auto& vertices           = mGeometry->getVertices();
+        const auto& strandDescriptions = mGeometry->getStrandDescriptions();
 
-    void HairModel::processVertices()
-    {
-        const float* hairPoints = mHairFile.GetPointsArray();
-        for (int32_t i = 0; i < mHairFile.GetHeader().point_count * 3; i += 3) {
-            mVertices.emplace_back(glm::vec4(hairPoints[i], hairPoints[i + 1], hairPoints[i + 2], 1.0f));
+        const uint64_t vertexSize     = sizeof(Vertex_t) * vertices.size();
+        const uint64_t strandDescSize = sizeof(StrandDescription) * strandDescriptions.size();
+
+        if (!pArena)
+        {
+            // One block holding both slices, buffer offset alignments are at most 256 bytes.
+            mOwnedGeometryArena = mRHI->createBufferArena({
+                .blockSize  = getBufferSize(vertexSize) + getBufferSize(strandDescSize) + 2 * 256,
+                .type       = BufferType::Storage,
+                .debugName  = fmt::format("HairModel: {} (Geometry)", mName),
+                .hostAccess = true,
+            });
+            pArena = mOwnedGeometryArena.get();
         }
+
+        #pragma region "Vertex Buffer"
+        mVertexBuffer = pArena->allocate({
+            .size      = getBufferSize(vertexSize),
+            .debugName = fmt::format("HairModel: {} (Vertices)", mName),
+        });
+        #pragma endregion
+
+        #pragma region "StrandDescription Buffer"
+        mStrandDescriptionsBuffer = pArena->allocate({
+            .size      = getBufferSize(strandDescSize),
+            .debugName = fmt::format("HairModel: {} (Strand Descriptions)", mName),
+        });
+        #pragma endregion
+
+        uploadBuffers({
+            { .pDstBuffer = mVertexBuffer->getBuffer(),             .pData = vertices.data(),           .size = vertexSize,     .dstOffset = mVertexBuffer->getOffset()             },
+            { .pDstBuffer = mStrandDescriptionsBuffer->getBuffer(), .pData = strandDescriptions.data(), .size = strandDescSize, .dstOffset = mStrandDescriptionsBuffer->getOffset() },
+        });
+
+        mBufferAddresses = {
+            .vertexBuffer = mVertexBuffer->getAddress(),
+            .strandDescriptionsBuffer = mStrandDescriptionsBuffer->getAddress(),
+        };
     }
 
-    void HairModel::processStrands()
+    void HairModel::uploadBuffers(const std::initializer_list<BufferUploadInfo> uploadInfos) const
     {
-        if (mHairFile.GetSegmentsArray() != nullptr)
+        // Nothing to copy for grooms without strands.
+        const auto nonEmpty = uploadInfos
+            | std::views::filter([](const BufferUploadInfo& uploadInfo) { return uploadInfo.size > 0; })
+            | std::ranges::to<std::vector>();
+
+        const std::vector paths = mRHI->uploadBuffers(nonEmpty);
+        for (const auto& [uploadInfo, path] : std::views::zip(nonEmpty, paths))
         {
-            const uint16_t* segments_array = mHairFile.GetSegmentsArray();
-            for (int32_t i = 0; i < mHairFile.GetHeader().hair_count; i++) {
-                mStrandVertexCounts.push_back(segments_array[i]);
-            }
+            fmt::println("HairModel {}: Uploaded {} ({} KiB) via {} path",
+                mName, uploadInfo.pDstBuffer->getName(), uploadInfo.size / 1024, toString(path));
         }
+    }
 
-        const std::span vertexSpan { mVertices };
+    void HairModel::createRibbonBuffers()
+    {
+        const auto& vertices           = mGeometry->getVertices();
+        const auto& strandDescriptions = mGeometry->getStrandDescriptions();
+
+        #pragma region "Ribbon Vertex Buffer"
+        // Written by the expansion compute pass: [Strand Point | Offset Point] per HairVertex.
+        mRibbonVertexBuffer = mRHI->createBuffer({
+            .size      = getBufferSize(sizeof(HairRibbonVertex) * 2 * vertices.size()),
+            .type      = BufferType::Storage,
+            .debugName = fmt::format("HairModel: {} (Ribbon Vertices)", mName),
+        });
+        #pragma endregion
 
-        int32_t vertexOffset = 0;
-        for (int32_t i = 0; i < mHairFile.GetHeader().hair_count; i++)
+        #pragma region "Ribbon Index Buffer"
+        // Topology is static, two triangles per strand segment with the same winding as the mesh shader.
+        // 0 ---- 1
+        // |    / |
+        // | /    |
+        // 3 ---- 2
+        std::vector<uint32_t> indices;
+        indices.reserve(6 * (vertices.size() - strandDescriptions.size()));
+        for (const auto& description : strandDescriptions)
         {
-            const auto strandVertexCount = static_cast<int32_t>((mStrandVertexCounts.empty())
-                ? mHairFile.GetHeader().d_segments + 1
-                : mStrandVertexCounts[i] + 1);
-
-            // 1. Strand
-            Strand strand {
-                .id = i,
-                .pointCount = strandVertexCount,
-                .vertices = vertexSpan.subspan(vertexOffset, strandVertexCount),
-            };
-            mStrands.push_back(strand);
-
-            // 2. Process Strandlets
-            constexpr int32_t strandletSize = gHAIR_MAX_STRANDLET_SIZE;
-            const int32_t strandletCount = std::ceil(static_cast<double>(strandVertexCount) / static_cast<double>(strandletSize));
-            std::vector<Strandlet> strandlets;
-            for (int32_t j = 0; j < strandletCount; j++)
+            for (int32_t i = 0; i < description.pointCount - 1; i++)
             {
-                const int32_t pointCount = (j != strandletCount - 1) ? 32 : (strandVertexCount - (j * strandletSize));
-                Strandlet strandlet {
-                    .strandId = i,
-                    .pointCount = pointCount,
-                    .vertices = strand.vertices.subspan((j * strandletSize), pointCount),
-                };
-                strandlets.push_back(strandlet);
-                mStrandlets.push_back(strandlet);
+                const uint32_t v0 = 2 * (description.vertexOffset + i);
+                const uint32_t v1 = v0 + 1;
+                const uint32_t v2 = v0 + 3;
+                const uint32_t v3 = v0 + 2;
+                indices.append_range(std::array{ v2, v1, v0, v3, v2, v0 });
             }
+        }
+        mRibbonIndexCount = static_cast<uint32_t>(indices.size());
 
-            // 3. Strand Description
-            StrandDescription strand_description {
-                .strandId       = i,
-                .pointCount     = strand.pointCount,
-                .strandletCount = strandletCount,
-                .vertexOffset   = vertexOffset,
-            };
-            mStrandDescriptions.push_back(strand_description);
+        const auto indexSize = sizeof(uint32_t) * indices.size();
 
-            vertexOffset += strandVertexCount;
-        }
+        mRibbonIndexBuffer = mRHI->createBuffer({
+            .size       = getBufferSize(indexSize),
+            .type       = BufferType::Index,
+            .debugName  = fmt::format("HairModel: {} (Ribbon Indices)", mName),
+            .hostAccess = true,
+        });
+        #pragma endregion
+
+        uploadBuffers({
+            { .pDstBuffer = mRibbonIndexBuffer.get(), .pData = indices.data(), .size = indexSize },
+        });
     }
 
-    void HairModel::createBuffers()
+    void HairModel::createClusterBuffers()
     {
-        #pragma region "Vertex Buffer"
-        const auto vertexSize = sizeof(Vertex_t) * mVertices.size();
+        const auto& hierarchy = mGeometry->getClusterHierarchy();
+        const auto& nodes     = hierarchy.getNodes();
+        const auto  nodeSize  = sizeof(HairClusterNode) * nodes.size();
+
+        mClusterNodeBuffer = mRHI->createBuffer({
+            .size       = getBufferSize(nodeSize),
+            .type       = BufferType::Storage,
+            .debugName  = fmt::format("HairModel: {} (Cluster Nodes)", mName),
+            .hostAccess = true,
+        });
 
-        mVertexBuffer = mRHI->createBuffer({
-            .size      = vertexSize,
+        mClusterQueueBuffer = mRHI->createBuffer({
+            .size      = getBufferSize(sizeof(int32_t) * nodes.size()),
             .type      = BufferType::Storage,
-            .debugName = fmt::format("HairModel: {} (Vertices)", mName),
+            .debugName = fmt::format("HairModel: {} (Cluster Queues)", mName),
         });
 
-        const auto vertexBufferStaging = mRHI->createBuffer({
-            .size      = vertexSize,
-            .type      = BufferType::Staging,
+        mVisibleClusterBuffer = mRHI->createBuffer({
+            .size      = getBufferSize(sizeof(int32_t) * hierarchy.getClusterCount()),
+            .type      = BufferType::Storage,
+            .debugName = fmt::format("HairModel: {} (Visible Clusters)", mName),
         });
-        vertexBufferStaging->setData(mVertices.data(), vertexSize);
-        #pragma endregion
 
-        #pragma region "StrandDescription Buffer"
-        const auto strandDescSize = sizeof(StrandDescription) * mStrandDescriptions.size();
-
-        mStrandDescriptionsBuffer = mRHI->createBuffer({
-            .size      = strandDescSize,
-            .type      = BufferType::Storage,
-            .debugName = fmt::format("HairModel: {} (Strand Descriptions)", mName),
+        mClusterCullStateBuffer = mRHI->createBuffer({
+            .size      = sizeof(HairClusterCullState),
+            .type      = BufferType::Indirect,
+            .debugName = fmt::format("HairModel: {} (Cluster Cull State)", mName),
         });
 
-        const auto strandDescStaging = mRHI->createBuffer({
-            .size      = strandDescSize,
-            .type      = BufferType::Staging,
+        uploadBuffers({
+            { .pDstBuffer = mClusterNodeBuffer.get(), .pData = nodes.data(), .size = nodeSize },
         });
-        strandDescStaging->setData(mStrandDescriptions.data(), strandDescSize);
-        #pragma endregion
+    }
 
-        mRHI->getGraphicsQueue()->executeSingleTimeCommand([&](const vk::CommandBuffer& commandBuffer) {
-            vertexBufferStaging->copy({
-                .pDstBuffer    = mVertexBuffer.get(),
-                .size          = vertexSize,
-                .srcOffset     = 0,
-                .dstOffset     = 0,
-                .commandBuffer = commandBuffer,
-            });
+    void HairModel::setRenderPath(const HairRenderPath renderPath)
+    {
+        if (renderPath == HairRenderPath::MeshShader && !mRHI->getDevice()->getCapabilities().meshShader)
+        {
+            fmt::println("HairModel {}: MeshShader render path is not supported by the device.", mName);
+            return;
+        }
 
-            strandDescStaging->copy({
-                .pDstBuffer    = mStrandDescriptionsBuffer.get(),
-                .size          = strandDescSize,
-                .srcOffset     = 0,
-                .dstOffset     = 0,
-                .commandBuffer = commandBuffer,
-            });
-        });
+        if (isRibbonRenderPath(renderPath) && !mRibbonVertexBuffer)
+        {
+            createRibbonBuffers();
+        }
 
-        mBufferAddresses = {
-            .vertexBuffer = mVertexBuffer->getAddress(),
-            .strandDescriptionsBuffer = mStrandDescriptionsBuffer->getAddress(),
-        };
+        // Both ribbon paths write the same buffer, per-frame expansion leaves world space data behind.
+        if (renderPath != mRenderPath)
+        {
+            invalidateRibbonCache();
+        }
+
+        mRenderPath = renderPath;
+    }
+
+    uint64_t HairModel::getMemoryUsage(const HairRenderPath renderPath) const
+    {
+        uint64_t result = mVertexBuffer->getAllocSize() + mStrandDescriptionsBuffer->getAllocSize();
+        if (renderPath == HairRenderPath::MeshShader && mClusterNodeBuffer)
+        {
+            result += mClusterNodeBuffer->getAllocSize() + mClusterQueueBuffer->getAllocSize()
+                + mVisibleClusterBuffer->getAllocSize() + mClusterCullStateBuffer->getAllocSize();
+        }
+        if (isRibbonRenderPath(renderPath) && mRibbonVertexBuffer)
+        {
+            result += mRibbonVertexBuffer->getAllocSize() + mRibbonIndexBuffer->getAllocSize();
+        }
+        return result;
     }
 
     void HairModel::render(const vk::CommandBuffer& commandBuffer) const
@@ -155,4 +235,19 @@ namespace nbl
         commandBuffer.drawMeshTasksEXT(mGroupSize, 1, 1);
     }
 
+    void HairModel::renderCulled(const vk::CommandBuffer& commandBuffer) const
+    {
+        commandBuffer.drawMeshTasksIndirectEXT(
+            mClusterCullStateBuffer->getHandle(),
+            offsetof(HairClusterCullState, draw),
+            1,
+            sizeof(vk::DrawMeshTasksIndirectCommandEXT));
+    }
+
+    void HairModel::renderRibbons(const vk::CommandBuffer& commandBuffer) const
+    {
+        commandBuffer.bindIndexBuffer(mRibbonIndexBuffer->getHandle(), 0, vk::IndexType::eUint32);
+        commandBuffer.drawIndexed(mRibbonIndexCount, 1, 0, 0, 0);
+    }
+
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "hair/HairPipeline.hpp"
 
-#include "Barrier.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <fmt/format.h>
 #include "Pipeline.hpp"
 #include "RenderPass.hpp"
 #include "VulkanRHI.hpp"
@@ -8,29 +12,13 @@
 
 namespace nbl
 {
-    HairPipeline::HairPipeline(VulkanRHI* pRHI, Descriptor* pSceneDescriptor)
+    HairPipeline::HairPipeline(VulkanRHI* pRHI, RenderGraph* pRenderGraph, Descriptor* pSceneDescriptor)
     : mDescriptor(pSceneDescriptor)
+    , mRenderGraph(pRenderGraph)
     , mRHI(pRHI)
     {
-        mDepthBuffer = mRHI->createImage({
-            .extent         = mRHI->getSwapchain()->getExtent(),
-            .format         = vk::Format::eD32Sfloat,
-            .sampleCount    = vk::SampleCountFlagBits::e1,
-            .tiling         = vk::ImageTiling::eOptimal,
-            .usageFlags     = vk::ImageUsageFlagBits::eDepthStencilAttachment,
-            .debugName      = "Hair DepthBuffer",
-            .imageSampler   = false,
-        });
-
-        mRHI->getGraphicsQueue()->executeSingleTimeCommand([&](const vk::CommandBuffer& commandBuffer) -> void {
-            Barrier::transitionImageLayout({
-                .commandBuffer       = commandBuffer,
-                .imageTransitionInfo = {
-                    .pImage    = mDepthBuffer.get(),
-                    .newLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal,
-                },
-            });
-        });
+        // Only alive during the hair pass, its memory is shared with other transient images.
+        mDepthBuffer = mRenderGraph->createImage(getDepthBufferInfo(mRHI->getSwapchain()->getExtent()));
 
         Attachment swapchainAttachment = {
             .pSource        = mRHI->getSwapchain(),
@@ -41,11 +29,11 @@ namespace nbl
         };
 
         const Attachment depthAttachment = {
-            .pSource        = mDepthBuffer.get(),
+            .pSource        = mRenderGraph->getAttachmentSource(mDepthBuffer),
             .clearValue     = vk::ClearValue().setDepthStencil({ 1.0f, 0 }),
             .imageLayout    = vk::ImageLayout::eDepthStencilAttachmentOptimal,
             .loadOp         = vk::AttachmentLoadOp::eClear,
-            .storeOp        = vk::AttachmentStoreOp::eStore,
+            .storeOp        = vk::AttachmentStoreOp::eDontCare,
         };
 
         mRenderPass = RenderPass::createRenderPass({
@@ -54,65 +42,610 @@ namespace nbl
             .depthAttachment    = depthAttachment
         });
 
-        mPipeline = Pipeline::createPipeline({
-            .pushConstantRanges     = { PushConstant::getPushConstantRange() },
+        const bool descriptorBuffers = mDescriptor->getBackend() == DescriptorBackend::Buffer;
+
+        if (mRHI->getDevice()->getCapabilities().meshShader)
+        {
+            mPipelines = PipelineVariants::createPipelineVariants({ .baseCreateInfo = {
+                .pushConstantRanges     = { PushConstant::getPushConstantRange() },
+                .descriptorSetLayouts   = { mDescriptor->getLayout() },
+                .shaderCreateInfos      = {
+                    { "nblHair.task.spv", vk::ShaderStageFlagBits::eTaskEXT  },
+                    { "nblHair.mesh.spv", vk::ShaderStageFlagBits::eMeshEXT  },
+                    { "nblHair.frag.spv", vk::ShaderStageFlagBits::eFragment },
+                },
+                .pipelineType           = PipelineType::Graphics,
+                .graphicsPipelineState  = GraphicsPipelineStateInfo({
+                    .attachmentStates = { PipelineUtils::makeColorBlendAttachmentState() }
+                })
+                .setCullMode(vk::CullModeFlagBits::eNone)
+                .configure([&](GraphicsPipelineStateInfo& info){
+                    // info.depthStencilState.setDepthTestEnable(false);
+                }),
+                .pRenderPass            = mRenderPass.get(),
+                .useDescriptorBuffers   = descriptorBuffers,
+                .debugName              = "Hair",
+                .pDevice                = mRHI->getDevice(),
+            }, .pCompiler = mRHI->getPipelineCompiler() });
+
+            mClusterCullPipeline = Pipeline::createPipeline({
+                .pushConstantRanges     = { ClusterCullPushConstant::getPushConstantRange() },
+                .descriptorSetLayouts   = { mDescriptor->getLayout() },
+                .shaderCreateInfos      = {
+                    { "nblHairClusterCull.comp.spv", vk::ShaderStageFlagBits::eCompute },
+                },
+                .pipelineType           = PipelineType::Compute,
+                .useDescriptorBuffers   = descriptorBuffers,
+                .debugName              = "Hair Cluster Cull",
+                .pDevice                = mRHI->getDevice(),
+            });
+
+            #pragma region "Debug and Performance Rendering Modes"
+
+            mDebugPipelines = PipelineVariants::createPipelineVariants({ .baseCreateInfo = {
+                .pushConstantRanges     = { DebugPushConstant::getPushConstantRange() },
+                .descriptorSetLayouts   = { mDescriptor->getLayout() },
+                .shaderCreateInfos      = {
+                    { "nblHairDebug.task.spv", vk::ShaderStageFlagBits::eTaskEXT  },
+                    { "nblHairDebug.mesh.spv", vk::ShaderStageFlagBits::eMeshEXT  },
+                    { "nblHairDebug.frag.spv", vk::ShaderStageFlagBits::eFragment },
+                },
+                .pipelineType           = PipelineType::Graphics,
+                .graphicsPipelineState  = GraphicsPipelineStateInfo({
+                    .attachmentStates = { PipelineUtils::makeColorBlendAttachmentState() }
+                })
+                .setCullMode(vk::CullModeFlagBits::eNone),
+                .pRenderPass            = mRenderPass.get(),
+                .useDescriptorBuffers   = descriptorBuffers,
+                .debugName              = "Hair Debug",
+                .pDevice                = mRHI->getDevice(),
+            }, .pCompiler = mRHI->getPipelineCompiler() });
+
+            // Normal rendering is needed by the first frame and queued first, debug variants compile behind it.
+            std::vector<SpecializationConstants> specializations;
+            std::vector<SpecializationConstants> debugSpecializations;
+            for (const bool clusterCulling : { false, true })
+            {
+                specializations.push_back(getDrawSpecialization(HairRenderingMode::Normal, clusterCulling));
+                for (const HairRenderingMode renderingMode : gHairRenderingModes)
+                {
+                    if (renderingMode == HairRenderingMode::Normal) continue;
+                    debugSpecializations.push_back(getDrawSpecialization(renderingMode, clusterCulling));
+                }
+            }
+            mPipelines->prepare(specializations);
+            mDebugPipelines->prepare(debugSpecializations);
+
+            swapchainAttachment.loadOp = vk::AttachmentLoadOp::eLoad;
+            mOverlayRenderPass = RenderPass::createRenderPass({
+                .renderArea         = mRHI->getSwapchain()->getArea(),
+                .colorAttachments   = { swapchainAttachment },
+            });
+
+            using Blend = vk::BlendFactor;
+            mOverdrawPipeline = Pipeline::createPipeline({
+                .pushConstantRanges     = { OverdrawPushConstant::getPushConstantRange() },
+                .shaderCreateInfos      = {
+                    { "nblHairOverdraw.vert.spv", vk::ShaderStageFlagBits::eVertex   },
+                    { "nblHairOverdraw.frag.spv", vk::ShaderStageFlagBits::eFragment },
+                },
+                .pipelineType           = PipelineType::Graphics,
+                .graphicsPipelineState  = GraphicsPipelineStateInfo({
+                    .attachmentStates = { PipelineUtils::makeColorBlendAttachmentState(
+                        vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB,
+                        true, Blend::eSrcAlpha, Blend::eOneMinusSrcAlpha) }
+                })
+                .setCullMode(vk::CullModeFlagBits::eNone)
+                .configure([](GraphicsPipelineStateInfo& info) {
+                    info.depthStencilState.setDepthTestEnable(false).setDepthWriteEnable(false);
+                }),
+                .pRenderPass            = mOverlayRenderPass.get(),
+                .debugName              = "Hair Overdraw Resolve",
+                .pDevice                = mRHI->getDevice(),
+            });
+
+            createDebugBuffer(mRHI->getSwapchain()->getExtent());
+
+            // Host-cached copies of the statistics, read once the frame slot is reused.
+            mDebugReadbacks.resize(mRHI->getFramesInFlight());
+            for (uint32_t i = 0; i < mDebugReadbacks.size(); i++)
+            {
+                mDebugReadbacks[i].buffer = mRHI->createBuffer({
+                    .size      = sizeof(HairDebugStatistics),
+                    .type      = BufferType::Readback,
+                    .debugName = fmt::format("Hair Debug Readback {}", i),
+                });
+            }
+
+            #pragma endregion
+        }
+
+        mExpandPipelines = PipelineVariants::createPipelineVariants({ .baseCreateInfo = {
+            .pushConstantRanges     = { ExpandPushConstant::getPushConstantRange() },
+            .shaderCreateInfos      = {
+                { "nblHairExpand.comp.spv", vk::ShaderStageFlagBits::eCompute },
+            },
+            .pipelineType           = PipelineType::Compute,
+            .debugName              = "Hair Expand",
+            .pDevice                = mRHI->getDevice(),
+        }, .pCompiler = mRHI->getPipelineCompiler() });
+
+        std::vector<SpecializationConstants> expandSpecializations;
+        for (const uint32_t workgroupSize : { 32u, 64u, 128u })
+        {
+            expandSpecializations.push_back({{ static_cast<uint32_t>(HairSpecialization::ExpandWorkgroupSize), workgroupSize }});
+        }
+        mExpandPipelines->prepare(expandSpecializations);
+
+        mRibbonPipeline = Pipeline::createPipeline({
+            .pushConstantRanges     = { PushConstant::getPushConstantRange(PushConstant::sRibbonShaderStages) },
             .descriptorSetLayouts   = { mDescriptor->getLayout() },
             .shaderCreateInfos      = {
-                { "nblHair.task.spv", vk::ShaderStageFlagBits::eTaskEXT  },
-                { "nblHair.mesh.spv", vk::ShaderStageFlagBits::eMeshEXT  },
-                { "nblHair.frag.spv", vk::ShaderStageFlagBits::eFragment },
+                { "nblHairRibbon.vert.spv", vk::ShaderStageFlagBits::eVertex   },
+                { "nblHair.frag.spv",       vk::ShaderStageFlagBits::eFragment },
             },
             .pipelineType           = PipelineType::Graphics,
             .graphicsPipelineState  = GraphicsPipelineStateInfo({
                 .attachmentStates = { PipelineUtils::makeColorBlendAttachmentState() }
             })
-            .setCullMode(vk::CullModeFlagBits::eNone)
-            .configure([&](GraphicsPipelineStateInfo& info){
-                // info.depthStencilState.setDepthTestEnable(false);
-            }),
+            .setCullMode(vk::CullModeFlagBits::eNone),
             .pRenderPass            = mRenderPass.get(),
-            .debugName              = "Hair",
+            .useDescriptorBuffers   = descriptorBuffers,
+            .debugName              = "Hair Ribbon",
             .pDevice                = mRHI->getDevice(),
         });
+
+        // Same resource with a new description, the RenderGraph reallocates it on the next compile.
+        mSwapchainCallback = mRHI->addSwapchainCallback([this](const Swapchain& swapchain) {
+            mRenderGraph->createImage(getDepthBufferInfo(swapchain.getExtent()));
+            mRenderPass->setRenderArea(swapchain.getArea());
+            if (mOverlayRenderPass)
+            {
+                mOverlayRenderPass->setRenderArea(swapchain.getArea());
+                createDebugBuffer(swapchain.getExtent());
+            }
+        });
+    }
+
+    HairPipeline::~HairPipeline()
+    {
+        mRHI->removeSwapchainCallback(mSwapchainCallback);
+    }
+
+    void HairPipeline::createDebugBuffer(const vk::Extent2D& extent)
+    {
+        // The previous buffer is released through the DeletionQueue once frames in flight stop using it.
+        mDebugBuffer = mRHI->createBuffer({
+            .size      = sizeof(HairDebugStatistics) + sizeof(uint32_t) * extent.width * extent.height,
+            .type      = BufferType::Storage,
+            .debugName = "Hair Debug",
+        });
+    }
+
+    RenderGraphImageInfo HairPipeline::getDepthBufferInfo(const vk::Extent2D& extent)
+    {
+        return {
+            .debugName      = "Hair DepthBuffer",
+            .extent         = extent,
+            .format         = vk::Format::eD32Sfloat,
+        };
+    }
+
+    SpecializationConstants HairPipeline::getDrawSpecialization(const HairRenderingMode renderingMode, const bool clusterCulling)
+    {
+        return {
+            { static_cast<uint32_t>(HairSpecialization::RenderingMode),  static_cast<uint32_t>(renderingMode) },
+            { static_cast<uint32_t>(HairSpecialization::ClusterCulling), clusterCulling ? 1u : 0u },
+        };
+    }
+
+    SpecializationConstants HairPipeline::getExpandSpecialization(const HairModel* pHairModel)
+    {
+        const auto strandCount   = static_cast<uint32_t>(std::max(1, pHairModel->getStrandCount()));
+        const auto averageLength = static_cast<uint32_t>(pHairModel->getVertexCount()) / strandCount;
+        const uint32_t workgroupSize = std::clamp(std::bit_ceil(averageLength), 32u, 128u);
+
+        return {
+            { static_cast<uint32_t>(HairSpecialization::ExpandWorkgroupSize), workgroupSize },
+        };
+    }
+
+    std::string HairPipeline::getStatisticsScope(const HairModel* pHairModel, const std::string_view pass)
+    {
+        const bool culling = pHairModel->getRenderPath() == HairRenderPath::MeshShader && pHairModel->isClusterCullingEnabled();
+        return fmt::format("{} | {}{} | {}",
+            pHairModel->getName(), toString(pHairModel->getRenderPath()), culling ? " + Culling" : "", pass);
     }
 
-    void HairPipeline::renderHairModel(const HairModel* pHairModel, const CommandList* pCommandList, const Frame& frameInfo) const
+    void HairPipeline::addPasses(HairModel* pHairModel, const RenderGraphResource colorTarget, const Frame& frameInfo) const
     {
-        constexpr auto marker = vk::DebugUtilsLabelEXT()
-            .setColor(std::array{ 0.45f, 0.15f, 0.95f, 1.0f })
-            .setPLabelName("Hair Rendering");
+        const HairRenderPath renderPath = pHairModel->getRenderPath();
+        const bool           ribbonPath = isRibbonRenderPath(renderPath);
+        const bool           culling    = renderPath == HairRenderPath::MeshShader && pHairModel->isClusterCullingEnabled();
+        const glm::mat4      model      = pHairModel->mTransform.model();
+
+        // Debug and performance rendering modes color the mesh shader output, ribbon paths always shade normally.
+        const HairRenderingMode       renderingMode  = pHairModel->mRenderingMode;
+        const SpecializationConstants specialization = getDrawSpecialization(renderingMode, culling);
+
+        // Variants are resolved while declaring the frame, recording threads only bind them.
+        // Until its debug variant finished compiling the model keeps rendering normally.
+        const Pipeline* debugPipeline = !ribbonPath && mDebugPipelines && renderingMode != HairRenderingMode::Normal
+            ? mDebugPipelines->tryGet(specialization)
+            : nullptr;
+
+        const bool debugMode       = debugPipeline != nullptr;
+        const bool performanceMode = debugMode && isPerformanceRenderingMode(renderingMode);
+
+        const Pipeline* drawPipeline = mRibbonPipeline.get();
+        if (!ribbonPath)
+        {
+            drawPipeline = debugMode
+                ? debugPipeline
+                : mPipelines->get(getDrawSpecialization(HairRenderingMode::Normal, culling));
+        }
+
+        // The slot's previous frame completed in beginFrame, its statistics copy is ready to read.
+        if (!mDebugReadbacks.empty())
+        {
+            if (DebugReadback& readback = mDebugReadbacks[frameInfo.currentFrame];
+                readback.pHairModel == pHairModel)
+            {
+                HairDebugStatistics debugStatistics;
+                readback.buffer->readBack(&debugStatistics, sizeof(HairDebugStatistics));
+                pHairModel->mDebugStatistics = debugStatistics;
+                readback.pHairModel = nullptr;
+            }
+        }
+
+        PipelineStatistics* statistics = mRHI->getPipelineStatistics();
 
-        pCommandList->handle().beginDebugUtilsLabelEXT(marker);
+        RenderGraph& graph = *mRenderGraph;
+        const auto vertices     = graph.importBuffer("Hair Vertices",     pHairModel->mVertexBuffer->getBuffer());
+        const auto strandDescs  = graph.importBuffer("Hair Strand Descs", pHairModel->mStrandDescriptionsBuffer->getBuffer());
 
-        Barrier::transitionImageLayout({
-            .commandBuffer = pCommandList->handle(),
-            .imageTransitionInfo = {
-                .pImage    = mRHI->getSwapchain()->getImage(frameInfo.acquiredImageIndex),
-                .newLayout = vk::ImageLayout::eColorAttachmentOptimal,
+        std::vector<RenderGraphAccess> drawAccesses = {
+            { colorTarget,  RenderGraphUsage::ColorAttachment },
+            { mDepthBuffer, RenderGraphUsage::DepthAttachment },
+        };
+
+        if (culling)
+        {
+            const auto nodes          = graph.importBuffer("Hair Cluster Nodes",      pHairModel->mClusterNodeBuffer.get());
+            const auto queue          = graph.importBuffer("Hair Cluster Queue",      pHairModel->mClusterQueueBuffer.get());
+            const auto visibleCluster = graph.importBuffer("Hair Visible Clusters",   pHairModel->mVisibleClusterBuffer.get());
+            const auto cullState      = graph.importBuffer("Hair Cluster Cull State", pHairModel->mClusterCullStateBuffer.get());
+
+            graph.addPass({
+                .name     = "Hair Cluster Cull",
+                .accesses = {
+                    { nodes,          RenderGraphUsage::ComputeStorageRead  },
+                    { queue,          RenderGraphUsage::TransferWrite       },
+                    { queue,          RenderGraphUsage::ComputeStorageWrite },
+                    { visibleCluster, RenderGraphUsage::ComputeStorageWrite },
+                    { cullState,      RenderGraphUsage::TransferWrite       },
+                    { cullState,      RenderGraphUsage::ComputeStorageWrite },
+                    { cullState,      RenderGraphUsage::IndirectRead        },
+                },
+                .execute  = [this, pHairModel, &frameInfo, statistics,
+                             scope = statistics->allocate(frameInfo.currentFrame, getStatisticsScope(pHairModel, "Cluster Cull"))]
+                            (const vk::CommandBuffer& commandBuffer) {
+                    statistics->begin(commandBuffer, scope);
+                    cullHairModel(pHairModel, commandBuffer, frameInfo);
+                    statistics->end(commandBuffer, scope);
+                },
+                .parallel = true,
+            });
+
+            drawAccesses.push_back({ visibleCluster, RenderGraphUsage::MeshStorageRead });
+            drawAccesses.push_back({ cullState,      RenderGraphUsage::IndirectRead    });
+        }
+
+        // Static grooms are expanded once in model space, the vertex shader applies the model matrix.
+        const bool expandCached = renderPath == HairRenderPath::CachedRibbons && !pHairModel->isRibbonCacheValid();
+        if (renderPath == HairRenderPath::ComputeExpansion || expandCached)
+        {
+            const Pipeline* expandPipeline = mExpandPipelines->get(getExpandSpecialization(pHairModel));
+            const auto ribbons = graph.importBuffer("Hair Ribbon Vertices", pHairModel->getRibbonVertexBuffer());
+            graph.addPass({
+                .name     = "Hair Expand",
+                .accesses = {
+                    { vertices,    RenderGraphUsage::ComputeStorageRead  },
+                    { strandDescs, RenderGraphUsage::ComputeStorageRead  },
+                    { ribbons,     RenderGraphUsage::ComputeStorageWrite },
+                },
+                .execute  = [this, pHairModel, expandPipeline, model, expandCached, statistics,
+                             scope = statistics->allocate(frameInfo.currentFrame, getStatisticsScope(pHairModel, "Expand"))]
+                            (const vk::CommandBuffer& commandBuffer) {
+                    statistics->begin(commandBuffer, scope);
+                    expandHairModel(pHairModel, expandPipeline, commandBuffer, expandCached ? glm::mat4(1.0f) : model);
+                    statistics->end(commandBuffer, scope);
+                },
+                .parallel = true,
+            });
+
+            // The expansion is recorded into this frame's graph, later frames draw the cache.
+            if (expandCached)
+            {
+                pHairModel->mRibbonCacheValid = true;
+            }
+        }
+
+        RenderGraphResource debugBuffer;
+        if (performanceMode)
+        {
+            debugBuffer = graph.importBuffer("Hair Debug", mDebugBuffer.get());
+            graph.addPass({
+                .name     = "Hair Debug Clear",
+                .accesses = {
+                    { debugBuffer, RenderGraphUsage::TransferWrite },
+                },
+                .execute  = [this](const vk::CommandBuffer& commandBuffer) {
+                    commandBuffer.fillBuffer(mDebugBuffer->getHandle(), 0, vk::WholeSize, 0);
+                },
+                .parallel = true,
+            });
+
+            drawAccesses.push_back({ debugBuffer, RenderGraphUsage::GraphicsStorageWrite });
+        }
+
+        if (ribbonPath)
+        {
+            drawAccesses.push_back({ graph.importBuffer("Hair Ribbon Vertices", pHairModel->getRibbonVertexBuffer()), RenderGraphUsage::VertexStorageRead });
+            drawAccesses.push_back({ strandDescs, RenderGraphUsage::VertexStorageRead });
+        }
+        else
+        {
+            drawAccesses.push_back({ vertices,    RenderGraphUsage::MeshStorageRead });
+            drawAccesses.push_back({ strandDescs, RenderGraphUsage::MeshStorageRead });
+        }
+
+        // Queries must not span the render pass instance, the scope wraps it.
+        const uint32_t drawScope = statistics->allocate(frameInfo.currentFrame, getStatisticsScope(pHairModel, "Draw"), !ribbonPath);
+
+        graph.addPass({
+            .name     = "Hair Rendering",
+            .accesses = std::move(drawAccesses),
+            .execute  = [=, this, &frameInfo](const vk::CommandBuffer& commandBuffer) {
+                // Recorded into a secondary, dynamic state is not inherited from the frame's command buffer.
+                mRHI->getSwapchain()->setScissorViewport(commandBuffer);
+
+                statistics->begin(commandBuffer, drawScope);
+
+                // Every pass records its own command buffer, descriptor buffers are bound once per pass.
+                Descriptor::bindDescriptorBuffers(commandBuffer, std::array<const Descriptor*, 1> { mDescriptor });
+
+                mRenderPass->execute(commandBuffer, [&](const vk::CommandBuffer& cmd) -> void {
+                    drawPipeline->bind(cmd);
+                    drawPipeline->bindDescriptor(cmd, mDescriptor, frameInfo.currentFrame);
+
+                    const auto [addrVertex, addrStrandDesc] = pHairModel->getBufferAddresses();
+
+                    if (debugMode)
+                    {
+                        const auto [width, height] = mRHI->getSwapchain()->getExtent();
+                        const DebugPushConstant debugPushConstant = {
+                            .model                = model,
+                            .strandCount          = pHairModel->getStrandCount(),
+                            .viewportWidth        = static_cast<int32_t>(width),
+                            .viewportHeight       = static_cast<int32_t>(height),
+                            .visibleClusterBuffer = culling ? pHairModel->mVisibleClusterBuffer->getAddress() : 0,
+                            .vertexBuffer         = addrVertex,
+                            .strandDescBuffer     = addrStrandDesc,
+                            .debugBuffer          = performanceMode ? mDebugBuffer->getAddress() : 0,
+                        };
+
+                        drawPipeline->pushConstants<DebugPushConstant>(cmd, PushConstant::sShaderStages, 0, &debugPushConstant);
+                        if (culling)
+                        {
+                            pHairModel->renderCulled(cmd);
+                        }
+                        else
+                        {
+                            pHairModel->render(cmd);
+                        }
+                        return;
+                    }
+
+                    const PushConstant pushConstant = {
+                        .model                = (renderPath == HairRenderPath::ComputeExpansion) ? glm::mat4(1.0f) : model,
+                        .hairDiffuse          = pHairModel->mDiffuse,
+                        .hairSpecular         = pHairModel->mSpecular,
+                        .strandCount          = pHairModel->getStrandCount(),
+                        .visibleClusterBuffer = culling ? pHairModel->mVisibleClusterBuffer->getAddress() : 0,
+                        .vertexBuffer         = ribbonPath ? pHairModel->getRibbonVertexBuffer()->getAddress() : addrVertex,
+                        .strandDescBuffer     = addrStrandDesc,
+                    };
+
+                    if (ribbonPath)
+                    {
+                        drawPipeline->pushConstants<PushConstant>(cmd, PushConstant::sRibbonShaderStages, 0, &pushConstant);
+                        pHairModel->renderRibbons(cmd);
+                    }
+                    else
+                    {
+                        drawPipeline->pushConstants<PushConstant>(cmd, PushConstant::sShaderStages, 0, &pushConstant);
+                        if (culling)
+                        {
+                            pHairModel->renderCulled(cmd);
+                        }
+                        else
+                        {
+                            pHairModel->render(cmd);
+                        }
+                    }
+                });
+
+                statistics->end(commandBuffer, drawScope);
             },
+            .parallel = true,
         });
 
-        mRenderPass->execute(pCommandList->handle(), [&](const vk::CommandBuffer& commandBuffer) -> void {
-            mPipeline->bind(commandBuffer);
-            mPipeline->bindDescriptorSet(commandBuffer, mDescriptor->getSet(frameInfo.currentFrame));
-
-            const auto [addrVertex, addrStrandDesc] = pHairModel->getBufferAddresses();
-            const PushConstant pushConstant = {
-                .model            = pHairModel->mTransform.model(),
-                .hairDiffuse      = pHairModel->mDiffuse,
-                .hairSpecular     = pHairModel->mSpecular,
-                .vertexCount      = pHairModel->getVertexCount(),
-                .strandCount      = pHairModel->getStrandCount(),
-                .renderMode       = static_cast<int32_t>(pHairModel->mRenderingMode),
-                ._pad0            = -1,
-                .vertexBuffer     = addrVertex,
-                .strandDescBuffer = addrStrandDesc,
-            };
-            mPipeline->pushConstants<PushConstant>(commandBuffer, PushConstant::sShaderStages, 0, &pushConstant);
+        if (performanceMode)
+        {
+            addDebugResolvePasses(pHairModel, colorTarget, debugBuffer, frameInfo);
+        }
+    }
 
-            pHairModel->render(commandBuffer);
+    void HairPipeline::addDebugResolvePasses(
+        const HairModel*          pHairModel,
+        const RenderGraphResource colorTarget,
+        const RenderGraphResource debugBuffer,
+        const Frame&              frameInfo) const
+    {
+        RenderGraph& graph = *mRenderGraph;
+
+        // One fragment per pixel turns the counters into the heatmap and the overdraw statistics.
+        if (pHairModel->mRenderingMode == HairRenderingMode::Overdraw)
+        {
+            graph.addPass({
+                .name     = "Hair Overdraw Resolve",
+                .accesses = {
+                    { colorTarget, RenderGraphUsage::ColorAttachment      },
+                    { debugBuffer, RenderGraphUsage::GraphicsStorageWrite },
+                },
+                .execute  = [this](const vk::CommandBuffer& commandBuffer) {
+                    mRHI->getSwapchain()->setScissorViewport(commandBuffer);
+
+                    mOverlayRenderPass->execute(commandBuffer, [&](const vk::CommandBuffer& cmd) -> void {
+                        const auto [width, height] = mRHI->getSwapchain()->getExtent();
+                        const OverdrawPushConstant pushConstant = {
+                            .debugBuffer    = mDebugBuffer->getAddress(),
+                            .viewportWidth  = static_cast<int32_t>(width),
+                            .viewportHeight = static_cast<int32_t>(height),
+                            .maxOverdraw    = 64.0f,
+                            .opacity        = 0.85f,
+                        };
+
+                        mOverdrawPipeline->bind(cmd);
+                        mOverdrawPipeline->pushConstants<OverdrawPushConstant>(cmd, vk::ShaderStageFlagBits::eFragment, 0, &pushConstant);
+                        cmd.draw(3, 1, 0, 0);
+                    });
+                },
+                .parallel = true,
+            });
+        }
+
+        // Read by the host in the next frame that reuses this slot, after its timeline wait.
+        const uint32_t frameIndex = frameInfo.currentFrame;
+        graph.addPass({
+            .name        = "Hair Debug Readback",
+            .accesses    = {
+                { debugBuffer, RenderGraphUsage::TransferRead },
+            },
+            .execute     = [this, frameIndex](const vk::CommandBuffer& commandBuffer) {
+                mDebugBuffer->copy({
+                    .pDstBuffer    = mDebugReadbacks[frameIndex].buffer.get(),
+                    .size          = sizeof(HairDebugStatistics),
+                    .commandBuffer = commandBuffer,
+                });
+
+                const auto hostBarrier = vk::MemoryBarrier2()
+                    .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+                    .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+                    .setDstStageMask(vk::PipelineStageFlagBits2::eHost)
+                    .setDstAccessMask(vk::AccessFlagBits2::eHostRead);
+
+                commandBuffer.pipelineBarrier2(vk::DependencyInfo().setMemoryBarrierCount(1).setPMemoryBarriers(&hostBarrier));
+            },
+            .sideEffects = true,
         });
 
-        pCommandList->handle().endDebugUtilsLabelEXT();
+        mDebugReadbacks[frameIndex].pHairModel = pHairModel;
+    }
+
+    void HairPipeline::expandHairModel(
+        const HairModel*         pHairModel,
+        const Pipeline*          pipeline,
+        const vk::CommandBuffer& commandBuffer,
+        const glm::mat4&         model) const
+    {
+        // Nothing to expand, and no workgroup count to fold the strands into.
+        if (pHairModel->getStrandCount() == 0)
+        {
+            return;
+        }
+
+        const auto [addrVertex, addrStrandDesc] = pHairModel->getBufferAddresses();
+        const ExpandPushConstant pushConstant = {
+            .model            = model,
+            .vertexCount      = pHairModel->getVertexCount(),
+            .strandCount      = pHairModel->getStrandCount(),
+            .vertexBuffer     = addrVertex,
+            .strandDescBuffer = addrStrandDesc,
+            .ribbonBuffer     = pHairModel->getRibbonVertexBuffer()->getAddress(),
+        };
+
+        pipeline->bind(commandBuffer);
+        pipeline->pushConstants<ExpandPushConstant>(commandBuffer, vk::ShaderStageFlagBits::eCompute, 0, &pushConstant);
+
+        // One workgroup per strand, folded into Y to stay within maxComputeWorkGroupCount.
+        constexpr uint32_t maxGroupCountX = 65535;
+        const auto strandCount = static_cast<uint32_t>(pHairModel->getStrandCount());
+        const uint32_t groupCountX = std::min(strandCount, maxGroupCountX);
+        const uint32_t groupCountY = (strandCount + groupCountX - 1) / groupCountX;
+        commandBuffer.dispatch(groupCountX, groupCountY, 1);
+    }
+
+    void HairPipeline::cullHairModel(const HairModel* pHairModel, const vk::CommandBuffer& commandBuffer, const Frame& frameInfo) const
+    {
+        const HairClusterHierarchy& hierarchy = pHairModel->getClusterHierarchy();
+        const auto&                 levelOffsets = hierarchy.getLevelOffsets();
+
+        // Level 0 starts with the root node, every other level is filled by the traversal.
+        HairClusterCullState cullState = {};
+        for (auto& dispatch : cullState.dispatch)
+        {
+            dispatch = vk::DispatchIndirectCommand(0, 1, 1);
+        }
+        cullState.dispatch[0]    = vk::DispatchIndirectCommand(1, 1, 1);
+        cullState.queueCounts[0] = 1;
+        cullState.draw           = vk::DrawMeshTasksIndirectCommandEXT(0, 1, 1);
+
+        constexpr uint32_t rootNode = 0;
+        commandBuffer.updateBuffer(pHairModel->mClusterCullStateBuffer->getHandle(), 0, sizeof(HairClusterCullState), &cullState);
+        commandBuffer.updateBuffer(pHairModel->mClusterQueueBuffer->getHandle(), 0, sizeof(uint32_t), &rootNode);
+
+        const auto initBarrier = vk::MemoryBarrier2()
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect)
+            .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eIndirectCommandRead);
+
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo().setMemoryBarrierCount(1).setPMemoryBarriers(&initBarrier));
+
+        mClusterCullPipeline->bind(commandBuffer);
+        Descriptor::bindDescriptorBuffers(commandBuffer, std::array<const Descriptor*, 1> { mDescriptor });
+        mClusterCullPipeline->bindDescriptor(commandBuffer, mDescriptor, frameInfo.currentFrame);
+
+        // Each level enqueues the children of its visible nodes and sizes the next level's dispatch.
+        const auto levelBarrier = vk::MemoryBarrier2()
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+            .setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect)
+            .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eIndirectCommandRead);
+
+        for (int32_t level = 0; level < hierarchy.getLevelCount(); level++)
+        {
+            const ClusterCullPushConstant pushConstant = {
+                .model                = pHairModel->mTransform.model(),
+                .level                = level,
+                .levelOffset          = levelOffsets[level],
+                .nextLevelOffset      = levelOffsets[level + 1],
+                .minScreenSize        = pHairModel->mMinClusterScreenSize,
+                .viewportHeight       = static_cast<float>(mRHI->getSwapchain()->getExtent().height),
+                .nodeBuffer           = pHairModel->mClusterNodeBuffer->getAddress(),
+                .queueBuffer          = pHairModel->mClusterQueueBuffer->getAddress(),
+                .visibleClusterBuffer = pHairModel->mVisibleClusterBuffer->getAddress(),
+                .cullStateBuffer      = pHairModel->mClusterCullStateBuffer->getAddress(),
+            };
+
+            mClusterCullPipeline->pushConstants<ClusterCullPushConstant>(commandBuffer, vk::ShaderStageFlagBits::eCompute, 0, &pushConstant);
+            commandBuffer.dispatchIndirect(
+                pHairModel->mClusterCullStateBuffer->getHandle(),
+                offsetof(HairClusterCullState, dispatch) + level * sizeof(vk::DispatchIndirectCommand));
+
+            commandBuffer.pipelineBarrier2(vk::DependencyInfo().setMemoryBarrierCount(1).setPMemoryBarriers(&levelBarrier));
+        }
     }
-}
+}
\ No newline at end of file
@@ -1,11 +1,14 @@
 #include "hair/HairUIComponent.hpp"
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <cfloat>
 
 #include <imgui.h>
 #include <fmt/format.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "Barrier.hpp"
 #include "hair/HairModel.hpp"
 
 
@@ -20,11 +23,6 @@ namespace nbl
 
     void HairUIComponent::draw()
     {
-        static std::vector renderingModes = {
-            HairRenderingMode::Normal,       HairRenderingMode::DebugQuads,
-            HairRenderingMode::DebugStrands, HairRenderingMode::DebugStrandlets,
-        };
-
         ImGui::Begin(mComponentName.c_str());
         {
             ImGui::SliderFloat3("Diffuse", glm::value_ptr(mHairModel->mDiffuse), 0.0f, 1.0f);
@@ -37,19 +35,70 @@ namespace nbl
 
             ImGui::Separator();
             
-            ImGui::BeginCombo(
-                "Render Mode",
-                toString(mHairModel->mRenderingMode).c_str());
+            if (ImGui::BeginCombo("Render Mode", toString(mHairModel->mRenderingMode).c_str()))
             {
-                for (const auto mode : renderingModes)
+                for (const auto mode : gHairRenderingModes)
                 {
                     if (ImGui::Selectable(toString(mode).c_str(), mHairModel->mRenderingMode == mode))
                     {
                         mHairModel->mRenderingMode = mode;
                     }
                 }
+                ImGui::EndCombo();
+            }
+
+            drawDebugStatistics();
+
+            ImGui::Separator();
+
+            if (ImGui::BeginCombo("Render Path", toString(mHairModel->mRenderPath).c_str()))
+            {
+                const bool meshShader = mHairModel->mRHI->getDevice()->getCapabilities().meshShader;
+                for (const auto path : gHairRenderPaths)
+                {
+                    // Listed but disabled without VK_EXT_mesh_shader.
+                    const ImGuiSelectableFlags flags = (path == HairRenderPath::MeshShader && !meshShader)
+                        ? ImGuiSelectableFlags_Disabled
+                        : ImGuiSelectableFlags_None;
+
+                    if (ImGui::Selectable(toString(path).c_str(), mHairModel->mRenderPath == path, flags))
+                    {
+                        mHairModel->setRenderPath(path);
+                    }
+                }
+                ImGui::EndCombo();
+            }
+
+            ImGui::Text("Strand Order: %s", toString(mHairModel->getStrandOrder()).c_str());
+
+            uint64_t trackedBytes = mHairModel->mRHI->getDevice()->getMemoryTracker()->getUsageByName(
+                fmt::format("HairModel: {} (", mHairModel->mName));
+            if (!mHairModel->mOwnedGeometryArena)
+            {
+                // Slices of a shared arena are tracked under the arena's name.
+                trackedBytes += mHairModel->mVertexBuffer->getSize() + mHairModel->mStrandDescriptionsBuffer->getSize();
+            }
+            ImGui::Text("GPU Memory: %.2f MiB", static_cast<double>(trackedBytes) / (1024.0 * 1024.0));
+
+            const BarrierStatistics barriers = Barrier::getFrameStatistics();
+            ImGui::Text("Barriers: %u issued / %u requested (%u batches)", barriers.issued, barriers.requested, barriers.batches);
+
+            const FramePacingSummary pacing = mHairModel->mRHI->getFrameProfiler()->getSummary();
+            ImGui::Text("Frame: p50 %.2f / p99 %.2f ms, GPU %.2f ms, Latency %.2f ms",
+                pacing.p50Ms, pacing.p99Ms, pacing.gpuP50Ms, pacing.latencyP50Ms);
+            ImGui::Text("Bound: CPU %u / GPU %u / Present %u of %u frames",
+                pacing.cpuBound, pacing.gpuBound, pacing.presentBound, pacing.frameCount);
+
+            drawPipelineStatistics();
+            drawPipelineCompilation();
+
+            if (mHairModel->mRenderPath == HairRenderPath::MeshShader)
+            {
+                const auto& hierarchy = mHairModel->getClusterHierarchy();
+                ImGui::Checkbox("Cluster Culling", &mHairModel->mEnableClusterCulling);
+                ImGui::SliderFloat("Min Cluster Size (px)", &mHairModel->mMinClusterScreenSize, 0.0f, 16.0f);
+                ImGui::Text("Clusters: %d, BVH Levels: %d", hierarchy.getClusterCount(), hierarchy.getLevelCount());
             }
-            ImGui::EndCombo();
 
             ImGui::Separator();
 
@@ -62,4 +111,125 @@ namespace nbl
         }
         ImGui::End();
     }
+
+    void HairUIComponent::drawDebugStatistics() const
+    {
+        if (!isPerformanceRenderingMode(mHairModel->mRenderingMode))
+        {
+            return;
+        }
+        if (mHairModel->mRenderPath != HairRenderPath::MeshShader)
+        {
+            ImGui::TextDisabled("Rendering modes other than Normal require the Mesh Shader render path.");
+            return;
+        }
+
+        const auto& statistics = mHairModel->getDebugStatistics();
+        if (!statistics.has_value())
+        {
+            return;
+        }
+
+        if (mHairModel->mRenderingMode == HairRenderingMode::Overdraw)
+        {
+            ImGui::Text("Overdraw: avg %.2f, max %u, %u fragments on %u pixels",
+                statistics->getAverageOverdraw(), statistics->maxOverdraw, statistics->fragmentCount, statistics->coveredPixelCount);
+
+            std::array<float, gHAIR_OVERDRAW_BUCKETS> overdraw {};
+            std::ranges::copy(statistics->overdrawHistogram, overdraw.begin());
+            ImGui::PlotHistogram("Pixels by log2(Fragments)", overdraw.data(), static_cast<int32_t>(overdraw.size()),
+                0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+        }
+
+        const float meshGroupsPerTask = statistics->taskGroupCount > 0
+            ? static_cast<float>(statistics->meshGroupCount) / static_cast<float>(statistics->taskGroupCount)
+            : 0.0f;
+
+        ImGui::Text("Lane Utilization: %.1f%% over %u mesh groups", 100.0f * statistics->getLaneUtilization(), statistics->meshGroupCount);
+        ImGui::Text("Mesh Groups / Task Group: avg %.2f, max %u (%u task groups)",
+            meshGroupsPerTask, statistics->maxMeshGroups, statistics->taskGroupCount);
+
+        std::array<float, gHAIR_WORKGROUP_SIZE + 1> lanes {};
+        std::ranges::copy(statistics->laneHistogram, lanes.begin());
+        ImGui::PlotHistogram("Mesh Groups by Active Lanes", lanes.data(), static_cast<int32_t>(lanes.size()),
+            0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+    }
+
+    void HairUIComponent::drawPipelineStatistics() const
+    {
+        const PipelineStatistics* statistics = mHairModel->mRHI->getPipelineStatistics();
+        if (!statistics->isSupported() || !ImGui::TreeNode("Pipeline Statistics"))
+        {
+            return;
+        }
+
+        // One row per render path and pass the model was drawn with, switching paths keeps the previous rows.
+        const std::string prefix = fmt::format("{} | ", mHairModel->mName);
+
+        constexpr auto flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("Pipeline Statistics", 7, flags))
+        {
+            ImGui::TableSetupColumn("Render Path | Pass");
+            ImGui::TableSetupColumn("Task");
+            ImGui::TableSetupColumn("Mesh");
+            ImGui::TableSetupColumn("Mesh Prims");
+            ImGui::TableSetupColumn("Clip In / Out");
+            ImGui::TableSetupColumn("Fragments");
+            ImGui::TableSetupColumn("VS / CS");
+            ImGui::TableHeadersRow();
+
+            for (const auto& [name, result] : statistics->getResults())
+            {
+                if (!name.starts_with(prefix)) continue;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(name.substr(prefix.size()).c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(result.taskShaderInvocations));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(result.meshShaderInvocations));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(result.meshPrimitivesGenerated));
+                ImGui::TableNextColumn(); ImGui::Text("%llu / %llu",
+                    static_cast<unsigned long long>(result.clippingInvocations),
+                    static_cast<unsigned long long>(result.clippingPrimitives));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(result.fragmentShaderInvocations));
+                ImGui::TableNextColumn(); ImGui::Text("%llu / %llu",
+                    static_cast<unsigned long long>(result.vertexShaderInvocations),
+                    static_cast<unsigned long long>(result.computeShaderInvocations));
+            }
+
+            ImGui::EndTable();
+        }
+
+        ImGui::TreePop();
+    }
+
+    void HairUIComponent::drawPipelineCompilation() const
+    {
+        const PipelineCompiler* compiler = mHairModel->mRHI->getPipelineCompiler();
+        const auto              results  = compiler->getResults();
+        if (!ImGui::TreeNode("Pipeline Compilation", "Pipeline Compilation (%zu compiled, %u pending)", results.size(), compiler->getPendingCount()))
+        {
+            return;
+        }
+
+        constexpr auto flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("Pipeline Compilation", 3, flags))
+        {
+            ImGui::TableSetupColumn("Pipeline");
+            ImGui::TableSetupColumn("Compile (ms)");
+            ImGui::TableSetupColumn("Queued (ms)");
+            ImGui::TableHeadersRow();
+
+            for (const PipelineCompileResult& result : results)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%s%s", result.debugName.c_str(), result.failed ? " (Failed)" : "");
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", result.compileTime);
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", result.queueTime);
+            }
+
+            ImGui::EndTable();
+        }
+
+        ImGui::TreePop();
+    }
 }
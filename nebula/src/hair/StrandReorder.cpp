@@ -0,0 +1,107 @@
+#include "hair/StrandReorder.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+namespace nbl
+{
+    std::string toString(const StrandOrder strandOrder)
+    {
+        using enum StrandOrder;
+
+        switch (strandOrder)
+        {
+        case Source:                return "Source";
+        case Morton:                return "Morton";
+        case LengthBucketed:        return "Length (Bucketed)";
+        case MortonLengthBucketed:  return "Morton + Length (Bucketed)";
+        }
+
+        throw std::invalid_argument("Unknown StrandOrder");
+    }
+
+    uint32_t mortonEncode3D(const glm::uvec3 cell)
+    {
+        const auto spread = [](uint32_t x) -> uint32_t {
+            x &= 0x000003ff;
+            x = (x | (x << 16)) & 0x030000ff;
+            x = (x | (x <<  8)) & 0x0300f00f;
+            x = (x | (x <<  4)) & 0x030c30c3;
+            x = (x | (x <<  2)) & 0x09249249;
+            return x;
+        };
+        return spread(cell.x) | (spread(cell.y) << 1) | (spread(cell.z) << 2);
+    }
+
+    std::vector<int32_t> computeStrandOrder(const StrandReorderInfo& reorderInfo)
+    {
+        const auto& roots = reorderInfo.rootPositions;
+        const auto& counts = reorderInfo.pointCounts;
+
+        if (roots.size() != counts.size())
+        {
+            throw std::invalid_argument("StrandReorderInfo: rootPositions and pointCounts size mismatch");
+        }
+
+        std::vector<int32_t> permutation(roots.size());
+        std::iota(std::begin(permutation), std::end(permutation), 0);
+
+        if (reorderInfo.policy == StrandOrder::Source || roots.empty())
+        {
+            return permutation;
+        }
+
+        // Quantize roots to a 10-bit grid over their bounding box.
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(std::numeric_limits<float>::lowest());
+        for (const auto& root : roots)
+        {
+            min = glm::min(min, root);
+            max = glm::max(max, root);
+        }
+
+        constexpr float gridSize = 1023.0f;
+        const glm::vec3 extent = glm::max(max - min, glm::vec3(std::numeric_limits<float>::epsilon()));
+
+        std::vector<uint32_t> mortonCodes(roots.size());
+        std::ranges::transform(roots, std::begin(mortonCodes), [&](const glm::vec3& root) {
+            const glm::uvec3 cell = glm::uvec3(glm::clamp((root - min) / extent, 0.0f, 1.0f) * gridSize);
+            return mortonEncode3D(cell);
+        });
+
+        // Dropping the lower bits per axis of a Morton code yields the code of the coarse cell.
+        const uint32_t bucketShift = 3 * (10 - std::min(reorderInfo.bucketBits, 10u));
+        const auto bucketOf = [&](const int32_t i) { return mortonCodes[i] >> bucketShift; };
+
+        // Ties are broken by source index to keep the result deterministic.
+        switch (reorderInfo.policy)
+        {
+            case StrandOrder::Morton: {
+                std::ranges::sort(permutation, [&](const int32_t a, const int32_t b) {
+                    return std::tie(mortonCodes[a], a) < std::tie(mortonCodes[b], b);
+                });
+                break;
+            }
+            case StrandOrder::LengthBucketed: {
+                std::ranges::sort(permutation, [&](const int32_t a, const int32_t b) {
+                    return std::tuple(bucketOf(a), -counts[a], a) < std::tuple(bucketOf(b), -counts[b], b);
+                });
+                break;
+            }
+            case StrandOrder::MortonLengthBucketed: {
+                std::ranges::sort(permutation, [&](const int32_t a, const int32_t b) {
+                    return std::tuple(bucketOf(a), -counts[a], mortonCodes[a], a)
+                         < std::tuple(bucketOf(b), -counts[b], mortonCodes[b], b);
+                });
+                break;
+            }
+            default:
+                break;
+        }
+
+        return permutation;
+    }
+}
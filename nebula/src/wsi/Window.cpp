@@ -28,7 +28,7 @@ namespace nbl::wsi
         }
 
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-        glfwWindowHint(GLFW_RESIZABLE, false);
+        glfwWindowHint(GLFW_RESIZABLE, createInfo.resizable);
 
         mWidth  = createInfo.width;
         mHeight = createInfo.height;
@@ -63,7 +63,9 @@ namespace nbl::wsi
             throw std::runtime_error("Failed to create Window");
         }
 
+        glfwSetWindowUserPointer(mWindow, this);
         glfwSetKeyCallback(mWindow, Window::defaultKeyHandler);
+        glfwSetFramebufferSizeCallback(mWindow, Window::framebufferSizeHandler);
 
         int32_t framebufferWidth;
         int32_t framebufferHeight;
@@ -125,4 +127,14 @@ namespace nbl::wsi
             glfwSetWindowShouldClose(window, true);
         }
     }
+
+    void Window::framebufferSizeHandler(GLFWwindow* window, const int width, const int height)
+    {
+        // Picked up by VulkanRHI::beginFrame, which recreates the Swapchain on a size mismatch.
+        auto* pWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+        pWindow->mFramebufferSize = {
+            .width  = static_cast<uint32_t>(width),
+            .height = static_cast<uint32_t>(height),
+        };
+    }
 }
\ No newline at end of file
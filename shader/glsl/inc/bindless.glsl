@@ -0,0 +1,25 @@
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Bindings match nbl::BindlessResourceType, see nbl-vulkan BindlessTable.
+#ifndef BINDLESS_SET
+    #define BINDLESS_SET 1
+#endif
+
+layout (set = BINDLESS_SET, binding = 1) uniform sampler2D bindless_textures[];
+
+// Storage buffers are declared per element type:
+// BINDLESS_STORAGE_BUFFER(Vertices, HairVertex vertices[]);
+// ... bindless_Vertices[nonuniformEXT(index)].vertices[i]
+#define BINDLESS_STORAGE_BUFFER(NAME, MEMBERS) \
+    layout (set = BINDLESS_SET, binding = 0, scalar) buffer NAME##_block { MEMBERS; } bindless_##NAME[]
+
+// Storage images are declared per format, the qualifier has to match the registered Image
+// (requires DeviceCapabilities::bindlessStorageImages):
+// BINDLESS_STORAGE_IMAGE(Counters, r32ui, uimage2D);
+// ... imageAtomicAdd(bindless_Counters[nonuniformEXT(index)], pixel, 1)
+#define BINDLESS_STORAGE_IMAGE(NAME, FORMAT, TYPE) \
+    layout (set = BINDLESS_SET, binding = 2, FORMAT) uniform TYPE bindless_##NAME[]
+
+vec4 bindlessTexture(uint index, vec2 uv) {
+    return texture(bindless_textures[nonuniformEXT(index)], uv);
+}
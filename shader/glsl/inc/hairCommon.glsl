@@ -4,12 +4,26 @@
     #define WORKGROUP_SIZE 32
 #endif
 
+// Specialization constants, see nbl::HairSpecialization
+layout (constant_id = 0) const int  RENDERING_MODE  = 0;        // nbl::HairRenderingMode
+layout (constant_id = 1) const bool CLUSTER_CULLING = false;    // Task workgroups read their cluster from the visible cluster list
+
+// Overdraw, LaneUtilization and MeshGroups collect HairDebugStatistics
+const bool PERFORMANCE_MODE = RENDERING_MODE >= 4;
+
 // Task Shader Payload
 struct Task {
     uint    baseID;
     uint8_t deltaID[WORKGROUP_SIZE - 1];
 };
 
+// Task Shader Payload [Debug pipeline]
+struct TaskDebug {
+    uint    baseID;
+    uint    meshGroupCount;     // Mesh workgroups emitted by the task workgroup
+    uint8_t deltaID[WORKGROUP_SIZE - 1];
+};
+
 // Mesh Shader Payload
 struct MeshData {
     vec4 world_position;
@@ -27,6 +41,12 @@ struct HairVertex {
     vec4 position;
 };
 
+// Expanded Hair ribbon vertex [ComputeExpansion render path]
+struct RibbonVertex {
+    vec4 position;
+    vec4 tangent;
+};
+
 struct StrandDescription {
     int strand_id;
     int vertex_count;
@@ -34,6 +54,40 @@ struct StrandDescription {
     int vertex_offset;
 };
 
+// Cluster BVH node, leaves are clusters of WORKGROUP_SIZE strands
+struct ClusterNode {
+    vec4  sphere;       // xyz: Center, w: Radius [Model Space]
+    vec4  cone;         // xyz: Average tangent, w: cos(Spread angle)
+    float lod_metric;
+    int   first_child;  // Node index of the first child, Cluster ID for leaves
+    int   child_count;  // 0 for leaves
+    int   level;
+};
+
+#define OVERDRAW_BUCKETS 8
+
+// Header of the hair debug buffer, see nbl::HairDebugStatistics
+struct HairDebugStatistics {
+    uint fragment_count;
+    uint covered_pixel_count;
+    uint max_overdraw;
+    uint task_group_count;
+    uint mesh_group_count;
+    uint max_mesh_groups;
+    uint active_lane_count;
+    uint _pad0;
+    uint lane_histogram[WORKGROUP_SIZE + 1];
+    uint overdraw_histogram[OVERDRAW_BUCKETS];
+};
+
+// Blue -> Cyan -> Green -> Yellow -> Red for t in [0, 1]
+vec3 heatmap(float t) {
+    const vec3 ramp[5] = { vec3(0, 0, 1), vec3(0, 1, 1), vec3(0, 1, 0), vec3(1, 1, 0), vec3(1, 0, 0) };
+    float x = clamp(t, 0.0, 1.0) * 4.0;
+    int   i = min(int(x), 3);
+    return mix(ramp[i], ramp[i + 1], x - float(i));
+}
+
 const int COLOR_COUNT = 12;
 const vec3 color_pool[COLOR_COUNT] = {
 vec3(234, 118, 203), vec3(136, 57, 239), vec3(210, 15, 57), vec3(230, 69, 83),
@@ -18,10 +18,9 @@ layout (push_constant) uniform HairConstants {
     mat4     model;
     vec4     hair_diffuse;
     vec4     hair_specular;
-    int      vertexCount;
     int      strandCount;
-    int      renderingMode;
     int      _pad0;
+    uint64_t visible_cluster_address;
     uint64_t vertex_address;
     uint64_t sdesc_address;
 } hair_constants;
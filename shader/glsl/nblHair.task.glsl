@@ -20,10 +20,9 @@ layout (push_constant) uniform HairConstants {
     mat4     model;
     vec4     hair_diffuse;
     vec4     hair_specular;
-    int      vertexCount;
     int      strandCount;
     int      _pad0;
-    int      _pad1;
+    uint64_t visible_cluster_address;
     uint64_t vertex_address;
     uint64_t sdesc_address;
 } hair_constants;
@@ -32,8 +31,11 @@ layout (buffer_reference, scalar) buffer StrandDescriptionriptions {
     StrandDescription descriptions[];
 };
 
+layout (buffer_reference, scalar) buffer VisibleClusters {
+    uint cluster_ids[];
+};
+
 // Input --------------------------------
-uint baseID = gl_WorkGroupID.x * WORKGROUP_SIZE;
 uint laneID = gl_LocalInvocationID.x;
 
 // Output -------------------------------
@@ -47,18 +49,27 @@ StrandDescription getStrandDescription(uint id) {
     return sds.descriptions[id];
 }
 
+// One workgroup per cluster of WORKGROUP_SIZE strands, indirected through the culling results when enabled.
+uint getClusterID() {
+    if (!CLUSTER_CULLING) {
+        return gl_WorkGroupID.x;
+    }
+    VisibleClusters visible_clusters = VisibleClusters(hair_constants.visible_cluster_address);
+    return visible_clusters.cluster_ids[gl_WorkGroupID.x];
+}
+
 void main()
 {
+    uint baseID     = getClusterID() * WORKGROUP_SIZE;
     uint l_strandID = laneID;                       // Relative to Workgroup (Local) Strand ID
     uint g_strandID = baseID + l_strandID;          // Global Strand ID
 
-    if (g_strandID >= getStrandCount()) {
-        return;
-    }
-
-    StrandDescription strand_description = getStrandDescription(g_strandID);
-    int        strandlet_count    = strand_description.strandlet_count;
-    uint       strand_wg_offset   = subgroupExclusiveAdd(strandlet_count);
+    // Lanes past the last strand of a partial cluster stay active without strandlets:
+    // the subgroup operations and EmitMeshTasksEXT below need every lane in uniform control flow.
+    // Their offsets equal the cluster total, so the mesh shader lookup never selects them.
+    bool valid            = g_strandID < getStrandCount();
+    int  strandlet_count  = valid ? getStrandDescription(g_strandID).strandlet_count : 0;
+    uint strand_wg_offset = subgroupExclusiveAdd(strandlet_count);
 
     if (laneID != 0) {
         OUT.deltaID[laneID] = uint8_t(strand_wg_offset);
@@ -0,0 +1,133 @@
+#version 460
+#extension GL_EXT_buffer_reference2 : require
+#extension GL_EXT_scalar_block_layout : enable
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+
+#extension GL_GOOGLE_include_directive : enable
+#include "inc/hairCommon.glsl"
+
+#define CULL_WORKGROUP_SIZE 64
+#define MAX_LEVELS 16
+
+layout (local_size_x = CULL_WORKGROUP_SIZE) in;
+
+layout (push_constant) uniform CullConstants {
+    mat4     model;
+    int      level;
+    int      level_offset;
+    int      next_level_offset;
+    float    min_screen_size;
+    float    viewport_height;
+    int      _pad0;
+    uint64_t node_address;
+    uint64_t queue_address;
+    uint64_t visible_cluster_address;
+    uint64_t cull_state_address;
+} cull_constants;
+
+layout (set = 0, binding = 0) uniform CameraData {
+    mat4  view;
+    mat4  proj;
+    mat4  view_inverse;
+    mat4  proj_inverse;
+    vec4  eye;
+    float near_plane;
+    float far_plane;
+} camera;
+
+layout (buffer_reference, scalar) buffer ClusterNodes { ClusterNode nodes[]; };
+
+layout (buffer_reference, scalar) buffer NodeQueues { uint node_ids[]; };
+
+layout (buffer_reference, scalar) buffer VisibleClusters { uint cluster_ids[]; };
+
+layout (buffer_reference, scalar) buffer CullState {
+    uvec3 dispatch[MAX_LEVELS];
+    uint  queue_counts[MAX_LEVELS];
+    uvec3 draw;
+};
+
+// Functions ----------------------------
+bool isSphereVisible(vec3 center, float radius) {
+    // Gribb-Hartmann frustum planes, depth range [0, 1]
+    mat4 VP = transpose(camera.proj * camera.view);
+    vec4 planes[5] = {
+        VP[3] + VP[0], VP[3] - VP[0],
+        VP[3] + VP[1], VP[3] - VP[1],
+        VP[3] - VP[2],
+    };
+
+    for (int i = 0; i < 5; i++) {
+        if (dot(planes[i].xyz, center) + planes[i].w < -radius * length(planes[i].xyz)) {
+            return false;
+        }
+    }
+
+    // Near plane
+    if (dot(VP[2].xyz, center) + VP[2].w < -radius * length(VP[2].xyz)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool isNodeVisible(ClusterNode node) {
+    const mat4 M = cull_constants.model;
+
+    vec3  center = (M * vec4(node.sphere.xyz, 1.0)).xyz;
+    float scale  = max(length(M[0].xyz), max(length(M[1].xyz), length(M[2].xyz)));
+    float radius = node.sphere.w * scale;
+
+    if (!isSphereVisible(center, radius)) {
+        return false;
+    }
+
+    // Level of detail test, the lod metric (coarsest segment length below the node) projected to pixels
+    // at the closest point of the bounds: when it is below the threshold, so is every node of the subtree.
+    float distance = length(camera.eye.xyz - center) - radius;
+    if (cull_constants.min_screen_size > 0.0 && distance > camera.near_plane) {
+        float segment_size = (node.lod_metric * scale * abs(camera.proj[1][1]) * 0.5 * cull_constants.viewport_height) / distance;
+        if (segment_size < cull_constants.min_screen_size) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void main()
+{
+    CullState       state    = CullState(cull_constants.cull_state_address);
+    NodeQueues      queues   = NodeQueues(cull_constants.queue_address);
+    ClusterNodes    nodes    = ClusterNodes(cull_constants.node_address);
+
+    uint queueIndex = gl_GlobalInvocationID.x;
+    if (queueIndex >= state.queue_counts[cull_constants.level]) {
+        return;
+    }
+
+    uint        nodeID = queues.node_ids[cull_constants.level_offset + queueIndex];
+    ClusterNode node   = nodes.nodes[nodeID];
+
+    if (!isNodeVisible(node)) {
+        return;
+    }
+
+    // Leaf: emit the cluster as one task workgroup.
+    if (node.child_count == 0) {
+        VisibleClusters visible_clusters = VisibleClusters(cull_constants.visible_cluster_address);
+        uint slot = atomicAdd(state.draw.x, 1);
+        visible_clusters.cluster_ids[slot] = uint(node.first_child);
+        return;
+    }
+
+    // Internal node: enqueue children for the next level and grow its indirect dispatch.
+    uint next_level = cull_constants.level + 1;
+    uint base       = atomicAdd(state.queue_counts[next_level], uint(node.child_count));
+    for (int i = 0; i < node.child_count; i++) {
+        queues.node_ids[cull_constants.next_level_offset + base + i] = uint(node.first_child + i);
+    }
+
+    uint group_count = (base + uint(node.child_count) + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE;
+    atomicMax(state.dispatch[next_level].x, group_count);
+}
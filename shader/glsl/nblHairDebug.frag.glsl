@@ -1,5 +1,7 @@
 #version 460
 
+#extension GL_EXT_buffer_reference2 : require
+#extension GL_EXT_scalar_block_layout : enable
 #extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
 
 #extension GL_GOOGLE_include_directive : enable
@@ -7,9 +9,34 @@
 
 layout (location = 0) in MeshDataDebug IN;
 
+layout (push_constant) uniform HairDebugConstants {
+    mat4     model;
+    int      strandCount;
+    int      _pad0;
+    int      viewportWidth;
+    int      viewportHeight;
+    uint64_t visible_cluster_address;
+    uint64_t vertex_address;
+    uint64_t sdesc_address;
+    uint64_t debug_address;
+} hair_constants;
+
+layout (buffer_reference, scalar) buffer HairDebugBuffer {
+    HairDebugStatistics statistics;
+    uint                fragment_counts[];
+};
+
 layout (location = 0) out vec4 out_color;
 
 void main()
 {
+    // Overdraw: every shaded fragment counts, storage writes disable early depth tests.
+    // Totals are summed by the resolve pass instead of contending on one counter here.
+    if (RENDERING_MODE == 4 && hair_constants.debug_address != 0) {
+        HairDebugBuffer debug_buffer = HairDebugBuffer(hair_constants.debug_address);
+        ivec2 pixel = ivec2(gl_FragCoord.xy);
+        atomicAdd(debug_buffer.fragment_counts[pixel.y * hair_constants.viewportWidth + pixel.x], 1);
+    }
+
     out_color = IN.color;
 }
@@ -14,22 +14,24 @@
 layout (local_size_x = WORKGROUP_SIZE) in;
 layout (triangles, max_vertices = 128, max_primitives = 64) out;
 
-layout (push_constant) uniform HairConstants {
+layout (push_constant) uniform HairDebugConstants {
     mat4     model;
-    vec4     hair_diffuse;
-    vec4     hair_specular;
-    int      vertexCount;
     int      strandCount;
-    int      renderingMode;
     int      _pad0;
+    int      viewportWidth;
+    int      viewportHeight;
+    uint64_t visible_cluster_address;
     uint64_t vertex_address;
     uint64_t sdesc_address;
+    uint64_t debug_address;
 } hair_constants;
 
 layout (buffer_reference, scalar) buffer Vertices { HairVertex vertices[]; };
 
 layout (buffer_reference, scalar) buffer StrandDescriptions { StrandDescription descriptions[]; };
 
+layout (buffer_reference, scalar) buffer HairDebugBuffer { HairDebugStatistics statistics; };
+
 layout (set = 0, binding = 0) uniform CameraData {
     mat4  view;
     mat4  proj;
@@ -41,7 +43,7 @@ layout (set = 0, binding = 0) uniform CameraData {
 } camera;
 
 // Input --------------------------------
-taskPayloadSharedEXT Task IN;
+taskPayloadSharedEXT TaskDebug IN;
 
 uint workGroupID = gl_WorkGroupID.x;
 uint laneID      = gl_LocalInvocationID.x;
@@ -100,6 +102,14 @@ void main()
     uint n_tri   = n_quads * 2;
     uint n_vtx   = n_quads * 4;
 
+    // Lanes with a quad to emit, the rest of the workgroup idles
+    uint active_lanes = min(n_quads, WORKGROUP_SIZE);
+    if (PERFORMANCE_MODE && laneID == 0 && hair_constants.debug_address != 0) {
+        HairDebugBuffer debug_buffer = HairDebugBuffer(hair_constants.debug_address);
+        atomicAdd(debug_buffer.statistics.active_lane_count, active_lanes);
+        atomicAdd(debug_buffer.statistics.lane_histogram[active_lanes], 1);
+    }
+
     // Do no work if current lane exceeds quad count
     if (laneID > n_quads) return;
 
@@ -119,16 +129,26 @@ void main()
     const uint vtx_out_offset = laneID * 4;
     const uint tri_out_offset = laneID * 2;
 
+    // RENDERING_MODE is a specialization constant, only the branch of the variant survives.
     vec4 color = getColor(strandletID + current_strandID + laneID);
-    if (hair_constants.renderingMode == 1) {
+    if (RENDERING_MODE == 1) {
         color = getColor(strandletID + current_strandID + laneID);
     }
-    if (hair_constants.renderingMode == 2) {
+    if (RENDERING_MODE == 2) {
         color = getColor(current_strandID);
     }
-    if (hair_constants.renderingMode == 3) {
+    if (RENDERING_MODE == 3) {
         color = getColor(strandletID);
     }
+    if (RENDERING_MODE == 4) {
+        color = vec4(0.25, 0.25, 0.25, 1.0);     // Overdraw: Neutral base, the resolve pass draws the heatmap
+    }
+    if (RENDERING_MODE == 5) {
+        color = vec4(heatmap(1.0 - float(active_lanes) / float(WORKGROUP_SIZE)), 1.0);
+    }
+    if (RENDERING_MODE == 6) {
+        color = vec4(heatmap(float(IN.meshGroupCount) / float(2 * WORKGROUP_SIZE)), 1.0);
+    }
 
     for (uint i = 0; i < 4; i++) {
         vec4 world_position = hair_constants.model * quad[i].position;
@@ -0,0 +1,93 @@
+#version 460
+
+#extension GL_EXT_mesh_shader : require
+#extension GL_EXT_buffer_reference2 : require
+#extension GL_KHR_shader_subgroup_ballot : require
+#extension GL_EXT_scalar_block_layout : enable
+#extension GL_KHR_shader_subgroup_arithmetic : enable
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+
+#ifdef DEBUG
+    #extension GL_EXT_debug_printf : enable
+#endif
+
+#extension GL_GOOGLE_include_directive : enable
+#include "inc/hairCommon.glsl"
+
+layout (local_size_x = WORKGROUP_SIZE) in;
+
+layout (push_constant) uniform HairDebugConstants {
+    mat4     model;
+    int      strandCount;
+    int      _pad0;
+    int      viewportWidth;
+    int      viewportHeight;
+    uint64_t visible_cluster_address;
+    uint64_t vertex_address;
+    uint64_t sdesc_address;
+    uint64_t debug_address;
+} hair_constants;
+
+layout (buffer_reference, scalar) buffer StrandDescriptions {
+    StrandDescription descriptions[];
+};
+
+layout (buffer_reference, scalar) buffer VisibleClusters {
+    uint cluster_ids[];
+};
+
+layout (buffer_reference, scalar) buffer HairDebugBuffer {
+    HairDebugStatistics statistics;
+};
+
+// Input --------------------------------
+uint laneID = gl_LocalInvocationID.x;
+
+// Output -------------------------------
+taskPayloadSharedEXT TaskDebug OUT;
+
+// Functions ----------------------------
+int getStrandCount() { return hair_constants.strandCount; }
+
+StrandDescription getStrandDescription(uint id) {
+    StrandDescriptions sds = StrandDescriptions(hair_constants.sdesc_address);
+    return sds.descriptions[id];
+}
+
+uint getClusterID() {
+    if (!CLUSTER_CULLING) {
+        return gl_WorkGroupID.x;
+    }
+    VisibleClusters visible_clusters = VisibleClusters(hair_constants.visible_cluster_address);
+    return visible_clusters.cluster_ids[gl_WorkGroupID.x];
+}
+
+// Same work distribution as nblHair.task, the emitted mesh workgroups are also recorded in the debug statistics.
+void main()
+{
+    uint baseID     = getClusterID() * WORKGROUP_SIZE;
+    uint l_strandID = laneID;
+    uint g_strandID = baseID + l_strandID;
+
+    // Lanes past the last strand stay active without strandlets, see nblHair.task.
+    bool valid            = g_strandID < getStrandCount();
+    int  strandlet_count  = valid ? getStrandDescription(g_strandID).strandlet_count : 0;
+    uint strand_wg_offset = subgroupExclusiveAdd(strandlet_count);
+
+    if (laneID != 0) {
+        OUT.deltaID[laneID] = uint8_t(strand_wg_offset);
+    }
+    OUT.baseID = baseID;
+
+    uint sum_strandlet_count = subgroupBroadcast(strand_wg_offset + strandlet_count, 31);
+    OUT.meshGroupCount = sum_strandlet_count;
+
+    if (PERFORMANCE_MODE && laneID == 0 && hair_constants.debug_address != 0) {
+        HairDebugBuffer debug_buffer = HairDebugBuffer(hair_constants.debug_address);
+        atomicAdd(debug_buffer.statistics.task_group_count, 1);
+        atomicAdd(debug_buffer.statistics.mesh_group_count, sum_strandlet_count);
+        atomicMax(debug_buffer.statistics.max_mesh_groups, sum_strandlet_count);
+    }
+
+    EmitMeshTasksEXT(sum_strandlet_count, 1, 1);
+}
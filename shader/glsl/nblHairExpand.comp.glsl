@@ -0,0 +1,74 @@
+#version 460
+#extension GL_EXT_buffer_reference2 : require
+#extension GL_EXT_scalar_block_layout : enable
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+
+#extension GL_GOOGLE_include_directive : enable
+#include "inc/hairCommon.glsl"
+
+// Lanes per strand, specialized from the average strand length, see nbl::HairSpecialization
+layout (constant_id = 2) const uint EXPAND_WORKGROUP_SIZE = WORKGROUP_SIZE;
+
+layout (local_size_x_id = 2) in;
+
+layout (push_constant) uniform ExpandConstants {
+    mat4     model;
+    int      vertexCount;
+    int      strandCount;
+    int      _pad0;
+    int      _pad1;
+    uint64_t vertex_address;
+    uint64_t sdesc_address;
+    uint64_t ribbon_address;
+} expand_constants;
+
+layout (buffer_reference, scalar) buffer Vertices { HairVertex vertices[]; };
+
+layout (buffer_reference, scalar) buffer StrandDescriptions { StrandDescription descriptions[]; };
+
+layout (buffer_reference, scalar) buffer RibbonVertices { RibbonVertex vertices[]; };
+
+// Input --------------------------------
+// One workgroup per strand, folded into Y for large strand counts.
+uint strandID = gl_WorkGroupID.x + gl_WorkGroupID.y * gl_NumWorkGroups.x;
+uint laneID   = gl_LocalInvocationID.x;
+
+// Functions ----------------------------
+StrandDescription getStrandDescription(uint id) {
+    StrandDescriptions sds = StrandDescriptions(expand_constants.sdesc_address);
+    return sds.descriptions[id];
+}
+
+void main()
+{
+    if (strandID >= expand_constants.strandCount) {
+        return;
+    }
+
+    StrandDescription strand_description = getStrandDescription(strandID);
+    int               vertex_count       = strand_description.vertex_count;
+    uint              base_vertex_offset = strand_description.vertex_offset;
+
+    Vertices       vertex_buffer = Vertices(expand_constants.vertex_address);
+    RibbonVertices ribbon_buffer = RibbonVertices(expand_constants.ribbon_address);
+
+    const mat4 M = expand_constants.model;
+
+    for (int i = int(laneID); i < vertex_count; i += int(EXPAND_WORKGROUP_SIZE)) {
+        // Tangent of the segment starting at this point, the last point reuses the previous segment.
+        int  segment = clamp(i, 0, max(vertex_count - 2, 0));
+        vec4 segment_start = vertex_buffer.vertices[base_vertex_offset + segment].position;
+        vec4 segment_end   = vertex_buffer.vertices[base_vertex_offset + min(segment + 1, vertex_count - 1)].position;
+
+        // Same ribbon construction as nblHair.mesh: [Strand Point | Offset Point]
+        vec4 strand_vertex = vertex_buffer.vertices[base_vertex_offset + i].position;
+        vec4 offset_vertex = strand_vertex + vec4(0.15, 0.0, 0.0, 0.0);
+
+        vec4 tangent       = vec4(segment_start.xyz - segment_end.xyz, 0.0);
+        vec4 world_tangent = normalize(vec4((M * tangent).xyz, 0.0));
+
+        uint out_offset = (base_vertex_offset + i) * 2;
+        ribbon_buffer.vertices[out_offset + 0] = RibbonVertex(M * strand_vertex, world_tangent);
+        ribbon_buffer.vertices[out_offset + 1] = RibbonVertex(M * offset_vertex, world_tangent);
+    }
+}
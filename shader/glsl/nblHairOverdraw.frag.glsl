@@ -0,0 +1,43 @@
+#version 460
+
+#extension GL_EXT_buffer_reference2 : require
+#extension GL_EXT_scalar_block_layout : enable
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+
+#extension GL_GOOGLE_include_directive : enable
+#include "inc/hairCommon.glsl"
+
+layout (push_constant) uniform OverdrawConstants {
+    uint64_t debug_address;
+    int      viewportWidth;
+    int      viewportHeight;
+    float    maxOverdraw;       // Fragment count mapped to the top of the color ramp
+    float    opacity;
+} overdraw_constants;
+
+layout (buffer_reference, scalar) buffer HairDebugBuffer {
+    HairDebugStatistics statistics;
+    uint                fragment_counts[];
+};
+
+layout (location = 0) out vec4 out_color;
+
+// One invocation per pixel: resolves the fragment counts into the heatmap overlay and the overdraw statistics.
+void main()
+{
+    HairDebugBuffer debug_buffer = HairDebugBuffer(overdraw_constants.debug_address);
+
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    uint  count = debug_buffer.fragment_counts[pixel.y * overdraw_constants.viewportWidth + pixel.x];
+    if (count == 0) {
+        discard;
+    }
+
+    atomicAdd(debug_buffer.statistics.fragment_count, count);
+    atomicAdd(debug_buffer.statistics.covered_pixel_count, 1);
+    atomicMax(debug_buffer.statistics.max_overdraw, count);
+    atomicAdd(debug_buffer.statistics.overdraw_histogram[min(findMSB(count), OVERDRAW_BUCKETS - 1)], 1);
+
+    float t = log2(float(count)) / log2(max(overdraw_constants.maxOverdraw, 2.0));
+    out_color = vec4(heatmap(t), overdraw_constants.opacity);
+}
@@ -0,0 +1,49 @@
+#version 460
+#extension GL_EXT_buffer_reference2 : require
+#extension GL_EXT_scalar_block_layout : enable
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+
+#extension GL_GOOGLE_include_directive : enable
+#include "inc/hairCommon.glsl"
+
+layout (push_constant) uniform HairConstants {
+    mat4     model;
+    vec4     hair_diffuse;
+    vec4     hair_specular;
+    int      strandCount;
+    int      _pad0;
+    uint64_t visible_cluster_address;
+    uint64_t vertex_address;    // RibbonVertex[] on the ComputeExpansion render path
+    uint64_t sdesc_address;
+} hair_constants;
+
+layout (buffer_reference, scalar) buffer RibbonVertices { RibbonVertex vertices[]; };
+
+layout (set = 0, binding = 0) uniform CameraData {
+    mat4  view;
+    mat4  proj;
+    mat4  view_inverse;
+    mat4  proj_inverse;
+    vec4  eye;
+    float near_plane;
+    float far_plane;
+} camera;
+
+// Output -------------------------------
+layout (location = 0) out MeshData OUT;
+
+void main()
+{
+    RibbonVertices ribbon_buffer = RibbonVertices(hair_constants.vertex_address);
+    RibbonVertex   ribbon_vertex = ribbon_buffer.vertices[gl_VertexIndex];
+
+    // Identity for per-frame expansion (already world space), model matrix for cached ribbons.
+    const mat4 M = hair_constants.model;
+
+    vec4 world_position = M * ribbon_vertex.position;
+    vec4 world_tangent  = normalize(vec4((M * ribbon_vertex.tangent).xyz, 0.0));
+
+    gl_Position        = camera.proj * camera.view * world_position;
+    OUT.world_position = world_position;
+    OUT.world_tangent  = world_tangent;
+}